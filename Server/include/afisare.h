@@ -21,6 +21,25 @@
 #define AFISARE_H
 
 #include "structuri_date.h"  /* Pentru LogEntry */
+#include "stocare_loguri.h"   /* Pentru FiltruLoguri */
+
+/* Cate loguri incap cel mult pe un ecran */
+#define MAX_RANDURI_ECRAN 20
+
+
+/*
+ * Ultimele loguri filtrate, copiate cat timp lista e blocata. Le afisam
+ * dupa ce am eliberat lacatele: scrisul pe terminal e lent si receptia
+ * nu trebuie sa astepte dupa el.
+ */
+typedef struct {
+    LogEntry randuri[MAX_RANDURI_ECRAN];
+    int indici[MAX_RANDURI_ECRAN];      /* Pozitia fiecaruia in lista (coloana INDEX) */
+    int numar;                          /* Cate randuri am copiat */
+    int numar_filtrate;                 /* Cate loguri trec filtrul */
+    int numar_total;                    /* Cate loguri sunt in total */
+    int numar_pe_nivel[NUMAR_NIVELURI];
+} EcranLoguri;
 
 
 /*
@@ -92,23 +111,52 @@ void actualizeaza_afisare(void);
 
 /*
  * -----------------------------------------------------------------------------
- * FUNCTIE: trece_filtrul
+ * FUNCTIE: gaseste_loguri_filtrate
  * -----------------------------------------------------------------------------
  * CE FACE:
- *     Verifica daca un log trece prin filtrele curente.
+ *     Alege din lista de loguri pe cele care trec prin filtrele curente.
  *     
  *     Un log trece daca:
  *     1. Nivelul lui corespunde filtrului de nivel (sau filtrul e "ALL")
  *     2. Statusul lui corespunde filtrului de status (sau filtrul e "ALL")
  *     3. Contine textul cautat (daca e setat vreun text)
+ *
+ *     Se apeleaza dupa blocheaza_loguri() (vezi filtreaza_loguri).
  * 
  * PARAMETRI:
- *     intrare - log-ul de verificat
+ *     numar_gasite - aici scriem cate loguri au trecut
  * 
  * RETURNEAZA:
- *     1 daca trece filtrele, 0 daca nu
+ *     Indicii lor in lista, pentru obtine_log()
+ */
+const int* gaseste_loguri_filtrate(int* numar_gasite);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: filtrul_curent
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Traduce filtrele alese in meniu (nivel, status, text) intr-un
+ *     FiltruLoguri, pentru filtreaza_loguri sau copiaza_loguri.
+ */
+void filtrul_curent(FiltruLoguri* filtru);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: copiaza_ecranul
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Blocheaza lista, copiaza ultimele 'maxim' loguri care trec filtrele
+ *     (si numaratorile de sub tabel) si o deblocheaza. Randurile se afiseaza
+ *     apoi fara lacate.
+ *
+ * PARAMETRI:
+ *     ecran - unde copiem
+ *     maxim - cate randuri vrem (cel mult MAX_RANDURI_ECRAN)
  */
-int trece_filtrul(const LogEntry* intrare);
+void copiaza_ecranul(EcranLoguri* ecran, int maxim);
 
 
 /* Alias-uri pentru compatibilitate */
@@ -117,7 +165,6 @@ int trece_filtrul(const LogEntry* intrare);
 #define print_header        afiseaza_antet
 #define print_menu          afiseaza_meniu
 #define refresh_display     actualizeaza_afisare
-#define passes_filter       trece_filtrul
 
 
 #endif /* AFISARE_H */
\ No newline at end of file
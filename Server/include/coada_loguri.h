@@ -0,0 +1,134 @@
+/*
+ * =============================================================================
+ * FISIER: coada_loguri.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Coada prin care logurile parsate ajung in lista globala.
+ *
+ * DE CE O COADA?
+ *     Inainte, fiecare thread de I/O bloca g_mutex_loguri pentru FIECARE
+ *     proces parsat. Cu multi clienti, thread-urile stateau mai mult la
+ *     coada la mutex decat lucrau.
+ *
+ *     Acum:
+ *     1. Thread-urile de I/O (producatorii) pun logurile intr-o coada
+ *        FARA lacat (lock-free) - folosesc doar operatii atomice
+ *     2. Un singur thread "scriitor" (consumatorul) scoate logurile in
+ *        loturi si le muta in lista, blocand lacatul o data per lot
+ *
+ *     Fiecare shard (vezi stocare_loguri.h) are coada si scriitorul lui,
+ *     asa ca logurile de la host-uri diferite se scriu in paralel.
+ *
+ * LOTURI:
+ *     Un snapshot aduce sute de procese odata. In loc sa le punem in coada
+ *     pe rand, fiecare thread isi aduna logurile intr-un lot propriu
+ *     (adauga_in_lot) si le trimite toate odata (trimite_lotul): o singura
+ *     rezervare in coada si o singura copiere. La fel pentru mesajele cu
+ *     cate un proces, sosite unul dupa altul in acelasi recv().
+ *
+ * CAND COADA E PLINA:
+ *     Nu asteptam - logul e aruncat si numaram cate am aruncat. Un server
+ *     care nu tine pasul nu trebuie sa blocheze citirea de pe retea.
+ *     Adancimea cozii si numarul de loguri aruncate apar in antet.
+ *
+ * =============================================================================
+ */
+
+#ifndef COADA_LOGURI_H
+#define COADA_LOGURI_H
+
+#include "structuri_date.h"  /* Pentru LogEntry */
+#include <stddef.h>          /* Pentru size_t */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: pune_in_coada_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Copiaza un log in coada. Poate fi apelata simultan din oricate
+ *     thread-uri.
+ *
+ * PARAMETRI:
+ *     intrare - logul de adaugat
+ *
+ * RETURNEAZA:
+ *     1 daca logul a intrat in coada, 0 daca era plina (log aruncat)
+ */
+int pune_in_coada_loguri(const LogEntry* intrare);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: pune_lot_in_coada
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Copiaza mai multe loguri in coada, rezervandu-le locurile dintr-o
+ *     singura operatie atomica. Daca nu incap toate, intra cat se poate.
+ *
+ * PARAMETRI:
+ *     intrari - logurile de adaugat
+ *     numar - cate sunt
+ *
+ * RETURNEAZA:
+ *     Cate loguri au intrat in coada (restul au fost aruncate)
+ */
+int pune_lot_in_coada(const LogEntry* intrari, int numar);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: adauga_in_lot / trimite_lotul
+ * -----------------------------------------------------------------------------
+ * CE FAC:
+ *     adauga_in_lot - pune logul in lotul thread-ului curent (cand lotul
+ *                     se umple, e trimis automat)
+ *     trimite_lotul - pune in coada tot ce s-a adunat in lotul
+ *                     thread-ului curent
+ *
+ *     Apelantul trebuie sa cheme trimite_lotul() cand termina ce avea de
+ *     parsat, altfel logurile stau in lot pana la urmatorul mesaj.
+ */
+void adauga_in_lot(const LogEntry* intrare);
+void trimite_lotul(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: porneste_scriere_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Porneste cate un thread scriitor pentru fiecare shard. Fiecare
+ *     goleste coada shard-ului lui in loturi de cel mult LOT_SCRIERE_LOGURI.
+ *
+ * RETURNEAZA:
+ *     0 la succes, -1 daca nu au pornit toate thread-urile
+ */
+int porneste_scriere_loguri(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: opreste_scriere_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Opreste scriitorii, dupa ce fiecare isi goleste coada, si asteapta
+ *     sa se termine. Se apeleaza dupa ce s-au oprit toti producatorii
+ *     (thread-ul server).
+ */
+void opreste_scriere_loguri(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: statistici coada
+ * -----------------------------------------------------------------------------
+ * adancime_coada_loguri - cate loguri asteapta acum in cozi (toate shard-urile)
+ * loguri_aruncate       - cate loguri am aruncat (coada plina) de la pornire
+ */
+size_t adancime_coada_loguri(void);
+unsigned long loguri_aruncate(void);
+
+
+#endif /* COADA_LOGURI_H */
@@ -0,0 +1,99 @@
+/*
+ * =============================================================================
+ * FISIER: coduri_loguri.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Nivelul (INFO/WARN/ERROR) si statusul (running/sleeping/...) unui log,
+ *     ca numere mici (enum) in loc de text.
+ *
+ * DE CE?
+ *     Clientii le trimit ca text, scris cum vor ei ("running", "Running",
+ *     "RUNNING"). Inainte, filtrul, colorarea si deducerea nivelului faceau
+ *     la fiecare log si la fiecare refresh: copie, litere mari, strcmp cu
+ *     "RUNNING", "CRASHED", "WARN"... Acum textul e tradus O SINGURA DATA,
+ *     la primire, iar restul codului compara si indexeaza cu numarul.
+ *
+ * CUM TRADUCEM:
+ *     Cu un tabel construit la compilare, indexat dupa prima litera: el ne
+ *     spune ce valori pot incepe cu litera respectiva, iar noi comparam
+ *     (fara diferenta intre litere mari si mici) doar cu acelea.
+ *
+ *     Textul original ramane in log (pentru export si pentru valorile pe
+ *     care nu le cunoastem) - codul e doar in plus.
+ *
+ * =============================================================================
+ */
+
+#ifndef CODURI_LOGURI_H
+#define CODURI_LOGURI_H
+
+#include <stddef.h>     /* Pentru size_t */
+
+
+/* Nivelul unui log. NECUNOSCUT = un text pe care nu il recunoastem. */
+typedef enum {
+    NIVEL_NECUNOSCUT = 0,
+    NIVEL_INFO,
+    NIVEL_WARN,
+    NIVEL_ERROR,
+    NUMAR_NIVELURI
+} NivelLog;
+
+/* Statusul unui proces. NECUNOSCUT = un text pe care nu il recunoastem. */
+typedef enum {
+    STATUS_NECUNOSCUT = 0,
+    STATUS_RUNNING,
+    STATUS_SLEEPING,
+    STATUS_STOPPED,
+    STATUS_ZOMBIE,
+    STATUS_CRASHED,
+    STATUS_STATIC,
+    NUMAR_STATUSURI
+} StatusProces;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: cod_nivel / cod_status
+ * -----------------------------------------------------------------------------
+ * CE FAC:
+ *     Traduc textul in cod, fara sa conteze literele mari sau mici
+ *     ("warn", "WARN" -> NIVEL_WARN).
+ *
+ * PARAMETRI:
+ *     text - textul (terminat cu '\0')
+ *
+ * RETURNEAZA:
+ *     Codul, sau NIVEL_NECUNOSCUT / STATUS_NECUNOSCUT
+ */
+NivelLog cod_nivel(const char* text);
+StatusProces cod_status(const char* text);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: nume_nivel / nume_status
+ * -----------------------------------------------------------------------------
+ * CE FAC:
+ *     Numele unui cod, cu litere mari ("INFO", "RUNNING").
+ *
+ * RETURNEAZA:
+ *     Numele, sau "" pentru NECUNOSCUT
+ */
+const char* nume_nivel(NivelLog nivel);
+const char* nume_status(StatusProces status);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: deduce_nivel
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Nivelul unui log care nu si-a trimis nivelul: ERROR pentru un proces
+ *     mort, WARN pentru CPU > 80% sau memorie > 1 GB, altfel INFO.
+ */
+NivelLog deduce_nivel(StatusProces status, double procent_cpu, unsigned long memorie_kb);
+
+
+#endif /* CODURI_LOGURI_H */
@@ -0,0 +1,122 @@
+/*
+ * =============================================================================
+ * FISIER: compresie_flux.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Compresia (optionala) a datelor trimise de un client, negociata la
+ *     HELLO, pe fiecare conexiune in parte.
+ *
+ * DE CE?
+ *     Un client trimite la fiecare cateva secunde aproape aceeasi lista de
+ *     procese. Comprimam tot fluxul conexiunii (nu fiecare mesaj separat):
+ *     compresorul tine minte ultimii 32 KB trimisi, asa ca un snapshot care
+ *     seamana cu cel de dinainte costa doar cativa octeti de "trimiteri
+ *     inapoi". Primele mesaje, cand nu exista inca un istoric, folosesc un
+ *     dictionar comun (cheile JSON, statusurile), stiut de ambele capete.
+ *
+ * CUM MERGE:
+ *     - clientul cere in HELLO:      "compression":"deflate"
+ *     - serverul raspunde la bun venit "compression":"deflate" (sau "none")
+ *     - dupa bun venit, TOT ce trimite clientul e un singur flux zlib, in
+ *       care sunt mesajele incadrate obisnuite ([lungime][mesaj]); clientul
+ *       goleste compresorul (Z_SYNC_FLUSH) dupa fiecare mesaj
+ *     - serverul decomprima inainte sa caute mesajele, deci restul
+ *       serverului nu stie ca a existat compresie
+ *
+ *     Folosim zlib (deflate) - e instalat peste tot si are dictionare.
+ *
+ * STATISTICI:
+ *     Pentru fiecare conexiune numaram octetii comprimati si decomprimati
+ *     si timpul de procesor petrecut decomprimand. Apar in antet, langa
+ *     client: raportul de compresie si costul lui.
+ *
+ * =============================================================================
+ */
+
+#ifndef COMPRESIE_FLUX_H
+#define COMPRESIE_FLUX_H
+
+#include <stddef.h>     /* Pentru size_t */
+
+
+/* Numele algoritmului, asa cum apare in HELLO si in bun venit */
+#define NUME_COMPRESIE "deflate"
+
+/* Fluxul zlib (z_stream) - doar compresie_flux.c are nevoie de interior */
+struct z_stream_s;
+
+
+/*
+ * Cat a castigat si cat a costat compresia pe o conexiune. Scrise de
+ * thread-ul conexiunii, citite de afisare - de aceea cu operatii atomice.
+ */
+typedef struct {
+    unsigned long long octeti_comprimati;    /* Cati octeti au venit pe fir */
+    unsigned long long octeti_decomprimati;  /* Cati au iesit dupa decompresie */
+    unsigned long long ns_procesor;          /* Timp de procesor in decompresie */
+    int activa;                              /* 1 = conexiunea foloseste compresie */
+    int stricata;                            /* 1 = fluxul e corupt, ignoram restul */
+} StatisticiCompresie;
+
+
+/* Ce face apelantul cu datele decomprimate. Dupa date[lungime] exista
+ * mereu un octet liber in care se poate scrie (ca la recv). */
+typedef void (*PrimesteDecomprimate)(void* context, char* date, size_t lungime);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: compresie_ceruta
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Spune daca un mesaj HELLO cere compresie pe care o stim.
+ *
+ * PARAMETRI:
+ *     json - mesajul (terminat cu '\0')
+ *
+ * RETURNEAZA:
+ *     1 daca e HELLO cu "compression":"deflate", 0 altfel
+ */
+int compresie_ceruta(const char* json);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: porneste_decompresia / opreste_decompresia
+ * -----------------------------------------------------------------------------
+ * CE FAC:
+ *     Aloca (si elibereaza) fluxul de decompresie al unei conexiuni.
+ *
+ * RETURNEAZA:
+ *     porneste_decompresia - fluxul, sau NULL daca nu avem memorie
+ */
+struct z_stream_s* porneste_decompresia(void);
+void opreste_decompresia(struct z_stream_s* flux);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: decomprima_flux
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Trece octetii primiti prin decompresor si da rezultatul, bucata cu
+ *     bucata, functiei 'primeste'. Nu aloca nimic: bucatile sunt scrise
+ *     intr-un buffer de pe stiva.
+ *
+ * PARAMETRI:
+ *     flux - fluxul conexiunii
+ *     date / lungime - octetii primiti (comprimati)
+ *     statistici - unde adunam octetii si timpul
+ *     primeste / context - cine primeste datele decomprimate
+ *
+ * RETURNEAZA:
+ *     1 daca a mers, 0 daca fluxul e corupt (statistici->stricata devine 1
+ *     si urmatoarele apeluri nu mai fac nimic)
+ */
+int decomprima_flux(struct z_stream_s* flux, const char* date, size_t lungime,
+                    StatisticiCompresie* statistici,
+                    PrimesteDecomprimate primeste, void* context);
+
+
+#endif /* COMPRESIE_FLUX_H */
@@ -34,8 +34,9 @@
  * Clientii trebuie sa stie acest numar ca sa se conecteze */
 #define SERVER_PORT 8080
 
-/* Cati clienti pot fi conectati in acelasi timp 
- * Daca ai mai multi, restul vor astepta */
+/* Pentru cati clienti conectati facem loc de la inceput in lista de
+ * clienti (si in statisticile lor de compresie). Lista se mareste cand
+ * se conecteaza mai multi. */
 #define MAX_CLIENTI 50
 
 /* Dimensiunea buffer-ului pentru primirea datelor
@@ -43,13 +44,80 @@
  * 16KB ar trebui sa fie suficient pentru orice JSON */
 #define DIMENSIUNE_BUFFER 16384
 
-/* Cate loguri pastram in memorie
+/* Cate loguri pastram in memorie, in FIECARE shard
  * Cand ajungem la limita, le stergem pe cele vechi (FIFO - first in, first out) */
 #define MAX_LOGURI 10000
 
+/* In cate shard-uri impartim logurile (dupa host) - fiecare are lacatul,
+ * coada si thread-ul scriitor propriu (vezi stocare_loguri.h) */
+#define NUMAR_SHARDURI 4
+
+/* Cate loguri copiaza exportul CSV dintr-o data (cu lacatele luate); le
+ * scrie in fisier dupa ce le elibereaza */
+#define LOGURI_PE_BUCATA_EXPORT 1024
+
+/* Cate loguri parsate pot astepta in coada unui shard, intre thread-urile
+ * de I/O si thread-ul care le scrie in lista (putere a lui 2) */
+#define CAPACITATE_COADA_LOGURI 1024
+
+/* Cate loguri muta thread-ul scriitor in lista cu un singur lock */
+#define LOT_SCRIERE_LOGURI 256
+
+/* Cate loguri aduna un thread de I/O (dintr-un snapshot sau din mesajele
+ * primite intr-un singur recv) inainte sa le puna in coada toate odata */
+#define LOT_INGESTIE_LOGURI 128
+
 /* Lungimea maxima a unui camp din JSON (nume proces, user, etc.) */
 #define LUNGIME_CAMP 256
 
+/* In cate benzi (fiecare cu lacatul ei) e impartita tabela de simboluri
+ * in care pastram textele din loguri (vezi tabela_simboluri.h) */
+#define NUMAR_BENZI_SIMBOLURI 16
+
+/* La cate secunde cautam in tabela de simboluri textele pe care nu le mai
+ * foloseste niciun log si niciun host (ex: mesaje unice, suprascrise) */
+#define PERIOADA_RECUPERARE_SIMBOLURI 60
+
+/* Cat de mare poate fi un JSON (si deci bucata pe care o asamblam dintr-un
+ * JSON fragmentat, pe o conexiune). Un JSON mai mare e aruncat intreg si
+ * numarat, nu trunchiat. */
+#define DIMENSIUNE_MAXIMA_MESAJ (DIMENSIUNE_BUFFER * 4)
+
+/* Cati octeti are antetul unui mesaj incadrat (lungimea, big-endian)
+ * Un mesaj incadrat intreg (antet + JSON) trebuie sa incapa in
+ * DIMENSIUNE_MAXIMA_MESAJ */
+#define DIMENSIUNE_ANTET_CADRU 4
+
+/* Cate conexiuni noi pot astepta in coada lui listen()
+ * Cu mii de agenti care se reconecteaza simultan, 50 nu ajunge */
+#define COADA_CONEXIUNI 1024
+
+/* Cate thread-uri de I/O pornesc reactoarele (epoll sau io_uring)
+ * 0 = automat, cate unul pentru fiecare nucleu de procesor */
+#define NUMAR_THREADURI_IO 0
+
+/* Limita superioara pentru thread-urile de I/O (si pentru modul automat) */
+#define MAX_THREADURI_IO 64
+
+/* Cat asteapta reactoarele inainte sa incerce din nou accept() dupa o
+ * eroare persistenta (ex: EMFILE - prea multe fisiere deschise) */
+#define PAUZA_ACCEPT_SECUNDE 1
+
+/* Cate evenimente ridicam dintr-un singur apel epoll_wait() */
+#define MAX_EVENIMENTE_EPOLL 256
+
+/* Cate recv() de DIMENSIUNE_BUFFER face reactorul epoll pe o conexiune
+ * la o trezire; ce ramane e citit dupa restul evenimentelor, ca un client
+ * care trimite fara oprire sa nu le tina pe celelalte pe loc */
+#define CITIRI_MAXIME_PE_TREZIRE 16
+
+/* Cate cereri incap in coada de trimitere a unui inel io_uring */
+#define INTRARI_IO_URING 1024
+
+/* Cate buffere de DIMENSIUNE_BUFFER are inelul de buffere al fiecarui
+ * thread io_uring (trebuie sa fie putere a lui 2) */
+#define NUMAR_BUFFERE_IO_URING 256
+
 
 /* 
  * =============================================================================
@@ -39,7 +39,8 @@
  *     logs_export_2024-01-15_14_30_00.csv
  *     
  *     Coloanele exportate:
- *     Timestamp, PID, Process, User, Status, Level, CPU%, MemoryKB, Message, Hostname, ClientIP
+ *     Timestamp, PID, Process, User, Status, Level, CPU%, MemoryKB, Message, Hostname, ClientIP,
+ *     ReceivedAt (cand a primit serverul logul)
  * 
  * RETURNEAZA:
  *     Nimic (void), dar afiseaza mesaj de succes/eroare pe ecran
@@ -160,6 +160,56 @@ int parseaza_json_proces(const char* json, LogEntry* intrare, const char* ip_cli
 int parseaza_json_snapshot(const char* json, const char* ip_client);
 
 
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: parseaza_mesaj_json
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Parseaza orice mesaj primit de la un client, intr-o SINGURA trecere
+ *     prin JSON: un snapshot (cu lista "processes"), un singur proces sau
+ *     un mesaj de control (HELLO, PING... - ignorat). Logurile rezultate
+ *     ajung in lotul thread-ului (vezi coada_loguri.h); un snapshot e
+ *     trimis in coada imediat, intreg.
+ *
+ *     Spre deosebire de json_extrage_*, se uita doar la cheile obiectului,
+ *     nu si la textul din valori.
+ *
+ * PARAMETRI:
+ *     json - mesajul (terminat cu '\0')
+ *     ip_client - IP-ul clientului
+ *
+ * RETURNEAZA:
+ *     Cate loguri a adaugat
+ */
+int parseaza_mesaj_json(const char* json, const char* ip_client);
+
+
+/* Ce cere un client in mesajul HELLO */
+typedef struct {
+    int schema_binara;          /* "binary_schema" - 0 = lipseste (doar JSON) */
+    const char* compresie;      /* "compression", in JSON (fara '\0'), sau NULL */
+    size_t lungime_compresie;
+} CerereHello;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: parseaza_hello
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Citeste un mesaj HELLO cu acelasi tokenizer ca parseaza_mesaj_json:
+ *     doar cheile obiectului, nu si textul din valori (ex: "client_name").
+ *
+ * PARAMETRI:
+ *     json - mesajul (terminat cu '\0')
+ *     cerere - unde scriem ce a cerut clientul
+ *
+ * RETURNEAZA:
+ *     1 daca e un HELLO, 0 altfel
+ */
+int parseaza_hello(const char* json, CerereHello* cerere);
+
+
 /* Alias-uri pentru compatibilitate cu codul original */
 #define json_get_string     json_extrage_string
 #define json_get_double     json_extrage_double
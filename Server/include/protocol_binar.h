@@ -0,0 +1,125 @@
+/*
+ * =============================================================================
+ * FISIER: protocol_binar.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Un format binar, compact, pentru logurile trimise de clienti - o
+ *     alternativa la JSON, folosita doar daca clientul o cere la HELLO.
+ *
+ * DE CE?
+ *     Un proces in JSON are ~200 de octeti, din care jumatate sunt numele
+ *     cheilor, ghilimele si cifre scrise ca text. Serverul trebuie sa caute
+ *     fiecare cheie si sa transforme textul inapoi in numere. In formatul
+ *     binar numerele stau pe un numar fix de octeti, la pozitii fixe, iar
+ *     textele au lungimea scrisa in fata: decodarea inseamna doar copieri
+ *     de la pozitii cunoscute, fara cautari si fara alocari.
+ *
+ * NEGOCIEREA:
+ *     Clientul spune in HELLO ce schema binara stie:
+ *         {"type":"HELLO","client_name":"PC","version":"1.0","binary_schema":1}
+ *     Serverul raspunde in mesajul de bun venit ce folosim:
+ *         {"connection_status":"connected",...,"protocol":"binary","binary_schema":1}
+ *     sau "protocol":"json" daca nu cunoaste schema (ori clientul nu a cerut
+ *     nimic). Clientii vechi nu trimit "binary_schema" si merg ca inainte.
+ *     Binarul circula doar pe conexiunile cu mesaje incadrate (lungimea pe
+ *     4 octeti in fata); mesajele JSON raman valabile si dupa negociere.
+ *
+ * SCHEMELE:
+ *     1 - snapshot-uri simple
+ *     2 - in plus cadre complete si delte (vezi stare_gazde.h): antetul si
+ *         inregistrarile au steaguri in locul octetilor rezervati
+ *
+ * FORMATUL (schema 2, numerele little-endian):
+ *
+ *     Antet - 16 octeti, apoi hostname-ul:
+ *         [0]  u8   MAGIC_MESAJ_BINAR (0xB1 - un JSON nu incepe asa)
+ *         [1]  u8   schema
+ *         [2]  u16  cate inregistrari urmeaza
+ *         [4]  u16  lungimea hostname-ului
+ *         [6]  u16  steaguri: STEAG_CADRU_COMPLET / STEAG_DELTA (schema 1: 0)
+ *         [8]  i64  timpul snapshot-ului, ns de la 1970 (0 = la primire)
+ *
+ *     Inregistrare - 36 de octeti, apoi numele si user-ul:
+ *         [0]  f64  procent CPU
+ *         [8]  u64  memorie (KB)
+ *         [16] i64  timpul procesului, ns (0 = al snapshot-ului)
+ *         [24] i32  PID
+ *         [28] u8   status (StatusProces, 0 = necunoscut)
+ *         [29] u8   nivel (NivelLog, 0 = il deducem)
+ *         [30] u16  lungimea numelui
+ *         [32] u16  lungimea user-ului
+ *         [34] u16  steaguri: STEAG_ELIMINAT = procesul a disparut (schema 1: 0)
+ *
+ *     Lungimile textelor stau in partea fixa, deci marimea fiecarei
+ *     inregistrari se afla dintr-o singura citire.
+ *
+ *     Intr-o delta, un text gol (lungime 0) sau un cod 0 de status/nivel
+ *     inseamna "neschimbat" - valoarea vine din starea host-ului. O
+ *     inregistrare eliminata are nevoie doar de PID.
+ *
+ * =============================================================================
+ */
+
+#ifndef PROTOCOL_BINAR_H
+#define PROTOCOL_BINAR_H
+
+#include <stddef.h>     /* Pentru size_t */
+
+
+#define MAGIC_MESAJ_BINAR 0xB1
+
+/* Cea mai noua schema pe care o stie serverul */
+#define SCHEMA_BINARA 2
+
+/* Steagurile antetului (schema 2) */
+#define STEAG_CADRU_COMPLET 0x0001u
+#define STEAG_DELTA         0x0002u
+
+/* Steagurile unei inregistrari (schema 2) */
+#define STEAG_ELIMINAT      0x0001u
+
+#define MARIME_ANTET_BINAR 16
+#define MARIME_INREGISTRARE_BINARA 36
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: schema_binara_acceptata
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Citeste un mesaj HELLO si alege schema binara pe care o vom folosi:
+ *     cea mai noua pe care o stim amandoi.
+ *
+ * PARAMETRI:
+ *     json - mesajul (terminat cu '\0')
+ *
+ * RETURNEAZA:
+ *     Schema aleasa, sau 0 = doar JSON (nu e HELLO, nu cere binar, sau
+ *     nu avem o schema comuna)
+ */
+int schema_binara_acceptata(const char* json);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: decodeaza_mesaj_binar
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Decodeaza un mesaj binar si pune logurile in lotul thread-ului (vezi
+ *     coada_loguri.h). Un mesaj cu mai multe inregistrari (un snapshot)
+ *     e trimis in coada imediat, intreg - ca la JSON.
+ *
+ * PARAMETRI:
+ *     date - mesajul, fara antetul de lungime
+ *     lungime - cati octeti are
+ *     ip_client - IP-ul clientului
+ *
+ * RETURNEAZA:
+ *     Cate loguri a adaugat, sau -1 daca mesajul e stricat (magic sau
+ *     schema gresita, trunchiat). Inregistrarile dinaintea greselii raman.
+ */
+int decodeaza_mesaj_binar(const unsigned char* date, size_t lungime, const char* ip_client);
+
+
+#endif /* PROTOCOL_BINAR_H */
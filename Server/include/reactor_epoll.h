@@ -0,0 +1,51 @@
+/*
+ * =============================================================================
+ * FISIER: reactor_epoll.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Reactorul epoll - modul in care serverul deserveste MII de clienti
+ *     cu doar cateva thread-uri.
+ *
+ * DE CE NU UN THREAD PER CLIENT?
+ *     Fiecare thread are propria stiva (8 MB rezervati) si, la noi, inca
+ *     80 KB de buffere pe ea. Cu cateva mii de agenti conectati asta
+ *     inseamna multa memorie si multe schimbari de context, desi aproape
+ *     toti clientii stau degeaba intre doua trimiteri.
+ *
+ * CUM FUNCTIONEAZA:
+ *     1. Pornim cate un thread de I/O pentru fiecare nucleu
+ *     2. Fiecare thread are propriul epoll - o "lista de urmarire" a
+ *        socket-urilor. Kernel-ul ne spune care socket-uri au date noi.
+ *     3. Socket-ul server e urmarit de toate thread-urile; cine e trezit
+ *        accepta conexiunile noi si le preia el
+ *     4. Folosim modul edge-triggered (EPOLLET): suntem anuntati o singura
+ *        data cand vin date, asa ca citim pana golim socket-ul (EAGAIN)
+ *     5. Starea fiecarei conexiuni (StareConexiune) sta in heap, nu pe stiva
+ *
+ * =============================================================================
+ */
+
+#ifndef REACTOR_EPOLL_H
+#define REACTOR_EPOLL_H
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: ruleaza_reactor_epoll
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Porneste thread-urile de I/O si deserveste toti clientii pana cand
+ *     g_server_ruleaza devine 0. La oprire inchide toate conexiunile.
+ *
+ * PARAMETRI:
+ *     socket_server - socket-ul pe care s-a facut deja listen()
+ *
+ * RETURNEAZA:
+ *     0 dupa oprirea normala a serverului
+ *     -1 daca reactorul nu a putut porni (apelantul foloseste alt mod)
+ */
+int ruleaza_reactor_epoll(int socket_server);
+
+
+#endif /* REACTOR_EPOLL_H */
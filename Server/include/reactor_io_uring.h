@@ -0,0 +1,56 @@
+/*
+ * =============================================================================
+ * FISIER: reactor_io_uring.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Al doilea mod de retea, bazat pe io_uring (Linux 5.19+).
+ *
+ * CE E io_uring?
+ *     In loc sa facem un apel de sistem pentru fiecare accept() si recv(),
+ *     punem cererile intr-o coada partajata cu kernel-ul (SQ) si primim
+ *     rezultatele intr-o alta coada (CQ). Un singur io_uring_enter() poate
+ *     trimite si culege zeci de operatii.
+ *
+ * CE FOLOSIM DIN EL:
+ *     1. Accept "multishot" - O SINGURA cerere accepta toate conexiunile
+ *        viitoare, nu una cate una
+ *     2. Recv "multishot" - o singura cerere per conexiune primeste toate
+ *        mesajele, pana la deconectare
+ *     3. Inel de buffere furnizate (provided buffer ring) - kernel-ul alege
+ *        singur un buffer liber din inelul nostru pentru fiecare recv, asa
+ *        ca nu tinem cate un buffer blocat pentru fiecare conexiune
+ *
+ *     Rezultatul: o rafala de snapshot-uri de la multe host-uri costa doar
+ *     cateva apeluri de sistem, nu cate doua-trei per mesaj.
+ *
+ * DACA NU MERGE:
+ *     Pe kernel-uri vechi (sau unde io_uring e dezactivat) functia
+ *     returneaza -1 si serverul foloseste reactorul epoll.
+ *
+ * =============================================================================
+ */
+
+#ifndef REACTOR_IO_URING_H
+#define REACTOR_IO_URING_H
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: ruleaza_reactor_io_uring
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Porneste cate un inel io_uring (cu thread-ul lui) pentru fiecare nucleu
+ *     si deserveste toti clientii pana cand g_server_ruleaza devine 0.
+ *
+ * PARAMETRI:
+ *     socket_server - socket-ul pe care s-a facut deja listen()
+ *
+ * RETURNEAZA:
+ *     0 dupa oprirea normala a serverului
+ *     -1 daca kernel-ul nu suporta ce ne trebuie (apelantul foloseste epoll)
+ */
+int ruleaza_reactor_io_uring(int socket_server);
+
+
+#endif /* REACTOR_IO_URING_H */
@@ -24,10 +24,13 @@
  *     1. Creaza un socket (socket())
  *     2. Il leaga de un port (bind())
  *     3. Incepe sa asculte (listen())
- *     4. Asteapta clienti (accept()) - BLOCHEAZA pana vine cineva
- *     5. Pentru fiecare client, creaza un thread separat
- *     6. Thread-ul citeste date de la client (recv())
- *     7. Cand clientul se deconecteaza, thread-ul se termina
+ *     4. Asteapta clienti (accept())
+ *     5. Cateva thread-uri de I/O (reactorul epoll, vezi reactor_epoll.h)
+ *        urmaresc toate conexiunile si citesc doar de pe cele cu date noi
+ *     6. Cand un client se deconecteaza, conexiunea lui e inchisa
+ * 
+ *     Daca epoll nu e disponibil, revenim la modelul simplu: un thread
+ *     separat pentru fiecare client, care sta blocat in recv().
  * 
  * =============================================================================
  */
@@ -35,13 +38,104 @@
 #ifndef RETEA_H
 #define RETEA_H
 
+#include "structuri_date.h"  /* Pentru StareConexiune */
+#include <stddef.h>          /* Pentru size_t */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: deschide_conexiune
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Pregateste o conexiune noua, indiferent de modul in care e deservita
+ *     (thread separat sau reactor epoll):
+ *     - Aloca starea conexiunii (StareConexiune)
+ *     - Adauga clientul in lista de clienti conectati
+ *
+ *     Mesajul de bun venit pleaca abia dupa primii octeti de la client
+ *     (vezi proceseaza_date_primite), ca sa-l trimitem in formatul lui.
+ * 
+ * PARAMETRI:
+ *     socket_client - socket-ul intors de accept()
+ *     ip_client - IP-ul clientului, formatat "IP:PORT"
+ * 
+ * RETURNEAZA:
+ *     Starea noii conexiuni, sau NULL daca nu avem memorie
+ */
+StareConexiune* deschide_conexiune(int socket_client, const char* ip_client);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: proceseaza_date_primite
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Primeste octetii cititi de pe o conexiune, ii asambleaza cu ce a
+ *     ramas de la citirile anterioare si parseaza fiecare JSON complet.
+ *     Ce nu e inca complet ramane in starea conexiunii.
+ *
+ *     Mesajele pot veni in doua formate (detectat din primii octeti):
+ *     - incadrate: [lungime pe 4 octeti, big-endian][JSON] - cum trimite
+ *       clientul nostru; JSON-ul ajunge la parser fara nicio cautare
+ *     - JSON-uri simple, lipite unul de altul - le delimitam numarand
+ *       acoladele
+ * 
+ * PARAMETRI:
+ *     conexiune - starea conexiunii de pe care am citit
+ *     date - octetii primiti (nu trebuie sa fie terminati cu '\0').
+ *            JSON-urile sunt parsate direct aici, fara copie, asa ca
+ *            date[lungime] trebuie sa fie un octet in care putem scrie
+ *            (buffer-ul de citire are un octet in plus fata de recv)
+ *     lungime - cati octeti am primit
+ *
+ * RETURNEAZA:
+ *     1 daca putem citi mai departe de pe conexiune, 0 daca trebuie
+ *     inchisa (fluxul comprimat e corupt - vezi decomprima_flux)
+ */
+int proceseaza_date_primite(StareConexiune* conexiune, char* date, size_t lungime);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: mesaje_prea_mari
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Spune cate JSON-uri mai mari decat DIMENSIUNE_MAXIMA_MESAJ am aruncat
+ *     de la pornire (de pe toate conexiunile).
+ */
+unsigned long mesaje_prea_mari(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: inchide_conexiune
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Scoate clientul din lista de clienti conectati, inchide socket-ul si
+ *     elibereaza starea conexiunii.
+ */
+void inchide_conexiune(StareConexiune* conexiune);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: numar_threaduri_io
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Spune cate thread-uri de I/O pornesc reactoarele (epoll sau io_uring):
+ *     NUMAR_THREADURI_IO daca e setat, altfel cate unul pe nucleu,
+ *     dar niciodata mai mult de MAX_THREADURI_IO.
+ */
+int numar_threaduri_io(void);
+
 
 /*
  * -----------------------------------------------------------------------------
  * FUNCTIE: thread_gestionare_client
  * -----------------------------------------------------------------------------
  * CE FACE:
- *     Aceasta functie ruleaza intr-un THREAD SEPARAT pentru fiecare client.
+ *     Aceasta functie ruleaza intr-un THREAD SEPARAT pentru fiecare client
+ *     (doar in modul de rezerva, cand reactorul epoll nu porneste).
  *     Se ocupa de:
  *     - Trimiterea mesajului de bun venit
  *     - Primirea datelor JSON de la client
@@ -69,8 +163,8 @@ void* thread_gestionare_client(void* arg);
  *     - Crearea socket-ului server
  *     - Legarea la port (bind)
  *     - Ascultarea pentru conexiuni (listen)
- *     - Acceptarea clientilor noi (accept)
- *     - Crearea thread-urilor pentru fiecare client
+ *     - Pornirea reactorului epoll care deserveste toti clientii
+ *     - (rezerva) Acceptarea clientilor si un thread pentru fiecare
  * 
  * PARAMETRI:
  *     arg - nefolosit (NULL)
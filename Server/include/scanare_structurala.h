@@ -0,0 +1,74 @@
+/*
+ * =============================================================================
+ * FISIER: scanare_structurala.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Gaseste rapid caracterele "structurale" dintr-un JSON: ghilimelele,
+ *     backslash-ul, acoladele, parantezele drepte si '\0'.
+ *
+ * DE CE?
+ *     Si cautarea sfarsitului unui JSON (in retea.c), si parser-ul se uitau
+ *     la fiecare octet in parte, desi aproape toti octetii sunt litere si
+ *     cifre care nu le intereseaza. Acum procesorul compara 16 sau 32 de
+ *     octeti deodata (instructiuni SIMD) si ne da direct pozitiile care
+ *     conteaza; restul sunt sarite fara sa ne uitam la ele.
+ *
+ * CUM ALEGEM INSTRUCTIUNILE:
+ *     La primul apel intrebam procesorul ce stie:
+ *     - AVX2   -> 32 de octeti cu o singura incarcare
+ *     - SSE4.2 -> 16 octeti, cu PCMPESTRM ("e egal cu oricare din setul...")
+ *     - altfel -> varianta simpla, octet cu octet, cu un tabel
+ *     Toate dau exact acelasi rezultat; programul merge pe orice procesor.
+ *
+ * =============================================================================
+ */
+
+#ifndef SCANARE_STRUCTURALA_H
+#define SCANARE_STRUCTURALA_H
+
+#include <stddef.h>     /* Pentru size_t */
+#include <stdint.h>     /* Pentru uint16_t */
+
+
+/* Cati octeti indexeaza cel mult un apel indexeaza_structura()
+ * (pozitiile din bloc incap pe 16 biti) */
+#define MARIME_BLOC_STRUCTURAL 1024
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: indexeaza_structura
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Scrie in ordine pozitiile tuturor caracterelor structurale
+ *     (" \ { } [ ] si '\0') din zona [date, date + lungime).
+ *
+ * PARAMETRI:
+ *     date - octetii de scanat (nu trebuie sa fie terminati cu '\0')
+ *     lungime - cati octeti, cel mult MARIME_BLOC_STRUCTURAL
+ *     pozitii - unde scriem pozitiile (fata de date); trebuie sa aiba loc
+ *               pentru "lungime" valori
+ *
+ * RETURNEAZA:
+ *     Cate pozitii au fost scrise
+ */
+size_t indexeaza_structura(const char* date, size_t lungime, uint16_t* pozitii);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: urmatorul_structural
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Cauta, intr-un text terminat cu '\0', primul caracter structural
+ *     de la "text" incolo. Pentru parser: sare peste continutul unui
+ *     string sau al unei valori imbricate fara sa-l citeasca octet cu octet.
+ *
+ * RETURNEAZA:
+ *     Pozitia caracterului gasit (cel tarziu, '\0'-ul de la sfarsit)
+ */
+const char* urmatorul_structural(const char* text);
+
+
+#endif /* SCANARE_STRUCTURALA_H */
@@ -0,0 +1,140 @@
+/*
+ * =============================================================================
+ * FISIER: stare_gazde.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Starea curenta a proceselor fiecarui host (calculator client), tinuta
+ *     minte intre mesaje - ca sa putem primi doar ce s-a SCHIMBAT.
+ *
+ * DE CE?
+ *     Un client trimitea la fiecare ciclu toate procesele, desi de obicei
+ *     aproape nimic nu se schimba. Acum trimite:
+ *     - din cand in cand un CADRU COMPLET ("type":"KEYFRAME") - toate
+ *       procesele, ca pana acum
+ *     - in rest o DELTA ("type":"DELTA") - doar procesele noi, cele care
+ *       s-au schimbat vizibil (CPU, memorie, status) si PID-urile celor
+ *       disparute ("removed_pids")
+ *
+ *     Un proces schimbat vine fara textele care nu se schimba (nume,
+ *     user): le luam de aici, din starea host-ului. Logurile se fac doar
+ *     pentru procesele din mesaj - cele neschimbate nu mai ocupa nici
+ *     reteaua, nici lista de loguri.
+ *
+ * CUM E ORGANIZATA:
+ *     - fiecare host are tabelul lui (PID -> ultimul log), cu lacatul lui;
+ *       mesajele de la host-uri diferite nu se asteapta unele pe altele
+ *     - tabelul e cu adresare deschisa: PID-ul e cheia, coliziunile merg
+ *       la urmatorul loc liber
+ *     - la un cadru complet "pictam" procesele primite cu o generatie noua;
+ *       la sfarsit, cele ramase cu generatia veche au disparut si le stergem
+ *
+ * =============================================================================
+ */
+
+#ifndef STARE_GAZDE_H
+#define STARE_GAZDE_H
+
+#include "structuri_date.h"  /* Pentru LogEntry, IdSimbol */
+
+
+/* Ce fel de mesaj cu procese am primit */
+typedef enum {
+    SNAPSHOT_SIMPLU = 0,    /* Fara "type" - ca pana acum, nu atinge starea */
+    SNAPSHOT_CADRU_COMPLET, /* Toate procesele host-ului */
+    SNAPSHOT_DELTA          /* Doar schimbarile */
+} TipSnapshot;
+
+/* Ce campuri a trimis clientul pentru un proces (restul vin din stare) */
+#define TRIMIS_NUME        0x01u
+#define TRIMIS_UTILIZATOR  0x02u
+#define TRIMIS_STATUS      0x04u
+#define TRIMIS_NIVEL       0x08u
+#define TRIMIS_CPU         0x10u
+#define TRIMIS_MEMORIE     0x20u
+#define TRIMIS_MESAJ       0x40u
+
+/* Starea unui host - interiorul il stie doar stare_gazde.c */
+typedef struct StareGazda StareGazda;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: tip_snapshot
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Traduce valoarea cheii "type" ("KEYFRAME", "DELTA", orice altceva).
+ *
+ * PARAMETRI:
+ *     text / lungime - valoarea (fara '\0'); text poate fi NULL
+ */
+TipSnapshot tip_snapshot(const char* text, size_t lungime);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: deschide_stare_gazda / inchide_stare_gazda
+ * -----------------------------------------------------------------------------
+ * CE FAC:
+ *     deschide - gaseste (sau creeaza) starea host-ului si o blocheaza
+ *                pentru mesajul curent; la un cadru complet incepe o
+ *                generatie noua
+ *     inchide  - la un cadru complet sterge procesele care nu au venit in
+ *                el, apoi deblocheaza
+ *
+ * RETURNEAZA:
+ *     deschide - starea, sau NULL daca nu avem memorie (mesajul se
+ *                proceseaza atunci ca un snapshot simplu)
+ */
+StareGazda* deschide_stare_gazda(IdSimbol hostname, TipSnapshot tip);
+void inchide_stare_gazda(StareGazda* gazda, TipSnapshot tip);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: actualizeaza_proces
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Completeaza logul cu ce stim deja despre proces (campurile pe care
+ *     clientul nu le-a trimis), apoi il pastreaza ca stare curenta.
+ *
+ * PARAMETRI:
+ *     gazda - starea deschisa cu deschide_stare_gazda
+ *     intrare - logul primit; e completat pe loc
+ *     trimise - ce campuri au venit in mesaj (TRIMIS_*)
+ */
+void actualizeaza_proces(StareGazda* gazda, LogEntry* intrare, unsigned int trimise);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: elimina_proces
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Un proces a disparut de pe host - il scoatem din stare.
+ */
+void elimina_proces(StareGazda* gazda, int pid);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: elibereaza_stari_gazde
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Elibereaza starile tuturor host-urilor (la oprirea serverului).
+ */
+void elibereaza_stari_gazde(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: marcheaza_simboluri_gazde
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Marcheaza hostname-urile si textele proceselor tinute minte, ca
+ *     recuperarea simbolurilor sa nu le scoata (vezi tabela_simboluri.h).
+ */
+void marcheaza_simboluri_gazde(void);
+
+
+#endif /* STARE_GAZDE_H */
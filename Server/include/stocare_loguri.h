@@ -0,0 +1,229 @@
+/*
+ * =============================================================================
+ * FISIER: stocare_loguri.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Logurile din memorie, impartite in NUMAR_SHARDURI "shard-uri".
+ *
+ * DE CE SHARD-URI?
+ *     Cu o singura lista si un singur mutex, toti cei care scriu loguri
+ *     (de la orice host) se asteapta unii pe altii. Impartim lista dupa
+ *     host: fiecare shard are lista si lacatul lui, iar logurile de la
+ *     un host ajung mereu in acelasi shard (dupa un hash al hostname-ului,
+ *     sau al IP-ului daca lipseste hostname-ul). Host-uri diferite se scriu
+ *     in paralel, pe nuclee diferite.
+ *
+ * CE E UN BUFFER CIRCULAR?
+ *     Fiecare shard e un array de MAX_LOGURI locuri in care ne imaginam ca
+ *     dupa ultimul loc vine iar primul. Tinem minte unde e cel mai vechi
+ *     log (inceputul) si cate loguri avem.
+ *
+ *     Cand shard-ul e plin, logul nou se scrie PESTE cel mai vechi, iar
+ *     inceputul avanseaza - adaugarea costa la fel de putin indiferent cat
+ *     de plina e lista.
+ *
+ * CUM STAU LOGURILE IN SHARD?
+ *     Pe coloane: un array cu toate nivelurile, unul cu toate PID-urile,
+ *     unul cu toate timestamp-urile, etc. (nu un array de LogEntry).
+ *     Filtrele si interclasarea citesc doar coloanele de care au nevoie;
+ *     un LogEntry intreg e refacut doar pentru logurile afisate sau
+ *     exportate (obtine_log).
+ *
+ * CUM CITIM LOGURILE:
+ *     Afisarea si exportul vor toate logurile, in ordine. Intre
+ *     blocheaza_loguri() si deblocheaza_loguri() shard-urile sunt blocate
+ *     si "interclasate" in ordinea sosirii intr-o singura lista:
+ *     obtine_log(0, ...) = cel mai vechi log,
+ *     obtine_log(g_numar_loguri - 1, ...) = cel mai nou.
+ *
+ * =============================================================================
+ */
+
+#ifndef STOCARE_LOGURI_H
+#define STOCARE_LOGURI_H
+
+#include "structuri_date.h"
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: shard_pentru_log
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Alege shard-ul unui log, dupa hostname (sau IP, daca nu are hostname).
+ *
+ * RETURNEAZA:
+ *     Un numar intre 0 si NUMAR_SHARDURI - 1
+ */
+int shard_pentru_log(const LogEntry* intrare);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: adauga_log
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Adauga un log la sfarsitul shard-ului lui. Daca shard-ul e plin, il
+ *     inlocuieste pe cel mai vechi (FIFO).
+ *
+ * PARAMETRI:
+ *     intrare - logul de adaugat (e copiat in lista)
+ */
+void adauga_log(const LogEntry* intrare);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: adauga_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Ca adauga_log, dar pentru mai multe loguri din ACELASI shard: le
+ *     imparte pe coloane cu un singur lock.
+ *
+ * PARAMETRI:
+ *     shard - shard-ul lor (vezi shard_pentru_log)
+ *     intrari - logurile de adaugat, de la cel mai vechi la cel mai nou
+ *     numar - cate sunt
+ */
+void adauga_loguri(int shard, const LogEntry* intrari, int numar);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: goleste_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Sterge toate logurile din toate shard-urile.
+ */
+void goleste_loguri(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: blocheaza_loguri / deblocheaza_loguri
+ * -----------------------------------------------------------------------------
+ * CE FAC:
+ *     blocheaza_loguri - ia g_mutex_loguri si lacatele tuturor shard-urilor,
+ *                        apoi interclaseaza shard-urile in ordinea sosirii si
+ *                        pune in g_numar_loguri cate loguri sunt in total
+ *     deblocheaza_loguri - elibereaza toate lacatele
+ *
+ *     Intre ele nimeni nu poate scrie loguri, deci lista ramane neschimbata
+ *     cat timp o parcurgem.
+ */
+void blocheaza_loguri(void);
+void deblocheaza_loguri(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: obtine_log
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Reface din coloane logul cu indexul dat din lista interclasata
+ *     (0 = cel mai vechi). Se apeleaza DOAR intre blocheaza_loguri si
+ *     deblocheaza_loguri.
+ *
+ * PARAMETRI:
+ *     index - intre 0 si g_numar_loguri - 1
+ *     intrare - unde scriem logul
+ */
+void obtine_log(int index, LogEntry* intrare);
+
+
+/*
+ * Criteriile dupa care filtreaza_loguri() alege loguri.
+ */
+typedef struct {
+    NivelLog nivel;         /* Nivelul cautat, NIVEL_NECUNOSCUT = oricare */
+    StatusProces status;    /* Statusul cautat, STATUS_NECUNOSCUT = oricare */
+    const char* text;       /* Text cautat in nume/user/mesaj/status/host, "" = fara */
+} FiltruLoguri;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: filtreaza_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Trece lista interclasata prin filtru, citind doar coloanele de care
+ *     are nevoie (nivel si status sunt coduri de un octet; textele sunt
+ *     citite doar cand se cauta un text). Se apeleaza DOAR intre
+ *     blocheaza_loguri si deblocheaza_loguri.
+ *
+ * PARAMETRI:
+ *     filtru - criteriile
+ *     numar_gasite - aici scriem cate loguri au trecut
+ *
+ * RETURNEAZA:
+ *     Indicii (pentru obtine_log) logurilor care trec, de la cel mai vechi
+ *     la cel mai nou. Array-ul e valid pana la urmatorul apel.
+ */
+const int* filtreaza_loguri(const FiltruLoguri* filtru, int* numar_gasite);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: numara_pe_niveluri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Cate loguri are fiecare nivel, din toate shard-urile. Se apeleaza
+ *     DOAR intre blocheaza_loguri si deblocheaza_loguri.
+ *
+ * PARAMETRI:
+ *     numar_pe_nivel - aici scriem rezultatul, indexat cu NivelLog
+ */
+void numara_pe_niveluri(int numar_pe_nivel[NUMAR_NIVELURI]);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: copiaza_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Copiaza, in ordinea sosirii, urmatoarele loguri care trec filtrul.
+ *     Ia si elibereaza singura lacatele (NU se apeleaza intre
+ *     blocheaza_loguri si deblocheaza_loguri), asa ca cine parcurge multe
+ *     loguri le poate folosi pe bucati fara sa tina receptia pe loc.
+ *
+ * PARAMETRI:
+ *     filtru - criteriile
+ *     de_la - cursorul: ordinea de la care continuam (0 = de la inceput);
+ *             il mutam dupa ultimul log trecut in revista
+ *     pana_la - ne oprim la logurile cu ordinea >= pana_la (ex:
+ *               g_total_loguri_primite de la inceputul parcurgerii)
+ *     destinatie - cel putin 'maxim' loguri
+ *     maxim - cate loguri copiem cel mult
+ *
+ * RETURNEAZA:
+ *     Cate loguri am copiat. 0 = nu mai e nimic de copiat.
+ */
+int copiaza_loguri(const FiltruLoguri* filtru, unsigned long* de_la, unsigned long pana_la,
+                   LogEntry* destinatie, int maxim);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: numar_total_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Cate loguri sunt acum in toate shard-urile (fara sa blocheze nimic -
+ *     e bun pentru afisat in antet, nu pentru parcurs lista).
+ */
+int numar_total_loguri(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: marcheaza_simboluri_loguri
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Marcheaza textele tuturor logurilor pastrate, ca recuperarea
+ *     simbolurilor sa nu le scoata (vezi tabela_simboluri.h). Blocheaza
+ *     cate un shard o data.
+ */
+void marcheaza_simboluri_loguri(void);
+
+
+#endif /* STOCARE_LOGURI_H */
@@ -30,6 +30,21 @@
 /* Biblioteca signal pentru gestionarea semnalelor (Ctrl+C, etc.) */
 #include <signal.h>
 
+/* Pentru size_t */
+#include <stddef.h>
+
+/* IdSimbol - numarul unui text din tabela de simboluri */
+#include "tabela_simboluri.h"
+
+/* NivelLog, StatusProces - nivelul si statusul ca numere */
+#include "coduri_loguri.h"
+
+/* Pentru int64_t (timpul in nanosecunde) */
+#include <stdint.h>
+
+/* StatisticiCompresie - compresia fluxului unei conexiuni */
+#include "compresie_flux.h"
+
 
 /*
  * =============================================================================
@@ -42,6 +57,12 @@
  * | PID | Nume | Status | CPU% | Memorie | User | Mesaj | Level | Timestamp |
  * |-----|------|--------|------|---------|------|-------|-------|-----------|
  * | 123 | chrome| running| 25.5 | 500MB   | horea| OK    | INFO  | 14:30:00  |
+ *
+ * Campurile text NU contin textul, ci numarul lui din tabela de simboluri
+ * (IdSimbol, vezi tabela_simboluri.h). Acelasi hostname sau user, primit
+ * in mii de loguri, e pastrat o singura data; un log ocupa cateva zeci de
+ * octeti in loc de peste 2 KB. Textul se obtine cu text_simbol(), doar
+ * cand chiar ne trebuie (afisare, export).
  */
 typedef struct {
     /* === DATE DESPRE PROCES === */
@@ -50,9 +71,8 @@ typedef struct {
      * E ca CNP-ul pentru procese - fiecare are unul unic */
     int pid;
     
-    /* Numele procesului (ex: "chrome.exe", "firefox", "notepad")
-     * Array de caractere = sir de caractere = string */
-    char nume[LUNGIME_CAMP];
+    /* Numele procesului (ex: "chrome.exe", "firefox", "notepad") */
+    IdSimbol nume;
     
     /* Statusul procesului - ce face acum:
      * - "running" = ruleaza activ
@@ -61,7 +81,11 @@ typedef struct {
      * - "zombie" = proces mort care n-a fost curatat
      * - "crashed" = s-a prabusit (eroare)
      * - "static" = nu se schimba */
-    char status[LUNGIME_CAMP];
+    IdSimbol status;
+    
+    /* Acelasi status ca numar (STATUS_NECUNOSCUT daca e altceva) - il
+     * folosesc filtrul si colorarea, ca sa nu mai compare text */
+    StatusProces cod_status;
     
     /* Cat la suta din procesor foloseste (0.0 - 100.0)
      * double = numar cu virgula, precizie mare */
@@ -72,28 +96,40 @@ typedef struct {
     unsigned long memorie_kb;
     
     /* Utilizatorul care a pornit procesul (ex: "horea", "admin", "SYSTEM") */
-    char utilizator[LUNGIME_CAMP];
+    IdSimbol utilizator;
     
     /* Mesajul descriptiv (ex: "Functional", "High CPU usage", "Crashed") */
-    char mesaj[LUNGIME_CAMP * 2];  /* Mai lung, mesajele pot fi detaliate */
+    IdSimbol mesaj;
     
     /* Nivelul de importanta: "INFO", "WARN", "ERROR"
      * - INFO = totul e ok, informatie normala
      * - WARN = atentie, ceva nu e tocmai ok
-     * - ERROR = problema serioasa */
-    char nivel[LUNGIME_CAMP];
+     * - ERROR = problema serioasa
+     * Mereu cu litere mari (il transformam la primire) */
+    IdSimbol nivel;
+    
+    /* Acelasi nivel ca numar (NIVEL_NECUNOSCUT daca e altceva) */
+    NivelLog cod_nivel;
     
-    /* Cand s-a intamplat (ex: "2024-01-15 14:30:00") */
-    char timestamp[LUNGIME_CAMP];
+    /* Cand s-a intamplat, in nanosecunde de la 1970 (vezi timp_loguri.h).
+     * Textul ("2024-01-15 14:30:00") il facem doar la afisare/export. */
+    int64_t timestamp_ns;
+
+    /* Cand l-a primit serverul (tot in nanosecunde). Daca clientul nu
+     * trimite timpul, timestamp_ns e acelasi cu acesta. */
+    int64_t primit_ns;
     
     /* === METADATE CONEXIUNE === */
     /* Informatii despre de unde a venit acest log */
     
-    /* IP-ul clientului care a trimis log-ul (ex: "192.168.1.100:5432") */
-    char ip_client[64];
+    /* IP-ul clientului care a trimis log-ul (ex: "192.168.1.100"). Portul
+     * e tinut separat: fiecare conexiune are alt port, si ca text ar fi
+     * umplut tabela de simboluri cu valori folosite o singura data. */
+    IdSimbol ip_client;
+    uint16_t port_client;       /* ex: 5432 (0 = necunoscut) */
     
     /* Numele calculatorului client (ex: "DESKTOP-ABC123") */
-    char hostname[LUNGIME_CAMP];
+    IdSimbol hostname;
     
 } LogEntry;
 
@@ -117,6 +153,101 @@ typedef struct {
 } InfoClient;
 
 
+/*
+ * Cum sunt delimitate mesajele pe o conexiune (aflam din primii octeti).
+ *
+ * Clientul nostru pune in fata fiecarui JSON lungimea lui, pe 4 octeti
+ * (big-endian). Atunci stim exact unde se termina mesajul, fara sa
+ * numaram acolade. Alti producatori trimit JSON-uri "goale", unul dupa
+ * altul - pentru ei pastram cautarea dupa acolade.
+ */
+typedef enum {
+    INCADRARE_NEDETECTATA = 0,  /* Inca nu am primit destui octeti */
+    INCADRARE_LUNGIME,          /* [lungime pe 4 octeti][JSON] */
+    INCADRARE_ACOLADE           /* JSON-uri lipite, delimitate de { } */
+} ModIncadrare;
+
+
+/*
+ * Unde a ramas cautarea dupa acolade intre doua citiri de pe conexiune.
+ *
+ * Un JSON mare vine in multe bucati. Ca sa nu o luam de la capat la
+ * fiecare bucata noua, tinem minte pana unde am scanat si in ce stare
+ * eram (cate acolade deschise, daca eram intr-un string). Pozitiile sunt
+ * fata de primul octet inca neconsumat din buffer-ul conexiunii.
+ */
+typedef struct {
+    size_t pozitie;       /* De aici continuam scanarea */
+    size_t inceput_json;  /* Unde incepe JSON-ul neterminat */
+    size_t sari_pana;     /* Dupa un '\\' din string sarim caracterul urmator */
+    int adancime;         /* Cate acolade sunt deschise (0 = intre JSON-uri) */
+    int in_string;        /* Suntem in interiorul unui string? */
+    int arunca;           /* JSON-ul curent e prea mare - il sarim pana la capat */
+} StareScanare;
+
+
+/*
+ * =============================================================================
+ * STRUCTURA: StareConexiune
+ * =============================================================================
+ *
+ * Tot ce trebuie sa tinem minte despre o conexiune intre doua citiri:
+ * socket-ul, IP-ul si bucata de JSON inca incompleta.
+ *
+ * In modul cu thread per client aceste date stateau pe stiva thread-ului
+ * (80 KB per client). In reactorul epoll un singur thread deserveste mii de
+ * conexiuni, asa ca starea fiecareia trebuie sa stea separat, in heap.
+ * Buffer-ul de date e alocat DOAR cat timp avem un mesaj fragmentat, deci
+ * o conexiune inactiva costa doar cateva zeci de octeti.
+ */
+typedef struct StareConexiune {
+    /* Socket-ul conexiunii */
+    int socket;
+
+    /* IP-ul clientului (ex: "192.168.1.100:5432") */
+    char ip[64];
+
+    /* Cum sunt delimitate mesajele (vezi ModIncadrare) */
+    ModIncadrare incadrare;
+
+    /* Am trimis mesajul de bun venit? Pe conexiunile incadrate il trimitem
+     * dupa primul mesaj (HELLO), ca sa raspundem la ce ne-a cerut clientul */
+    int bun_venit_trimis;
+
+    /* Schema binara negociata la HELLO (vezi protocol_binar.h), 0 = doar JSON */
+    int schema_binara;
+
+    /* Decompresorul conexiunii, daca clientul a cerut compresie la HELLO
+     * (vezi compresie_flux.h), altfel NULL */
+    struct z_stream_s* flux_compresie;
+    StatisticiCompresie compresie;
+
+    /* Datele primite dar inca neprocesate (un mesaj incomplet)
+     * NULL cand nu avem nimic in asteptare.
+     * Mesajele procesate nu sunt sterse din buffer: doar mutam
+     * inceput_date dupa ele. Mutam datele la inceput doar cand nu mai
+     * avem loc la sfarsit. */
+    char* buffer_date;
+    size_t inceput_date;      /* Primul octet inca neprocesat */
+    size_t lungime_date;      /* Cati octeti sunt in buffer (cu cei procesati) */
+    size_t capacitate_date;   /* Cat e alocat */
+
+    /* Pana unde am cautat acoladele in datele neprocesate */
+    StareScanare scanare;
+
+    /* Legaturi in lista de conexiuni a thread-ului de I/O care o deserveste
+     * (ca sa le putem inchide pe toate la oprirea serverului) */
+    struct StareConexiune* anterior;
+    struct StareConexiune* urmator;
+
+    /* Reactorul epoll: conexiunea mai are date in socket dupa runda ei de
+     * citiri si asteapta in lista de "gata" a thread-ului (vezi reactor_epoll.c) */
+    struct StareConexiune* urmator_gata;
+    int in_lista_gata;
+
+} StareConexiune;
+
+
 /*
  * =============================================================================
  * VARIABILE GLOBALE
@@ -131,14 +262,21 @@ typedef struct {
 
 /* === LISTA DE LOGURI === */
 
-/* Array-ul care tine toate log-urile primite
- * E ca un tabel cu MAX_LOGURI randuri */
-extern LogEntry g_lista_loguri[MAX_LOGURI];
+/* Logurile propriu-zise stau in shard-uri, in stocare_loguri.c
+ * (fiecare shard cu lacatul lui). Aici sunt doar datele comune. */
 
-/* Cate loguri avem in lista (0 la inceput, creste cand primim loguri) */
+/* Cate loguri are lista interclasata de la ultimul blocheaza_loguri()
+ * (vezi stocare_loguri.h) - valid doar cat tinem lista blocata */
 extern int g_numar_loguri;
 
-/* Mutex (lacat) pentru lista de loguri
+/* Cate loguri am primit de la pornire (continua sa creasca si cand lista
+ * e plina - asa stim daca au aparut loguri noi). Se modifica atomic. */
+extern unsigned long g_total_loguri_primite;
+
+/* Mutex (lacat) pentru citirea listei de loguri
+ * 
+ * Il iau cei care CITESC toata lista (afisarea, exportul), prin
+ * blocheaza_loguri(). Cei care scriu folosesc doar lacatul shard-ului lor.
  * 
  * DE CE AVEM NEVOIE DE MUTEX?
  * Imaginea-ti ca 2 persoane incearca sa scrie in acelasi caiet simultan.
@@ -156,11 +294,17 @@ extern pthread_mutex_t g_mutex_loguri;
 
 /* === LISTA DE CLIENTI CONECTATI === */
 
-/* Array de pointeri la string-uri cu IP-urile clientilor conectati */
-extern char* g_clienti_conectati[MAX_CLIENTI];
+/* Array de pointeri la string-uri cu IP-urile clientilor conectati
+ * (alocat dinamic - are loc pentru g_capacitate_clienti clienti) */
+extern char** g_clienti_conectati;
+
+/* Pentru fiecare client din lista: statisticile compresiei conexiunii lui
+ * (pe aceeasi pozitie ca IP-ul) */
+extern const StatisticiCompresie** g_compresie_clienti;
 
-/* Cati clienti sunt conectati acum */
+/* Cati clienti sunt conectati acum / pentru cati avem loc */
 extern int g_numar_clienti;
+extern int g_capacitate_clienti;
 
 /* Mutex pentru lista de clienti (acelasi principiu ca mai sus) */
 extern pthread_mutex_t g_mutex_clienti;
@@ -180,6 +324,16 @@ extern volatile sig_atomic_t g_server_ruleaza;
 /* Socket-ul serverului (conexiunea principala pe care ascultam) */
 extern int g_socket_server;
 
+/* Cum deservim conexiunile (ales la pornire, vezi main) */
+typedef enum {
+    MOD_RETEA_EPOLL = 0,    /* Reactorul epoll (implicit) */
+    MOD_RETEA_IO_URING,     /* io_uring, cu epoll ca rezerva */
+    MOD_RETEA_THREADURI     /* Modul vechi: un thread per client */
+} ModRetea;
+
+/* Modul cerut la pornire; thread_server il actualizeaza cu cel folosit efectiv */
+extern volatile ModRetea g_mod_retea;
+
 
 /* === FILTRE PENTRU AFISARE === */
 
@@ -194,7 +348,6 @@ extern char g_text_cautat[128];
 
 
 /* Compatibilitate cu denumirile vechi din cod */
-#define g_logs          g_lista_loguri
 #define g_log_count     g_numar_loguri
 #define g_logs_mutex    g_mutex_loguri
 #define g_connected_clients g_clienti_conectati
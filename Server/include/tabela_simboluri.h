@@ -0,0 +1,144 @@
+/*
+ * =============================================================================
+ * FISIER: tabela_simboluri.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Tabela de simboluri ("interning") pentru textele din loguri.
+ *
+ * DE CE?
+ *     Un log avea cate un array de 256 de octeti pentru nume, status, user,
+ *     nivel, timestamp, hostname (si 512 pentru mesaj) - peste 2 KB per log,
+ *     desi valorile se repeta la nesfarsit: aceleasi host-uri, aceiasi
+ *     useri, aceleasi procese.
+ *
+ *     Acum fiecare text diferit e pastrat O SINGURA DATA, aici, si primeste
+ *     un numar (IdSimbol, pe 32 de biti). Logul tine doar numerele. Doua
+ *     texte sunt egale daca si numai daca au acelasi numar, asa ca filtrele
+ *     compara intregi, nu string-uri.
+ *
+ * CUM FUNCTIONEAZA:
+ *     1. Textele sunt impartite dupa hash in NUMAR_BENZI_SIMBOLURI "benzi",
+ *        fiecare cu tabela si lacatul ei - thread-urile care interneaza
+ *        texte diferite nu se asteapta unele pe altele
+ *     2. Fiecare thread tine minte ultimele texte internate (un cache mic,
+ *        fara lacat) - un host trimite aceleasi valori iar si iar
+ *     3. De la numar la text (text_simbol) nu luam niciun lacat
+ *
+ *     Textele nefolosite sunt recuperate periodic (vezi
+ *     incepe_recuperare_simboluri): un numar ramane valid cat timp e
+ *     intr-un log pastrat sau e internat din nou macar o data la
+ *     PERIOADA_RECUPERARE_SIMBOLURI secunde.
+ *
+ * =============================================================================
+ */
+
+#ifndef TABELA_SIMBOLURI_H
+#define TABELA_SIMBOLURI_H
+
+#include <stddef.h>     /* Pentru size_t */
+#include <stdint.h>     /* Pentru uint32_t */
+
+
+/* Numarul unui text internat */
+typedef uint32_t IdSimbol;
+
+/* Textul gol ("") are mereu numarul 0 - un LogEntry pus pe zero cu
+ * memset() are toate campurile text goale */
+#define SIMBOL_GOL ((IdSimbol)0)
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: interneaza / interneaza_n
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Cauta textul in tabela si il adauga daca nu exista.
+ *
+ * PARAMETRI:
+ *     text - textul (terminat cu '\0')
+ *     lungime - (doar interneaza_n) cati octeti din text folosim
+ *
+ * RETURNEAZA:
+ *     Numarul textului - acelasi pentru acelasi text, din orice thread
+ */
+IdSimbol interneaza(const char* text);
+IdSimbol interneaza_n(const char* text, size_t lungime);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: interneaza_adresa
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Pentru o adresa "IP:PORT", interneaza doar IP-ul si intoarce portul
+ *     ca numar. Fara ':' (sau cu un port invalid), interneaza tot textul.
+ *
+ * PARAMETRI:
+ *     adresa - ex: "192.168.1.100:5432"
+ *     port - unde scriem portul (0 daca nu are)
+ *
+ * RETURNEAZA:
+ *     Numarul IP-ului
+ */
+IdSimbol interneaza_adresa(const char* adresa, uint16_t* port);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: text_simbol
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Traduce un numar inapoi in text (pentru afisare si export).
+ *
+ * RETURNEAZA:
+ *     Textul, terminat cu '\0'. Nu trebuie modificat sau eliberat.
+ */
+const char* text_simbol(IdSimbol simbol);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: majuscule_simbol
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Numarul aceluiasi text scris cu litere mari ("running" -> "RUNNING").
+ *     E calculat o singura data, cand textul intra in tabela, asa ca o
+ *     comparatie fara diferenta intre litere mari si mici e tot o
+ *     comparatie de intregi.
+ */
+IdSimbol majuscule_simbol(IdSimbol simbol);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII: incepe_recuperare_simboluri / marcheaza_simbol /
+ *          termina_recuperare_simboluri
+ * -----------------------------------------------------------------------------
+ * CE FAC:
+ *     Recupereaza textele pe care nu le mai foloseste nimeni (ex: mesaje
+ *     care au aparut o data si ale caror loguri au fost suprascrise).
+ *
+ *     1. incepe_recuperare_simboluri - incepe o epoca noua. Intoarce 0 daca
+ *        de la ultima recuperare nu s-a adaugat niciun text (nu e nimic de
+ *        facut)
+ *     2. marcheaza_simbol - pentru fiecare numar tinut minte in afara
+ *        tabelei (loguri, host-uri)
+ *     3. termina_recuperare_simboluri - scoate din tabela textele nici
+ *        marcate, nici internate in ultimele doua epoci
+ *
+ *     Un text scos nu e sters imediat: numarul si memoria lui sunt
+ *     refolosite abia la urmatoarea recuperare, ca cine il citea chiar
+ *     atunci (text_simbol fara lacat) sa termine linistit.
+ *
+ *     Se apeleaza dintr-un singur thread, fara alte lacate luate.
+ *
+ * RETURNEAZA:
+ *     termina_recuperare_simboluri - cate texte au fost scoase
+ */
+int incepe_recuperare_simboluri(void);
+void marcheaza_simbol(IdSimbol simbol);
+size_t termina_recuperare_simboluri(void);
+
+
+#endif /* TABELA_SIMBOLURI_H */
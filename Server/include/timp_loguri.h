@@ -0,0 +1,89 @@
+/*
+ * =============================================================================
+ * FISIER: timp_loguri.h
+ * =============================================================================
+ *
+ * DESCRIERE:
+ *     Momentele din loguri, ca numar: nanosecunde de la 1 ianuarie 1970
+ *     (UTC), pe 64 de biti.
+ *
+ * DE CE?
+ *     Pana acum timpul unui log era textul "2024-01-15 14:30:00". Pentru
+ *     fiecare log fara timp (sau cu timp Unix) apelam localtime() +
+ *     strftime(), iar ordonarea logurilor compara string-uri.
+ *
+ *     Acum:
+ *     - la primire, textul ISO 8601 e citit de un parser scris special
+ *       pentru formatul asta (cifra cu cifra, fara sscanf/mktime)
+ *     - comparatiile intre timpi sunt intre doua numere (logurile raman
+ *       in ordinea in care au sosit, vezi stocare_loguri.h)
+ *     - textul e produs doar la afisare si export, printr-un cache: toate
+ *       logurile din aceeasi secunda (de obicei mii) costa o singura
+ *       conversie
+ *
+ * =============================================================================
+ */
+
+#ifndef TIMP_LOGURI_H
+#define TIMP_LOGURI_H
+
+#include <stddef.h>     /* Pentru size_t */
+#include <stdint.h>     /* Pentru int64_t */
+
+
+#define NS_PE_SECUNDA 1000000000LL
+
+/* Cate caractere are un timp formatat: "AAAA-LL-ZZ HH:MM:SS" + '\0' */
+#define LUNGIME_TIMP_FORMATAT 20
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: timp_curent_ns
+ * -----------------------------------------------------------------------------
+ * RETURNEAZA:
+ *     Momentul de acum, in nanosecunde de la 1970
+ */
+int64_t timp_curent_ns(void);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: parseaza_timp_iso
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Citeste un timp ISO 8601: "2024-01-15 14:30:00", "2024-01-15T14:30",
+ *     "2024-01-15T14:30:00.123Z", "2024-01-15T14:30:00+02:00" sau doar
+ *     "2024-01-15". Fara fus orar la sfarsit, e ora locala a serverului
+ *     (asa scriu si clientii, si exportul CSV).
+ *
+ * PARAMETRI:
+ *     text - textul (nu trebuie sa fie terminat cu '\0')
+ *     lungime - cati octeti are
+ *     rezultat - unde punem timpul, in nanosecunde
+ *
+ * RETURNEAZA:
+ *     1 daca textul e un timp valid, 0 altfel (si rezultat nu e atins)
+ */
+int parseaza_timp_iso(const char* text, size_t lungime, int64_t* rezultat);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: formateaza_timp
+ * -----------------------------------------------------------------------------
+ * CE FACE:
+ *     Scrie timpul ca "AAAA-LL-ZZ HH:MM:SS", in ora locala.
+ *
+ *     Fiecare thread tine minte ultimele doua secunde formatate: logurile
+ *     din aceeasi secunda primesc textul gata facut.
+ *
+ * RETURNEAZA:
+ *     Textul, intr-un buffer al thread-ului curent - ramane valid si dupa
+ *     urmatorul apel din acelasi thread (doi timpi pot fi folositi in
+ *     acelasi printf), dar nu si dupa al doilea
+ */
+const char* formateaza_timp(int64_t timp_ns);
+
+
+#endif /* TIMP_LOGURI_H */
@@ -1,5 +1,11 @@
 #include "afisare.h"
 #include "utilitare.h"
+#include "stocare_loguri.h"
+#include "coada_loguri.h"
+#include "retea.h"
+#include "tabela_simboluri.h"
+#include "coduri_loguri.h"
+#include "timp_loguri.h"
 #include "culori_si_configurari.h"
 
 #include <stdio.h>
@@ -18,59 +24,66 @@ void curata_ecranul(void) {
 }
 
 
-int trece_filtrul(const LogEntry* intrare) {
-    /*
-     * Verificam filtrul de NIVEL (INFO/WARN/ERROR)
-     */
-    if (strcmp(g_filtru_nivel, "ALL") != 0) {
-        /* Facem copii pentru a compara case-insensitive */
-        char nivel_log[32];
-        char nivel_filtru[32];
-        
-        strncpy(nivel_log, intrare->nivel, sizeof(nivel_log));
-        strncpy(nivel_filtru, g_filtru_nivel, sizeof(nivel_filtru));
-        
-        transforma_in_majuscule(nivel_log);
-        transforma_in_majuscule(nivel_filtru);
-        
-        if (strcmp(nivel_log, nivel_filtru) != 0) {
-            return 0;  /* Nu trece filtrul */
-        }
-    }
-    
+/*
+ * Culorile fiecarui status si nivel, indexate direct cu codul
+ */
+static const char* const g_culori_status[NUMAR_STATUSURI] = {
+    [STATUS_NECUNOSCUT] = FUNDAL_MAGENTA ALB,   /* Altceva = magenta */
+    [STATUS_RUNNING]    = FUNDAL_VERDE NEGRU,   /* Running = verde (totul e ok) */
+    [STATUS_SLEEPING]   = FUNDAL_CYAN NEGRU,    /* Sleeping = cyan (asteapta) */
+    [STATUS_STOPPED]    = FUNDAL_GRI NEGRU,     /* Stopped = gri */
+    [STATUS_ZOMBIE]     = FUNDAL_ROSU ALB,      /* Crashed/Zombie = ROSU (problema!) */
+    [STATUS_CRASHED]    = FUNDAL_ROSU ALB,
+    [STATUS_STATIC]     = FUNDAL_ALBASTRU ALB,  /* Static = albastru */
+};
+
+static const char* const g_culori_nivel[NUMAR_NIVELURI] = {
+    [NIVEL_NECUNOSCUT] = "",
+    [NIVEL_INFO]       = FUNDAL_VERDE NEGRU,
+    [NIVEL_WARN]       = FUNDAL_GALBEN NEGRU,
+    [NIVEL_ERROR]      = FUNDAL_ROSU ALB,
+};
+
+
+void filtrul_curent(FiltruLoguri* filtru) {
     /*
-     * Verificam filtrul de STATUS (running/crashed/etc)
+     * Traducem filtrele in coduri o singura data; fiecare log e apoi
+     * verificat pe coloanele de coduri. "ALL" nu e un cod cunoscut, deci
+     * devine NECUNOSCUT = oricare.
      */
-    if (strcmp(g_filtru_status, "ALL") != 0) {
-        char status_log[32];
-        char status_filtru[32];
-        
-        strncpy(status_log, intrare->status, sizeof(status_log));
-        strncpy(status_filtru, g_filtru_status, sizeof(status_filtru));
-        
-        transforma_in_majuscule(status_log);
-        transforma_in_majuscule(status_filtru);
-        
-        if (strcmp(status_log, status_filtru) != 0) {
-            return 0;  /* Nu trece filtrul */
-        }
+    filtru->nivel = cod_nivel(g_filtru_nivel);
+    filtru->status = cod_status(g_filtru_status);
+    filtru->text = g_text_cautat;
+}
+
+const int* gaseste_loguri_filtrate(int* numar_gasite) {
+    FiltruLoguri filtru;
+    filtrul_curent(&filtru);
+
+    return filtreaza_loguri(&filtru, numar_gasite);
+}
+
+void copiaza_ecranul(EcranLoguri* ecran, int maxim) {
+    if (maxim > MAX_RANDURI_ECRAN) {
+        maxim = MAX_RANDURI_ECRAN;
     }
-    
-    /*
-     * Verificam textul cautat (search)
-     */
-    if (strlen(g_text_cautat) > 0) {
-        /* Cautam in mai multe campuri */
-        if (!contine_text_insensitiv(intrare->nume, g_text_cautat) &&
-            !contine_text_insensitiv(intrare->utilizator, g_text_cautat) &&
-            !contine_text_insensitiv(intrare->mesaj, g_text_cautat) &&
-            !contine_text_insensitiv(intrare->status, g_text_cautat) &&
-            !contine_text_insensitiv(intrare->hostname, g_text_cautat)) {
-            return 0;  /* Nu am gasit textul nicaieri */
-        }
+
+    blocheaza_loguri();
+
+    const int* indici = gaseste_loguri_filtrate(&ecran->numar_filtrate);
+    int start = (ecran->numar_filtrate > maxim) ? (ecran->numar_filtrate - maxim) : 0;
+
+    ecran->numar = 0;
+    for (int i = start; i < ecran->numar_filtrate; i++) {
+        obtine_log(indici[i], &ecran->randuri[ecran->numar]);
+        ecran->indici[ecran->numar] = indici[i];
+        ecran->numar++;
     }
-    
-    return 1;  /* Trece toate filtrele! */
+
+    ecran->numar_total = g_numar_loguri;
+    numara_pe_niveluri(ecran->numar_pe_nivel);
+
+    deblocheaza_loguri();
 }
 
 void afiseaza_linie_log(const LogEntry* intrare, int index) {
@@ -82,7 +95,7 @@ void afiseaza_linie_log(const LogEntry* intrare, int index) {
     printf(DIM "[%4d] " RESET, index);
     
     /* TIMESTAMP - cand s-a intamplat, cyan */
-    printf(CYAN "%-19.19s " RESET, intrare->timestamp);
+    printf(CYAN "%-19.19s " RESET, formateaza_timp(intrare->timestamp_ns));
     /* %-19.19s inseamna: 
      * - aliniat la stanga (-)
      * - minim 19 caractere latime
@@ -92,63 +105,24 @@ void afiseaza_linie_log(const LogEntry* intrare, int index) {
     printf(DIM "%-6d " RESET, intrare->pid);
     
     /* NUME PROCES - bold alb pentru vizibilitate */
-    printf(BOLD ALB "%-14.14s " RESET, intrare->nume);
+    printf(BOLD ALB "%-14.14s " RESET, text_simbol(intrare->nume));
     
     /* UTILIZATOR - cine a pornit procesul */
-    printf(DIM CYAN "%-10.10s " RESET, intrare->utilizator);
+    printf(DIM CYAN "%-10.10s " RESET, text_simbol(intrare->utilizator));
     
     /*
-     * STATUS - colorat diferit in functie de stare
+     * STATUS - colorat diferit in functie de stare (culoarea o luam
+     * direct din tabel, dupa cod)
      */
-    char status_mare[32];
-    strncpy(status_mare, intrare->status, sizeof(status_mare));
-    transforma_in_majuscule(status_mare);
-    
-    /* Alegem culorile in functie de status */
-    if (strcmp(status_mare, "RUNNING") == 0) {
-        /* Running = verde (totul e ok) */
-        printf(FUNDAL_VERDE NEGRU " %-8.8s " RESET, status_mare);
-    } 
-    else if (strcmp(status_mare, "SLEEPING") == 0) {
-        /* Sleeping = cyan (asteapta) */
-        printf(FUNDAL_CYAN NEGRU " %-8.8s " RESET, status_mare);
-    } 
-    else if (strcmp(status_mare, "STATIC") == 0) {
-        /* Static = albastru */
-        printf(FUNDAL_ALBASTRU ALB " %-8.8s " RESET, status_mare);
-    } 
-    else if (strcmp(status_mare, "CRASHED") == 0 || strcmp(status_mare, "ZOMBIE") == 0) {
-        /* Crashed/Zombie = ROSU (problema!) */
-        printf(FUNDAL_ROSU ALB " %-8.8s " RESET, status_mare);
-    } 
-    else if (strcmp(status_mare, "STOPPED") == 0) {
-        /* Stopped = gri */
-        printf(FUNDAL_GRI NEGRU " %-8.8s " RESET, status_mare);
-    } 
-    else {
-        /* Altceva = magenta */
-        printf(FUNDAL_MAGENTA ALB " %-8.8s " RESET, status_mare);
-    }
+    const char* status_mare = (intrare->cod_status != STATUS_NECUNOSCUT)
+                              ? nume_status(intrare->cod_status)
+                              : text_simbol(majuscule_simbol(intrare->status));
+    printf("%s %-8.8s " RESET, g_culori_status[intrare->cod_status], status_mare);
     
     /*
      * LEVEL - nivelul de importanta, colorat
      */
-    char nivel_mare[32];
-    strncpy(nivel_mare, intrare->nivel, sizeof(nivel_mare));
-    transforma_in_majuscule(nivel_mare);
-    
-    if (strcmp(nivel_mare, "INFO") == 0) {
-        printf(FUNDAL_VERDE NEGRU " %-5s " RESET, nivel_mare);
-    } 
-    else if (strcmp(nivel_mare, "WARN") == 0) {
-        printf(FUNDAL_GALBEN NEGRU " %-5s " RESET, nivel_mare);
-    } 
-    else if (strcmp(nivel_mare, "ERROR") == 0) {
-        printf(FUNDAL_ROSU ALB " %-5s " RESET, nivel_mare);
-    } 
-    else {
-        printf(" %-5s ", nivel_mare);
-    }
+    printf("%s %-5s " RESET, g_culori_nivel[intrare->cod_nivel], text_simbol(intrare->nivel));
     
     /*
      * CPU si MEMORIE - afisate doar daca au valori
@@ -187,11 +161,12 @@ void afiseaza_linie_log(const LogEntry* intrare, int index) {
     /*
      * MESAJ - trunchiat daca e prea lung
      */
+    const char* mesaj = text_simbol(intrare->mesaj);
     char mesaj_trunchiat[40];
-    strncpy(mesaj_trunchiat, intrare->mesaj, sizeof(mesaj_trunchiat) - 4);
+    strncpy(mesaj_trunchiat, mesaj, sizeof(mesaj_trunchiat) - 4);
     mesaj_trunchiat[sizeof(mesaj_trunchiat) - 4] = '\0';
     
-    if (strlen(intrare->mesaj) > sizeof(mesaj_trunchiat) - 4) {
+    if (strlen(mesaj) > sizeof(mesaj_trunchiat) - 4) {
         strcat(mesaj_trunchiat, "...");  /* Adaugam "..." la sfarsit */
     }
     
@@ -217,7 +192,12 @@ void afiseaza_antet(void) {
     printf(VERDE BOLD " [SERVER] " RESET);
     printf("Status: " VERDE "ACTIV" RESET " | Port: %d | ", SERVER_PORT);
     printf(CYAN "Clienti: %d" RESET " | ", g_numar_clienti);
-    printf(GALBEN "Loguri: %d\n" RESET, g_numar_loguri);
+    printf("Retea: %s | ", g_mod_retea == MOD_RETEA_IO_URING ? "io_uring" :
+                           g_mod_retea == MOD_RETEA_EPOLL ? "epoll" : "threaduri");
+    printf(GALBEN "Loguri: %d" RESET " | ", numar_total_loguri());
+    printf("Coada: %zu | ", adancime_coada_loguri());
+    printf("%sAruncate: %lu" RESET " | ", loguri_aruncate() > 0 ? ROSU : DIM, loguri_aruncate());
+    printf("%sPrea mari: %lu\n" RESET, mesaje_prea_mari() > 0 ? ROSU : DIM, mesaje_prea_mari());
     
     /*
      * LISTA CLIENTI CONECTATI
@@ -226,9 +206,22 @@ void afiseaza_antet(void) {
     if (g_numar_clienti > 0) {
         printf(DIM CYAN " [CLIENTI] " RESET);
         
-        /* Afisam primii 5 clienti */
+        /* Afisam primii 5 clienti; la cei cu compresie: de cate ori s-au
+         * micsorat datele si cat procesor a costat decompresia */
         for (int i = 0; i < g_numar_clienti && i < 5; i++) {
+            const StatisticiCompresie* compresie = g_compresie_clienti[i];
             printf("%s ", g_clienti_conectati[i]);
+
+            if (compresie != NULL && __atomic_load_n(&compresie->activa, __ATOMIC_RELAXED)) {
+                unsigned long long comprimati = __atomic_load_n(&compresie->octeti_comprimati, __ATOMIC_RELAXED);
+                unsigned long long decomprimati = __atomic_load_n(&compresie->octeti_decomprimati, __ATOMIC_RELAXED);
+                unsigned long long ns = __atomic_load_n(&compresie->ns_procesor, __ATOMIC_RELAXED);
+
+                printf(DIM "(%s x%.1f, %.1f ms CPU%s) " RESET, NUME_COMPRESIE,
+                       comprimati > 0 ? (double)decomprimati / (double)comprimati : 0.0,
+                       (double)ns / 1e6,
+                       __atomic_load_n(&compresie->stricata, __ATOMIC_RELAXED) ? ", STRICAT" : "");
+            }
         }
         
         /* Daca sunt mai multi, aratam cati */
@@ -277,36 +270,25 @@ void actualizeaza_afisare(void) {
     /* Afisam header-ul */
     afiseaza_antet();
     
-    /* Blocam mutex-ul pentru a accesa lista de loguri in siguranta */
-    pthread_mutex_lock(&g_mutex_loguri);
-    
     /*
-     * Pas 1: Gasim toate logurile care trec filtrul
+     * Pas 1: Copiem ultimele N loguri care trec filtrul (sa incapa pe
+     * ecran) - doar cat copiem tinem lista blocata
      */
-    int indici_filtrate[MAX_LOGURI];
-    int numar_filtrate = 0;
-    
-    for (int i = 0; i < g_numar_loguri; i++) {
-        if (trece_filtrul(&g_lista_loguri[i])) {
-            indici_filtrate[numar_filtrate] = i;
-            numar_filtrate++;
-        }
-    }
+    int max_afisare = 18;  /* Cam atatea incap pe un ecran normal */
+    EcranLoguri ecran;
+    copiaza_ecranul(&ecran, max_afisare);
     
     /*
-     * Pas 2: Afisam ultimele N loguri (sa incapa pe ecran)
+     * Pas 2: Le afisam
      */
-    int max_afisare = 18;  /* Cam atatea incap pe un ecran normal */
-    int start = (numar_filtrate > max_afisare) ? (numar_filtrate - max_afisare) : 0;
-    
-    for (int i = start; i < numar_filtrate; i++) {
-        afiseaza_linie_log(&g_lista_loguri[indici_filtrate[i]], indici_filtrate[i] + 1);
+    for (int i = 0; i < ecran.numar; i++) {
+        afiseaza_linie_log(&ecran.randuri[i], ecran.indici[i] + 1);
     }
     
     /*
      * Pas 3: Mesaj daca nu sunt loguri
      */
-    if (numar_filtrate == 0) {
+    if (ecran.numar_filtrate == 0) {
         printf(DIM "\n  (Nu exista loguri care sa corespunda filtrelor)\n" RESET);
     }
     
@@ -314,11 +296,19 @@ void actualizeaza_afisare(void) {
      * Pas 4: Statistici
      */
     printf(DIM "\n  Afisate: %d / %d (total: %d)\n" RESET, 
-           numar_filtrate > max_afisare ? max_afisare : numar_filtrate, 
-           numar_filtrate, 
-           g_numar_loguri);
-    
-    pthread_mutex_unlock(&g_mutex_loguri);
+           ecran.numar, 
+           ecran.numar_filtrate, 
+           ecran.numar_total);
+    
+    printf(DIM "  Pe niveluri: " RESET);
+    for (int nivel = NIVEL_INFO; nivel < NUMAR_NIVELURI; nivel++) {
+        printf("%s %s: %d " RESET " ", g_culori_nivel[nivel], nume_nivel((NivelLog)nivel),
+               ecran.numar_pe_nivel[nivel]);
+    }
+    if (ecran.numar_pe_nivel[NIVEL_NECUNOSCUT] > 0) {
+        printf(DIM "altele: %d" RESET, ecran.numar_pe_nivel[NIVEL_NECUNOSCUT]);
+    }
+    printf("\n");
     
     /* Afisam meniul */
     afiseaza_meniu();
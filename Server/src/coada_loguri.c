@@ -0,0 +1,493 @@
+#include "coada_loguri.h"
+#include "stocare_loguri.h"
+#include "structuri_date.h"
+#include "culori_si_configurari.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>      /* Pentru operatiile atomice (C11) */
+#include <errno.h>
+#include <time.h>           /* Pentru clock_gettime() */
+#include <pthread.h>
+#include <semaphore.h>      /* Pentru sem_post(), sem_timedwait() */
+
+
+/*
+ * =============================================================================
+ * CUM FUNCTIONEAZA COADA
+ * =============================================================================
+ *
+ * E un buffer circular de CAPACITATE_COADA_LOGURI locuri. Pentru fiecare
+ * loc tinem, separat de log, un numar de secventa care spune in ce stare e:
+ *
+ *     secventa == pozitie       -> locul e liber pentru producatorul
+ *                                  care scrie la 'pozitie'
+ *     secventa == pozitie + 1   -> locul contine un log gata de citit
+ *
+ * Producatorii isi rezerva pozitii marind atomic pozitie_scriere
+ * (compare-and-swap). Abia dupa ce au copiat logurile "publica" locurile,
+ * schimbandu-le secventa. Scriitorul citeste locurile in ordine si le
+ * elibereaza, punand secventa pentru urmatoarea tura prin buffer.
+ *
+ * Un lot de N loguri se rezerva cu UN SINGUR compare-and-swap: scriitorul
+ * elibereaza locurile strict in ordine, deci daca ultimul loc din lot e
+ * liber, sunt libere si cele dinaintea lui. Logurile stau unul langa
+ * altul (secventele sunt in alt array), asa ca lotul se copiaza cu
+ * memcpy() - cel mult doua bucati, daca trece peste capatul buffer-ului.
+ *
+ * Nimeni nu asteapta pe nimeni: daca locurile nu sunt libere, coada
+ * e plina si logurile sunt aruncate.
+ */
+
+#define MASCA_COADA (CAPACITATE_COADA_LOGURI - 1)
+
+/*
+ * Fiecare shard are coada si scriitorul lui - logurile de la host-uri
+ * diferite trec in paralel, fara sa se astepte unele pe altele.
+ */
+typedef struct {
+    atomic_size_t secvente[CAPACITATE_COADA_LOGURI];
+    LogEntry intrari[CAPACITATE_COADA_LOGURI];
+
+    /* Pe linii de cache separate - producatorii si scriitorul nu trebuie
+     * sa isi "fure" unul altuia linia la fiecare operatie */
+    _Alignas(64) atomic_size_t pozitie_scriere;
+    _Alignas(64) atomic_size_t pozitie_citire;
+
+    /* Trezirea scriitorului cand coada nu mai e goala */
+    sem_t semnal_scriitor;
+    atomic_int scriitor_doarme;
+
+    int shard;
+    pthread_t thread;
+    int thread_pornit;
+} CoadaShard;
+
+static CoadaShard g_cozi[NUMAR_SHARDURI];
+
+static atomic_ulong g_loguri_aruncate;
+static atomic_int g_oprire_ceruta;
+
+static pthread_once_t g_initializare = PTHREAD_ONCE_INIT;
+
+
+/*
+ * Lotul fiecarui thread de I/O: logurile parsate se aduna aici si intra
+ * in coada toate odata (vezi trimite_lotul). Il alocam la prima folosire;
+ * cheia pthread ne da un destructor care il goleste si il elibereaza
+ * cand thread-ul se termina.
+ */
+typedef struct {
+    int numar;
+    LogEntry intrari[LOT_INGESTIE_LOGURI];
+} LotLoguri;
+
+static pthread_key_t g_cheie_lot;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: elibereaza_lot
+ * -----------------------------------------------------------------------------
+ * Destructorul lotului, apelat automat la terminarea thread-ului.
+ */
+static void elibereaza_lot(void* arg) {
+    LotLoguri* lot = (LotLoguri*)arg;
+
+    if (lot->numar > 0) {
+        pune_lot_in_coada(lot->intrari, lot->numar);
+    }
+    free(lot);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: initializeaza_coada
+ * -----------------------------------------------------------------------------
+ * La inceput locul i e liber pentru pozitia i. Se executa o singura data
+ * (pthread_once), indiferent de cate ori pornim serverul.
+ */
+static void initializeaza_coada(void) {
+    for (int shard = 0; shard < NUMAR_SHARDURI; shard++) {
+        CoadaShard* coada = &g_cozi[shard];
+
+        for (size_t i = 0; i < CAPACITATE_COADA_LOGURI; i++) {
+            atomic_init(&coada->secvente[i], i);
+        }
+        atomic_init(&coada->pozitie_scriere, 0);
+        atomic_init(&coada->pozitie_citire, 0);
+        sem_init(&coada->semnal_scriitor, 0, 0);
+        coada->shard = shard;
+    }
+    pthread_key_create(&g_cheie_lot, elibereaza_lot);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: rezerva_pozitii
+ * -----------------------------------------------------------------------------
+ * Rezerva 'numar' pozitii consecutive pentru scriere.
+ *
+ * RETURNEAZA:
+ *     1 si prima pozitie in 'inceput', sau 0 daca nu au loc
+ */
+static int rezerva_pozitii(CoadaShard* coada, size_t numar, size_t* inceput) {
+    size_t pozitie = atomic_load_explicit(&coada->pozitie_scriere, memory_order_relaxed);
+
+    while (1) {
+        size_t ultima = pozitie + numar - 1;
+        size_t secventa = atomic_load_explicit(&coada->secvente[ultima & MASCA_COADA], memory_order_acquire);
+
+        if (secventa == ultima) {
+            /* Locurile sunt libere - incercam sa le luam (alt producator
+             * poate fi mai rapid, caz in care CAS-ul ne da pozitia noua) */
+            if (atomic_compare_exchange_weak_explicit(&coada->pozitie_scriere, &pozitie, pozitie + numar,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                *inceput = pozitie;
+                return 1;
+            }
+        }
+        else if (secventa < ultima) {
+            /* Locul inca nu a fost citit de scriitor - nu avem loc */
+            return 0;
+        }
+        else {
+            /* Alt producator a luat pozitia intre timp - o recitim */
+            pozitie = atomic_load_explicit(&coada->pozitie_scriere, memory_order_relaxed);
+        }
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: pune_in_coada_shard
+ * -----------------------------------------------------------------------------
+ * Pune in coada unui shard loguri care apartin toate acelui shard.
+ *
+ * RETURNEAZA:
+ *     Cate loguri au intrat (restul au fost aruncate)
+ */
+static int pune_in_coada_shard(CoadaShard* coada, const LogEntry* intrari, int numar) {
+    /*
+     * Pas 1: Rezervam locurile pentru tot lotul
+     *
+     * Daca lotul intreg nu incape, il impartim in doua - in coada aproape
+     * plina poate mai intra macar o parte.
+     */
+    size_t inceput;
+
+    if (numar > CAPACITATE_COADA_LOGURI || !rezerva_pozitii(coada, (size_t)numar, &inceput)) {
+        if (numar == 1) {
+            atomic_fetch_add_explicit(&g_loguri_aruncate, 1, memory_order_relaxed);
+            return 0;
+        }
+        int jumatate = numar / 2;
+        return pune_in_coada_shard(coada, intrari, jumatate) +
+               pune_in_coada_shard(coada, intrari + jumatate, numar - jumatate);
+    }
+
+    /*
+     * Pas 2: Copiem logurile (cel mult doua bucati) si publicam locurile
+     */
+    size_t index = inceput & MASCA_COADA;
+    size_t pana_la_capat = CAPACITATE_COADA_LOGURI - index;
+    size_t prima_bucata = (size_t)numar < pana_la_capat ? (size_t)numar : pana_la_capat;
+
+    memcpy(&coada->intrari[index], intrari, prima_bucata * sizeof(LogEntry));
+    memcpy(&coada->intrari[0], intrari + prima_bucata, ((size_t)numar - prima_bucata) * sizeof(LogEntry));
+
+    for (size_t i = 0; i < (size_t)numar; i++) {
+        size_t pozitie = inceput + i;
+        atomic_store_explicit(&coada->secvente[pozitie & MASCA_COADA], pozitie + 1, memory_order_release);
+    }
+
+    /*
+     * Pas 3: Trezim scriitorul daca doarme
+     */
+    if (atomic_exchange_explicit(&coada->scriitor_doarme, 0, memory_order_acq_rel)) {
+        sem_post(&coada->semnal_scriitor);
+    }
+
+    return numar;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: pune_lot_in_coada
+ * -----------------------------------------------------------------------------
+ * Logurile consecutive din acelasi shard (de obicei tot lotul - un
+ * snapshot vine de la un singur host) pleaca impreuna.
+ */
+int pune_lot_in_coada(const LogEntry* intrari, int numar) {
+    pthread_once(&g_initializare, initializeaza_coada);
+
+    int puse = 0;
+    int inceput = 0;
+
+    while (inceput < numar) {
+        int shard = shard_pentru_log(&intrari[inceput]);
+        int sfarsit = inceput + 1;
+
+        while (sfarsit < numar && shard_pentru_log(&intrari[sfarsit]) == shard) {
+            sfarsit++;
+        }
+
+        puse += pune_in_coada_shard(&g_cozi[shard], intrari + inceput, sfarsit - inceput);
+        inceput = sfarsit;
+    }
+
+    return puse;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: pune_in_coada_loguri
+ * -----------------------------------------------------------------------------
+ */
+int pune_in_coada_loguri(const LogEntry* intrare) {
+    return pune_lot_in_coada(intrare, 1);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: lotul_threadului
+ * -----------------------------------------------------------------------------
+ * Lotul thread-ului curent (alocat la prima folosire), sau NULL daca nu
+ * avem memorie.
+ */
+static LotLoguri* lotul_threadului(void) {
+    pthread_once(&g_initializare, initializeaza_coada);
+
+    LotLoguri* lot = pthread_getspecific(g_cheie_lot);
+    if (lot == NULL) {
+        lot = malloc(sizeof(LotLoguri));
+        if (lot != NULL) {
+            lot->numar = 0;
+            pthread_setspecific(g_cheie_lot, lot);
+        }
+    }
+
+    return lot;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: adauga_in_lot
+ * -----------------------------------------------------------------------------
+ */
+void adauga_in_lot(const LogEntry* intrare) {
+    LotLoguri* lot = lotul_threadului();
+
+    if (lot == NULL) {
+        /* Fara memorie pentru lot - trimitem logul singur */
+        pune_in_coada_loguri(intrare);
+        return;
+    }
+
+    lot->intrari[lot->numar] = *intrare;
+    lot->numar++;
+
+    if (lot->numar == LOT_INGESTIE_LOGURI) {
+        trimite_lotul();
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: trimite_lotul
+ * -----------------------------------------------------------------------------
+ */
+void trimite_lotul(void) {
+    pthread_once(&g_initializare, initializeaza_coada);
+
+    LotLoguri* lot = pthread_getspecific(g_cheie_lot);
+
+    if (lot != NULL && lot->numar > 0) {
+        pune_lot_in_coada(lot->intrari, lot->numar);
+        lot->numar = 0;
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: muta_lot_in_lista
+ * -----------------------------------------------------------------------------
+ * Scoate din coada unui shard cel mult LOT_SCRIERE_LOGURI loguri si le
+ * copiaza in shard, cu un singur lock pe lacatul shard-ului.
+ *
+ * RETURNEAZA:
+ *     Cate loguri am mutat (0 = coada era goala)
+ */
+static int muta_lot_in_lista(CoadaShard* coada) {
+    size_t inceput = atomic_load_explicit(&coada->pozitie_citire, memory_order_relaxed);
+
+    /*
+     * Pas 1: Numaram cate locuri consecutive sunt publicate (fara lacat)
+     */
+    size_t numar = 0;
+
+    while (numar < LOT_SCRIERE_LOGURI) {
+        size_t pozitie = inceput + numar;
+
+        if (atomic_load_explicit(&coada->secvente[pozitie & MASCA_COADA], memory_order_acquire) != pozitie + 1) {
+            break;  /* Loc nepublicat inca - ne oprim aici */
+        }
+        numar++;
+    }
+
+    if (numar == 0) {
+        return 0;
+    }
+
+    /*
+     * Pas 2: Le copiem in shard (cel mult doua bucati)
+     */
+    size_t index = inceput & MASCA_COADA;
+    size_t pana_la_capat = CAPACITATE_COADA_LOGURI - index;
+    size_t prima_bucata = numar < pana_la_capat ? numar : pana_la_capat;
+
+    adauga_loguri(coada->shard, &coada->intrari[index], (int)prima_bucata);
+    if (numar > prima_bucata) {
+        adauga_loguri(coada->shard, &coada->intrari[0], (int)(numar - prima_bucata));
+    }
+
+    /*
+     * Pas 3: Eliberam locurile pentru tura urmatoare prin buffer
+     */
+    for (size_t i = 0; i < numar; i++) {
+        size_t pozitie = inceput + i;
+        atomic_store_explicit(&coada->secvente[pozitie & MASCA_COADA], pozitie + CAPACITATE_COADA_LOGURI,
+                              memory_order_release);
+    }
+
+    atomic_store_explicit(&coada->pozitie_citire, inceput + numar, memory_order_relaxed);
+    return (int)numar;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: thread_scriere_loguri
+ * -----------------------------------------------------------------------------
+ * Scriitorul unui shard: goleste coada lui in loturi. Se opreste doar dupa
+ * opreste_scriere_loguri(), si abia dupa ce a golit coada.
+ */
+static void* thread_scriere_loguri(void* arg) {
+    CoadaShard* coada = (CoadaShard*)arg;
+
+    while (1) {
+        if (muta_lot_in_lista(coada) > 0) {
+            continue;
+        }
+
+        /* Coada goala - ne oprim doar daca ni s-a cerut */
+        if (atomic_load(&g_oprire_ceruta)) {
+            break;
+        }
+
+        /*
+         * Anuntam ca dormim, apoi mai verificam o data coada: un producator
+         * poate sa fi pus un log chiar inainte sa ridicam steagul si nu ne-ar
+         * mai trezi nimeni
+         */
+        atomic_store(&coada->scriitor_doarme, 1);
+
+        if (muta_lot_in_lista(coada) > 0) {
+            atomic_store(&coada->scriitor_doarme, 0);
+            continue;
+        }
+
+        /* Dormim cel mult o secunda (ca sa observam si oprirea) */
+        struct timespec limita;
+        clock_gettime(CLOCK_REALTIME, &limita);
+        limita.tv_sec += 1;
+
+        while (sem_timedwait(&coada->semnal_scriitor, &limita) < 0 && errno == EINTR) {
+            /* Intrerupt de un semnal - mai asteptam */
+        }
+        atomic_store(&coada->scriitor_doarme, 0);
+    }
+
+    return NULL;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: porneste_scriere_loguri
+ * -----------------------------------------------------------------------------
+ */
+int porneste_scriere_loguri(void) {
+    pthread_once(&g_initializare, initializeaza_coada);
+    atomic_store(&g_oprire_ceruta, 0);
+
+    int pornite = 0;
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        CoadaShard* coada = &g_cozi[i];
+
+        coada->thread_pornit = (pthread_create(&coada->thread, NULL, thread_scriere_loguri, coada) == 0);
+        if (coada->thread_pornit) {
+            pornite++;
+        } else {
+            perror("Eroare la pthread_create (scriitor loguri)");
+        }
+    }
+
+    return pornite == NUMAR_SHARDURI ? 0 : -1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: opreste_scriere_loguri
+ * -----------------------------------------------------------------------------
+ */
+void opreste_scriere_loguri(void) {
+    pthread_once(&g_initializare, initializeaza_coada);
+
+    atomic_store(&g_oprire_ceruta, 1);
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        CoadaShard* coada = &g_cozi[i];
+
+        if (coada->thread_pornit) {
+            sem_post(&coada->semnal_scriitor);
+            pthread_join(coada->thread, NULL);
+            coada->thread_pornit = 0;
+        }
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: statistici coada
+ * -----------------------------------------------------------------------------
+ */
+size_t adancime_coada_loguri(void) {
+    size_t total = 0;
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        size_t scriere = atomic_load_explicit(&g_cozi[i].pozitie_scriere, memory_order_relaxed);
+        size_t citire = atomic_load_explicit(&g_cozi[i].pozitie_citire, memory_order_relaxed);
+
+        total += scriere > citire ? scriere - citire : 0;
+    }
+
+    return total;
+}
+
+unsigned long loguri_aruncate(void) {
+    return atomic_load_explicit(&g_loguri_aruncate, memory_order_relaxed);
+}
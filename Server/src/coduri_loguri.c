@@ -0,0 +1,119 @@
+#include "coduri_loguri.h"
+
+#include <string.h>     /* Pentru strlen() */
+#include <strings.h>    /* Pentru strncasecmp() */
+
+
+/* Numele fiecarui cod - indexat direct cu codul */
+static const char* const g_nume_niveluri[NUMAR_NIVELURI] = {
+    [NIVEL_NECUNOSCUT] = "",
+    [NIVEL_INFO]       = "INFO",
+    [NIVEL_WARN]       = "WARN",
+    [NIVEL_ERROR]      = "ERROR",
+};
+
+static const char* const g_nume_statusuri[NUMAR_STATUSURI] = {
+    [STATUS_NECUNOSCUT] = "",
+    [STATUS_RUNNING]    = "RUNNING",
+    [STATUS_SLEEPING]   = "SLEEPING",
+    [STATUS_STOPPED]    = "STOPPED",
+    [STATUS_ZOMBIE]     = "ZOMBIE",
+    [STATUS_CRASHED]    = "CRASHED",
+    [STATUS_STATIC]     = "STATIC",
+};
+
+/*
+ * Pentru fiecare litera (a-z): codurile al caror nume incepe cu ea.
+ * Locurile necompletate sunt 0 = NECUNOSCUT, adica "nimic".
+ */
+#define CANDIDATI_PE_LITERA 3
+
+static const unsigned char g_niveluri_dupa_litera[26][CANDIDATI_PE_LITERA] = {
+    ['e' - 'a'] = { NIVEL_ERROR },
+    ['i' - 'a'] = { NIVEL_INFO },
+    ['w' - 'a'] = { NIVEL_WARN },
+};
+
+static const unsigned char g_statusuri_dupa_litera[26][CANDIDATI_PE_LITERA] = {
+    ['c' - 'a'] = { STATUS_CRASHED },
+    ['r' - 'a'] = { STATUS_RUNNING },
+    ['s' - 'a'] = { STATUS_SLEEPING, STATUS_STOPPED, STATUS_STATIC },
+    ['z' - 'a'] = { STATUS_ZOMBIE },
+};
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: cauta_cod
+ * -----------------------------------------------------------------------------
+ * Alege din tabel randul primei litere si compara textul doar cu numele
+ * candidatilor de pe acel rand.
+ */
+static int cauta_cod(const char* text,
+                     const unsigned char candidati[26][CANDIDATI_PE_LITERA],
+                     const char* const nume[]) {
+    /* Litera mica: 'R' | 0x20 = 'r' (merge doar pentru litere) */
+    unsigned int litera = (unsigned int)((unsigned char)text[0] | 0x20) - 'a';
+    if (litera >= 26) {
+        return 0;
+    }
+
+    size_t lungime = strlen(text);
+
+    for (int i = 0; i < CANDIDATI_PE_LITERA && candidati[litera][i] != 0; i++) {
+        const char* candidat = nume[candidati[litera][i]];
+
+        if (strlen(candidat) == lungime && strncasecmp(candidat, text, lungime) == 0) {
+            return candidati[litera][i];
+        }
+    }
+
+    return 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: cod_nivel / cod_status
+ * -----------------------------------------------------------------------------
+ */
+NivelLog cod_nivel(const char* text) {
+    return (NivelLog)cauta_cod(text, g_niveluri_dupa_litera, g_nume_niveluri);
+}
+
+StatusProces cod_status(const char* text) {
+    return (StatusProces)cauta_cod(text, g_statusuri_dupa_litera, g_nume_statusuri);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: nume_nivel / nume_status
+ * -----------------------------------------------------------------------------
+ */
+const char* nume_nivel(NivelLog nivel) {
+    return ((unsigned int)nivel < NUMAR_NIVELURI) ? g_nume_niveluri[nivel] : "";
+}
+
+const char* nume_status(StatusProces status) {
+    return ((unsigned int)status < NUMAR_STATUSURI) ? g_nume_statusuri[status] : "";
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: deduce_nivel
+ * -----------------------------------------------------------------------------
+ */
+NivelLog deduce_nivel(StatusProces status, double procent_cpu, unsigned long memorie_kb) {
+    if (status == STATUS_CRASHED || status == STATUS_ZOMBIE) {
+        /* Proces mort = ERROR */
+        return NIVEL_ERROR;
+    }
+    if (procent_cpu > 80.0 || memorie_kb > 1024 * 1024) {
+        /* CPU > 80% sau memorie > 1GB = WARNING */
+        return NIVEL_WARN;
+    }
+    /* Altfel = INFO */
+    return NIVEL_INFO;
+}
@@ -0,0 +1,168 @@
+#include "compresie_flux.h"
+#include "parser_json.h"
+#include "culori_si_configurari.h"
+
+#include <stdlib.h>     /* Pentru calloc(), free() */
+#include <string.h>     /* Pentru memcmp() */
+#include <time.h>       /* Pentru clock_gettime() */
+#include <zlib.h>       /* Pentru inflate() */
+
+
+/*
+ * Dictionarul comun: bucati care apar in aproape orice mesaj. Clientul
+ * are exact aceiasi octeti (client/src/main.cpp/stream_compression.hpp) -
+ * zlib verifica asta singur (dupa suma de control a dictionarului).
+ * Ce apare mai des sta la sfarsit: acolo trimiterile inapoi sunt mai scurte.
+ */
+static const char g_dictionar_compresie[] =
+    "{\"type\":\"GOODBYE\",\"client_name\":\"\"}"
+    "\"connection_status\":\"connected\""
+    "{\"pid\":,\"name\":\".exe\",\"user\":\"\",\"cpu_percent\":0,\"memory_kb\":,"
+    "\"status\":\"STOPPED\",\"log_level\":\"ERROR\"},"
+    "{\"pid\":,\"name\":\"\",\"user\":\"\",\"cpu_percent\":0,\"memory_kb\":,"
+    "\"status\":\"SLEEPING\",\"log_level\":\"WARN\"},"
+    "{\"hostname\":\"\",\"timestamp\":,\"processes\":["
+    "{\"hostname\":\"\",\"timestamp\":,\"pid\":,\"name\":\"\",\"user\":\"\","
+    "\"cpu_percent\":0,\"memory_kb\":,\"status\":\"RUNNING\",\"log_level\":\"INFO\"}";
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: compresie_ceruta
+ * -----------------------------------------------------------------------------
+ */
+int compresie_ceruta(const char* json) {
+    CerereHello cerere;
+
+    if (!parseaza_hello(json, &cerere) || cerere.compresie == NULL) {
+        return 0;
+    }
+
+    return cerere.lungime_compresie == sizeof(NUME_COMPRESIE) - 1 &&
+           memcmp(cerere.compresie, NUME_COMPRESIE, cerere.lungime_compresie) == 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: porneste_decompresia / opreste_decompresia
+ * -----------------------------------------------------------------------------
+ */
+struct z_stream_s* porneste_decompresia(void) {
+    z_stream* flux = calloc(1, sizeof(z_stream));
+    if (flux == NULL) {
+        return NULL;
+    }
+
+    /* zalloc/zfree/opaque = 0 (calloc) -> zlib foloseste malloc/free */
+    if (inflateInit(flux) != Z_OK) {
+        free(flux);
+        return NULL;
+    }
+
+    return flux;
+}
+
+void opreste_decompresia(struct z_stream_s* flux) {
+    if (flux == NULL) {
+        return;
+    }
+
+    inflateEnd(flux);
+    free(flux);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: timp_procesor_ns
+ * -----------------------------------------------------------------------------
+ * Cat timp de procesor a folosit thread-ul curent (nu cat a trecut pe
+ * ceas) - asa nu punem pe seama decompresiei asteptarile thread-ului.
+ */
+static unsigned long long timp_procesor_ns(void) {
+    struct timespec acum;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &acum);
+
+    return (unsigned long long)acum.tv_sec * 1000000000ULL + (unsigned long long)acum.tv_nsec;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: decomprima_flux
+ * -----------------------------------------------------------------------------
+ */
+int decomprima_flux(struct z_stream_s* flux, const char* date, size_t lungime,
+                    StatisticiCompresie* statistici,
+                    PrimesteDecomprimate primeste, void* context) {
+    char iesire[DIMENSIUNE_BUFFER + 1];  /* + octetul liber de dupa date */
+    unsigned long long decomprimati = 0;
+    unsigned long long timp_decompresie = 0;
+    int rezultat = Z_OK;
+
+    if (statistici->stricata) {
+        return 0;
+    }
+
+    flux->next_in = (Bytef*)date;
+    flux->avail_in = (uInt)lungime;
+
+    /*
+     * Pas 1: Decomprimam bucata cu bucata, cat timp mai avem octeti de
+     * intrare sau decompresorul a umplut tot buffer-ul (mai are de dat)
+     */
+    do {
+        unsigned long long inceput = timp_procesor_ns();
+
+        flux->next_out = (Bytef*)iesire;
+        flux->avail_out = DIMENSIUNE_BUFFER;
+        rezultat = inflate(flux, Z_NO_FLUSH);
+
+        /* Primul bloc cere dictionarul comun */
+        if (rezultat == Z_NEED_DICT) {
+            rezultat = inflateSetDictionary(flux, (const Bytef*)g_dictionar_compresie,
+                                            sizeof(g_dictionar_compresie) - 1);
+            timp_decompresie += timp_procesor_ns() - inceput;
+            if (rezultat != Z_OK) {
+                break;
+            }
+            continue;
+        }
+
+        timp_decompresie += timp_procesor_ns() - inceput;
+
+        /* Z_BUF_ERROR = nu a mai avut ce face (am consumat tot) - e normal */
+        if (rezultat != Z_OK && rezultat != Z_BUF_ERROR && rezultat != Z_STREAM_END) {
+            break;
+        }
+
+        size_t produse = DIMENSIUNE_BUFFER - flux->avail_out;
+        decomprimati += produse;
+
+        if (produse > 0) {
+            primeste(context, iesire, produse);
+        }
+
+        /* Clientul a inchis fluxul: ce mai vine dupa nu mai poate fi
+         * decomprimat cu el */
+        if (rezultat == Z_STREAM_END) {
+            rezultat = Z_DATA_ERROR;
+            break;
+        }
+    } while (flux->avail_in > 0 || flux->avail_out == 0);
+
+    /*
+     * Pas 2: Statisticile conexiunii
+     */
+    __atomic_fetch_add(&statistici->octeti_comprimati, (unsigned long long)lungime, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&statistici->octeti_decomprimati, decomprimati, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&statistici->ns_procesor, timp_decompresie, __ATOMIC_RELAXED);
+
+    if (rezultat != Z_OK && rezultat != Z_BUF_ERROR) {
+        __atomic_store_n(&statistici->stricata, 1, __ATOMIC_RELAXED);
+        return 0;
+    }
+
+    return 1;
+}
@@ -2,6 +2,9 @@
 #include "structuri_date.h"
 #include "afisare.h"
 #include "utilitare.h"
+#include "stocare_loguri.h"
+#include "tabela_simboluri.h"
+#include "timp_loguri.h"
 #include "culori_si_configurari.h"
 
 #include <stdio.h>
@@ -46,21 +49,38 @@ void exporta_loguri_csv(void) {
     /*
      * Pas 3: Scriem header-ul CSV (numele coloanelor)
      */
-    fprintf(fisier, "Timestamp,PID,Process,User,Status,Level,CPU%%,MemoryKB,Message,Hostname,ClientIP\n");
+    fprintf(fisier, "Timestamp,PID,Process,User,Status,Level,CPU%%,MemoryKB,Message,Hostname,ClientIP,ReceivedAt\n");
     
     /*
      * Pas 4: Scriem fiecare log care trece filtrul
      * 
-     * Folosim mutex pentru ca lista de loguri poate fi modificata
-     * de alte thread-uri in timp ce scriem.
+     * Logurile pot fi modificate de alte thread-uri in timp ce scriem, asa
+     * ca le copiem bucata cu bucata (copiaza_loguri ia lacatele doar cat
+     * copiaza) si scriem in fisier fara lacate. Exportam doar ce sosise
+     * cand am inceput - altfel, sub trafic, exportul n-ar mai termina.
      */
-    pthread_mutex_lock(&g_mutex_loguri);
+    static LogEntry bucata[LOGURI_PE_BUCATA_EXPORT];
+    FiltruLoguri filtru;
+    filtrul_curent(&filtru);
     
+    unsigned long cursor = 0;
+    unsigned long pana_la = __atomic_load_n(&g_total_loguri_primite, __ATOMIC_RELAXED);
     int numar_exportate = 0;
+    int copiate;
     
-    for (int i = 0; i < g_numar_loguri; i++) {
-        /* Verificam daca acest log trece prin filtrele curente */
-        if (trece_filtrul(&g_lista_loguri[i])) {
+    while ((copiate = copiaza_loguri(&filtru, &cursor, pana_la, bucata, LOGURI_PE_BUCATA_EXPORT)) > 0) {
+        for (int i = 0; i < copiate; i++) {
+            const LogEntry* log_curent = &bucata[i];  /* In ordine, de la cel mai vechi */
+            
+            /* Adresa clientului, ca inainte: "IP:PORT" */
+            char adresa[LUNGIME_CAMP];
+            if (log_curent->port_client != 0) {
+                snprintf(adresa, sizeof(adresa), "%s:%u",
+                         text_simbol(log_curent->ip_client), (unsigned)log_curent->port_client);
+            } else {
+                snprintf(adresa, sizeof(adresa), "%s", text_simbol(log_curent->ip_client));
+            }
+            
             /*
              * Scriem linia in format CSV
              * 
@@ -69,25 +89,24 @@ void exporta_loguri_csv(void) {
              * 
              * fprintf() e ca printf() dar scrie in fisier in loc de ecran
              */
-            fprintf(fisier, "\"%s\",%d,\"%s\",\"%s\",\"%s\",\"%s\",%.2f,%lu,\"%s\",\"%s\",\"%s\"\n",
-                    g_lista_loguri[i].timestamp,
-                    g_lista_loguri[i].pid,
-                    g_lista_loguri[i].nume,
-                    g_lista_loguri[i].utilizator,
-                    g_lista_loguri[i].status,
-                    g_lista_loguri[i].nivel,
-                    g_lista_loguri[i].procent_cpu,
-                    g_lista_loguri[i].memorie_kb,
-                    g_lista_loguri[i].mesaj,
-                    g_lista_loguri[i].hostname,
-                    g_lista_loguri[i].ip_client);
-            
-            numar_exportate++;
+            fprintf(fisier, "\"%s\",%d,\"%s\",\"%s\",\"%s\",\"%s\",%.2f,%lu,\"%s\",\"%s\",\"%s\",\"%s\"\n",
+                    formateaza_timp(log_curent->timestamp_ns),
+                    log_curent->pid,
+                    text_simbol(log_curent->nume),
+                    text_simbol(log_curent->utilizator),
+                    text_simbol(log_curent->status),
+                    text_simbol(log_curent->nivel),
+                    log_curent->procent_cpu,
+                    log_curent->memorie_kb,
+                    text_simbol(log_curent->mesaj),
+                    text_simbol(log_curent->hostname),
+                    adresa,
+                    formateaza_timp(log_curent->primit_ns));
         }
+        
+        numar_exportate += copiate;
     }
     
-    pthread_mutex_unlock(&g_mutex_loguri);
-    
     /*
      * Pas 5: Inchidem fisierul
      * 
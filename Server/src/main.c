@@ -13,6 +13,9 @@
 #include "export.h"                  /* Functii de export */
 #include "terminal.h"                /* Control terminal */
 #include "vizualizare_loguri.h"      /* Vizualizare loguri vechi */
+#include "stocare_loguri.h"          /* Logurile, pe shard-uri */
+#include "coada_loguri.h"            /* Coada spre lista de loguri */
+#include "stare_gazde.h"             /* Starea proceselor fiecarui host */
 
 /* Biblioteci standard */
 #include <stdio.h>
@@ -31,18 +34,21 @@
  */
 
 /* Lista de loguri primite */
-LogEntry g_lista_loguri[MAX_LOGURI];
 int g_numar_loguri = 0;
+unsigned long g_total_loguri_primite = 0;
 pthread_mutex_t g_mutex_loguri = PTHREAD_MUTEX_INITIALIZER;
 
 /* Lista de clienti conectati */
-char* g_clienti_conectati[MAX_CLIENTI];
+char** g_clienti_conectati = NULL;
+const StatisticiCompresie** g_compresie_clienti = NULL;
 int g_numar_clienti = 0;
+int g_capacitate_clienti = 0;
 pthread_mutex_t g_mutex_clienti = PTHREAD_MUTEX_INITIALIZER;
 
 /* Starea serverului */
 volatile sig_atomic_t g_server_ruleaza = 1;
 int g_socket_server = -1;
+volatile ModRetea g_mod_retea = MOD_RETEA_EPOLL;
 
 /* Filtre pentru afisare */
 char g_filtru_nivel[32] = "ALL";
@@ -119,6 +125,9 @@ void ruleaza_mod_server(void) {
     pthread_t id_thread_server;
     pthread_t id_thread_refresh;
     
+    /* Scriitorii pornesc primii - ei golesc cozile in care pun logurile
+     * thread-urile de I/O */
+    porneste_scriere_loguri();
     pthread_create(&id_thread_server, NULL, thread_server, NULL);
     pthread_create(&id_thread_refresh, NULL, thread_refresh_automat, NULL);
     
@@ -196,9 +205,7 @@ void ruleaza_mod_server(void) {
                 }
                 
                 if (toupper(confirmare) == 'D' || toupper(confirmare) == 'Y') {
-                    pthread_mutex_lock(&g_mutex_loguri);
-                    g_numar_loguri = 0;
-                    pthread_mutex_unlock(&g_mutex_loguri);
+                    goleste_loguri();
                 }
                 
                 actualizeaza_afisare();
@@ -249,11 +256,20 @@ void ruleaza_mod_server(void) {
     pthread_join(id_thread_server, NULL);
     pthread_join(id_thread_refresh, NULL);
     
+    /* Nu mai vin loguri noi - scriitorii golesc ce a ramas si se opresc */
+    opreste_scriere_loguri();
+    elibereaza_stari_gazde();
+    
     pthread_mutex_lock(&g_mutex_clienti);
     for (int i = 0; i < g_numar_clienti; i++) {
         free(g_clienti_conectati[i]);
     }
+    free(g_clienti_conectati);
+    free(g_compresie_clienti);
+    g_clienti_conectati = NULL;
+    g_compresie_clienti = NULL;
     g_numar_clienti = 0;
+    g_capacitate_clienti = 0;
     pthread_mutex_unlock(&g_mutex_clienti);
     
     printf(GALBEN "\n\n  Server oprit.\n\n" RESET);
@@ -265,10 +281,29 @@ void ruleaza_mod_server(void) {
  * FUNCTIA PRINCIPALA - main()
  * =============================================================================
  */
-int main(void) {
+int main(int argc, char* argv[]) {
     char input[16];
     int ruleaza = 1;
     
+    /*
+     * Optiuni din linia de comanda:
+     *   --retea=epoll      reactorul epoll (implicit)
+     *   --retea=io_uring   io_uring, daca il suporta kernel-ul
+     *   --retea=threaduri  un thread per client (modul vechi)
+     */
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--retea=epoll") == 0) {
+            g_mod_retea = MOD_RETEA_EPOLL;
+        } else if (strcmp(argv[i], "--retea=io_uring") == 0) {
+            g_mod_retea = MOD_RETEA_IO_URING;
+        } else if (strcmp(argv[i], "--retea=threaduri") == 0) {
+            g_mod_retea = MOD_RETEA_THREADURI;
+        } else {
+            fprintf(stderr, "Utilizare: %s [--retea=epoll|io_uring|threaduri]\n", argv[0]);
+            return 1;
+        }
+    }
+    
     while (ruleaza) {
         /* Afisam meniul principal */
         afiseaza_meniu_principal();
@@ -1,12 +1,19 @@
 #include "parser_json.h"
 #include "utilitare.h"
+#include "coada_loguri.h"
+#include "tabela_simboluri.h"
+#include "coduri_loguri.h"
+#include "scanare_structurala.h"
+#include "timp_loguri.h"
+#include "stare_gazde.h"
 #include "culori_si_configurari.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>   /* Pentru strncasecmp() */
 #include <ctype.h>
-#include <time.h>      /* Pentru localtime(), strftime(), time_t */
+#include <limits.h>    /* Pentru INT_MAX */
 
 
 /*
@@ -160,176 +167,746 @@ int json_extrage_int(const char* json, const char* cheie) {
 }
 
 
+/*
+ * =============================================================================
+ * PARSAREA INTR-O SINGURA TRECERE
+ * =============================================================================
+ *
+ * Functiile json_extrage_* de mai sus cauta cheia cu strstr() prin tot
+ * JSON-ul, la fiecare apel - cu cheile alternative ("name" -> "app" ->
+ * "process" -> ...) un mesaj era parcurs de 15-20 de ori. In plus, strstr()
+ * gaseste cheia si cand apare INAUNTRUL unei valori text.
+ *
+ * Mesajele primite le parcurgem acum o singura data, cheie cu cheie.
+ * Fiecare cheie e cautata intr-un tabel cu hash perfect (vezi
+ * g_chei_json), iar valoarea ei e pusa direct in campul potrivit. Textele
+ * nu sunt copiate: tinem minte doar unde incep in JSON si cat de lungi
+ * sunt, pana le internam.
+ */
+
+/* Campurile pe care le recunoastem */
+typedef enum {
+    CAMP_NECUNOSCUT = 0,
+    CAMP_PID,
+    CAMP_NUME,
+    CAMP_STATUS,
+    CAMP_CPU,
+    CAMP_MEMORIE,
+    CAMP_UTILIZATOR,
+    CAMP_MESAJ,
+    CAMP_NIVEL,
+    CAMP_TIMESTAMP,
+    CAMP_HOSTNAME,
+    CAMP_TIP,
+    CAMP_PROCESE,
+    CAMP_ELIMINATE,
+    CAMP_SCHEMA_BINARA,
+    CAMP_COMPRESIE,
+    NUMAR_CAMPURI_JSON
+} CampJson;
+
+/* O cheie cunoscuta. Cand mai multe chei dau acelasi camp, castiga cea
+ * cu prioritatea mai mica (ex: "name" = 0 inaintea lui "app" = 1). */
+typedef struct {
+    const char* nume;
+    unsigned char lungime;
+    unsigned char camp;
+    unsigned char prioritate;
+} CheieJson;
+
+/*
+ * Hash-ul unei chei: al doilea caracter + ultimul + 24 * lungimea, modulo
+ * 64. Pentru cheile de mai jos nu exista doua cu acelasi hash (hash
+ * "perfect"), asa ca o cheie se gaseste dintr-o singura incercare. Daca
+ * adaugi o cheie si se ciocneste cu alta, compilatorul avertizeaza
+ * (-Woverride-init) - atunci trebuie ales alt multiplicator.
+ */
+#define MARIME_TABEL_CHEI 64
+#define HASH_CHEIE(al_doilea, ultimul, lungime) \
+    (((unsigned int)(al_doilea) + (unsigned int)(ultimul) + 24u * (unsigned int)(lungime)) \
+     & (MARIME_TABEL_CHEI - 1))
+
+static const CheieJson g_chei_json[MARIME_TABEL_CHEI] = {
+    [HASH_CHEIE('i', 'd', 3)]  = { "pid",         3,  CAMP_PID,        0 },
+    [HASH_CHEIE('a', 'e', 4)]  = { "name",        4,  CAMP_NUME,       0 },
+    [HASH_CHEIE('p', 'p', 3)]  = { "app",         3,  CAMP_NUME,       1 },
+    [HASH_CHEIE('r', 's', 7)]  = { "process",     7,  CAMP_NUME,       2 },
+    [HASH_CHEIE('l', 'e', 11)] = { "client_name", 11, CAMP_NUME,       3 },
+    [HASH_CHEIE('t', 's', 6)]  = { "status",      6,  CAMP_STATUS,     0 },
+    [HASH_CHEIE('p', 't', 11)] = { "cpu_percent", 11, CAMP_CPU,        0 },
+    [HASH_CHEIE('e', 'b', 9)]  = { "memory_kb",   9,  CAMP_MEMORIE,    0 },
+    [HASH_CHEIE('s', 'r', 4)]  = { "user",        4,  CAMP_UTILIZATOR, 0 },
+    [HASH_CHEIE('o', 'e', 6)]  = { "source",      6,  CAMP_UTILIZATOR, 1 },
+    [HASH_CHEIE('e', 'e', 7)]  = { "message",     7,  CAMP_MESAJ,      0 },
+    [HASH_CHEIE('e', 'l', 5)]  = { "level",       5,  CAMP_NIVEL,      0 },
+    [HASH_CHEIE('o', 'l', 9)]  = { "log_level",   9,  CAMP_NIVEL,      1 },
+    [HASH_CHEIE('i', 'p', 9)]  = { "timestamp",   9,  CAMP_TIMESTAMP,  0 },
+    [HASH_CHEIE('i', 'e', 4)]  = { "time",        4,  CAMP_TIMESTAMP,  1 },
+    [HASH_CHEIE('o', 'e', 8)]  = { "hostname",    8,  CAMP_HOSTNAME,   0 },
+    [HASH_CHEIE('y', 'e', 4)]  = { "type",        4,  CAMP_TIP,        0 },
+    [HASH_CHEIE('r', 's', 9)]  = { "processes",   9,  CAMP_PROCESE,    0 },
+    [HASH_CHEIE('e', 's', 12)] = { "removed_pids", 12, CAMP_ELIMINATE, 0 },
+    [HASH_CHEIE('i', 'a', 13)] = { "binary_schema", 13, CAMP_SCHEMA_BINARA, 0 },
+    [HASH_CHEIE('o', 'n', 11)] = { "compression", 11, CAMP_COMPRESIE, 0 },
+};
+
+/* Prioritatea unui camp pe care inca nu l-am gasit */
+#define PRIORITATE_NEGASIT 255
+
+/* Un text din JSON: unde incepe si cat de lung e (fara ghilimele) */
+typedef struct {
+    const char* inceput;
+    size_t lungime;
+    int prioritate;
+} ValoareText;
+
+/* Tot ce am gasit intr-un obiect JSON */
+typedef struct {
+    ValoareText texte[NUMAR_CAMPURI_JSON];  /* Doar campurile text */
+    long pid;
+    double procent_cpu;
+    long memorie_kb;
+    long timestamp_numeric;                 /* 0 = nu a venit ca numar */
+    long schema_binara;                     /* Din HELLO, 0 = lipseste */
+    int are_pid, are_cpu, are_memorie;
+    const char* procese;                    /* '[' listei de procese, sau NULL */
+    const char* eliminate;                  /* '[' listei "removed_pids", sau NULL */
+} CampuriJson;
+
+/* Ce stie obiectul de pe primul nivel (mesajul) cand da peste
+ * "processes" - ca sa parseze procesele pe loc */
+typedef struct {
+    const char* ip_client;
+    int64_t primit_ns;          /* Cand a sosit mesajul (acelasi pentru toate procesele) */
+    int procese_parsate;        /* 1 = le-am parsat deja (hostname-ul era cunoscut) */
+    int numar_procese;
+    TipSnapshot tip;            /* Cadru complet / delta: procesele trec prin starea host-ului */
+    StareGazda* gazda;          /* Starea host-ului, blocata cat parsam mesajul (sau NULL) */
+} ContextMesaj;
+
+
 /*
  * -----------------------------------------------------------------------------
- * IMPLEMENTARE: parseaza_json_proces
+ * FUNCTIE HELPER: cauta_cheie
  * -----------------------------------------------------------------------------
- * 
- * Aceasta functie e "inima" parser-ului. Ia un JSON cu datele unui proces
- * si umple structura LogEntry.
+ * O cheie din JSON -> intrarea ei din tabel, sau NULL daca nu o cunoastem.
+ * Un singur hash, o singura comparatie.
  */
-int parseaza_json_proces(const char* json, LogEntry* intrare, const char* ip_client) {
-    /*
-     * Pas 1: Initializam structura cu zerouri
-     * memset() pune valoarea 0 pe toti octetii structurii
-     * Asta ne asigura ca toate campurile sunt initializate
-     */
-    memset(intrare, 0, sizeof(LogEntry));
-    
-    /*
-     * Pas 2: Verificam ca JSON-ul e valid (incepe cu '{')
-     */
-    const char* json_curatat = json;
-    
-    /* Sarim peste spatii de la inceput */
-    while (*json_curatat && isspace(*json_curatat)) {
-        json_curatat++;
+static const CheieJson* cauta_cheie(const char* cheie, size_t lungime) {
+    if (lungime < 2 || lungime > 255) {
+        return NULL;
     }
-    
-    /* JSON-ul trebuie sa inceapa cu '{' */
-    if (*json_curatat != '{') {
-        return 0;  /* JSON invalid */
+
+    const CheieJson* intrare = &g_chei_json[HASH_CHEIE(cheie[1], cheie[lungime - 1], lungime)];
+
+    if (intrare->nume == NULL || intrare->lungime != lungime ||
+        memcmp(intrare->nume, cheie, lungime) != 0) {
+        return NULL;
     }
-    
-    /*
-     * Pas 2.5: Verificam daca e mesaj de control (HELLO, GOODBYE)
-     * Clientii trimit aceste mesaje la conectare/deconectare.
-     * Nu sunt loguri de procese, deci le ignoram.
-     */
-    char tip_mesaj[64] = "";
-    json_extrage_string(json, "type", tip_mesaj, sizeof(tip_mesaj));
-    
-    if (strlen(tip_mesaj) > 0) {
-        /* E un mesaj de control, nu un log de proces */
-        transforma_in_majuscule(tip_mesaj);
-        
-        if (strcmp(tip_mesaj, "HELLO") == 0 || 
-            strcmp(tip_mesaj, "GOODBYE") == 0 ||
-            strcmp(tip_mesaj, "PING") == 0 ||
-            strcmp(tip_mesaj, "PONG") == 0) {
-            /* Ignoram aceste mesaje - nu sunt loguri */
-            return 0;
+    return intrare;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII HELPER: sari_spatii / citeste_sir / sari_valoare
+ * -----------------------------------------------------------------------------
+ * Tokenizer-ul propriu-zis. Toate primesc pozitia curenta si intorc
+ * pozitia de dupa ce au citit, sau NULL daca JSON-ul e gresit.
+ *
+ * Prin interiorul string-urilor si al valorilor sarite nu mergem octet cu
+ * octet: urmatorul_structural() gaseste cu SIMD urmatoarea ghilimea,
+ * backslash, acolada sau paranteza.
+ */
+static const char* sari_spatii(const char* pozitie) {
+    while (*pozitie == ' ' || *pozitie == '\t' || *pozitie == '\n' || *pozitie == '\r') {
+        pozitie++;
+    }
+    return pozitie;
+}
+
+/* pozitie = ghilimelele de deschidere. Escape-urile (\" etc.) raman in
+ * text asa cum au venit, ca si pana acum. */
+static const char* citeste_sir(const char* pozitie, const char** inceput, size_t* lungime) {
+    pozitie++;
+    *inceput = pozitie;
+
+    /* Sarim direct la urmatorul caracter care ne intereseaza */
+    while (*(pozitie = urmatorul_structural(pozitie)) != '"') {
+        if (*pozitie == '\0') {
+            return NULL;
         }
+        if (*pozitie == '\\' && pozitie[1] != '\0') {
+            pozitie++;
+        }
+        pozitie++;
     }
-    
-    /*
-     * Pas 3: Extragem fiecare camp
-     * Incercam mai multe variante de nume pentru flexibilitate
-     */
-    
-    /* --- PID --- */
-    intrare->pid = json_extrage_int(json, "pid");
-    
-    /* --- NUME PROCES --- */
-    /* Incercam: "name", "app", "process", "client_name" (pentru compatibilitate) */
-    json_extrage_string(json, "name", intrare->nume, sizeof(intrare->nume));
-    if (strlen(intrare->nume) == 0) {
-        json_extrage_string(json, "app", intrare->nume, sizeof(intrare->nume));
+
+    *lungime = (size_t)(pozitie - *inceput);
+    return pozitie + 1;
+}
+
+/* Sare peste orice valoare: text, numar, true/false/null, obiect sau lista
+ * (cu tot ce e in ele - acoladele din texte nu se numara) */
+static const char* sari_valoare(const char* pozitie) {
+    const char* inceput;
+    size_t lungime;
+
+    if (*pozitie == '"') {
+        return citeste_sir(pozitie, &inceput, &lungime);
     }
-    if (strlen(intrare->nume) == 0) {
-        json_extrage_string(json, "process", intrare->nume, sizeof(intrare->nume));
+
+    if (*pozitie == '{' || *pozitie == '[') {
+        int adancime = 0;
+
+        do {
+            pozitie = urmatorul_structural(pozitie);
+
+            if (*pozitie == '"') {
+                pozitie = citeste_sir(pozitie, &inceput, &lungime);
+                if (pozitie == NULL) {
+                    return NULL;
+                }
+                continue;
+            }
+            if (*pozitie == '{' || *pozitie == '[') {
+                adancime++;
+            } else if (*pozitie == '}' || *pozitie == ']') {
+                adancime--;
+            } else if (*pozitie == '\0') {
+                return NULL;
+            }
+            pozitie++;
+        } while (adancime > 0);
+
+        return pozitie;
     }
-    if (strlen(intrare->nume) == 0) {
-        json_extrage_string(json, "client_name", intrare->nume, sizeof(intrare->nume));
+
+    /* Numar sau literal: pana la urmatorul separator */
+    while (*pozitie != '\0' && *pozitie != ',' && *pozitie != '}' && *pozitie != ']' &&
+           *pozitie != ' ' && *pozitie != '\t' && *pozitie != '\n' && *pozitie != '\r') {
+        pozitie++;
     }
-    if (strlen(intrare->nume) == 0) {
-        /* Valoare default daca nu gasim nimic */
-        strncpy(intrare->nume, "unknown", sizeof(intrare->nume));
+    return pozitie;
+}
+
+
+static const char* parseaza_obiect(const char* pozitie, CampuriJson* campuri,
+                                   ContextMesaj* context);
+static const char* parseaza_procese_mesaj(const char* pozitie, const CampuriJson* campuri,
+                                          ContextMesaj* context);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: pune_valoare
+ * -----------------------------------------------------------------------------
+ * Pune valoarea care incepe la 'pozitie' in campul cheii si intoarce
+ * pozitia de dupa ea.
+ */
+static const char* pune_valoare(const char* pozitie, const CheieJson* cheie,
+                                CampuriJson* campuri, ContextMesaj* context) {
+    if (cheie == NULL) {
+        return sari_valoare(pozitie);  /* Cheie necunoscuta */
     }
-    
-    /* --- STATUS --- */
-    json_extrage_string(json, "status", intrare->status, sizeof(intrare->status));
-    if (strlen(intrare->status) == 0) {
-        strncpy(intrare->status, "static", sizeof(intrare->status));
+
+    /* --- Valoare text --- */
+    if (*pozitie == '"') {
+        const char* inceput;
+        size_t lungime;
+        const char* dupa = citeste_sir(pozitie, &inceput, &lungime);
+
+        /* Un text gol conteaza ca lipsa (incercam urmatoarea cheie) */
+        ValoareText* text = &campuri->texte[cheie->camp];
+        if (dupa != NULL && lungime > 0 && cheie->prioritate < text->prioritate) {
+            text->inceput = inceput;
+            text->lungime = lungime;
+            text->prioritate = cheie->prioritate;
+        }
+        return dupa;
     }
-    
-    /* --- CPU SI MEMORIE --- */
-    intrare->procent_cpu = json_extrage_double(json, "cpu_percent");
-    intrare->memorie_kb = json_extrage_long(json, "memory_kb");
-    
-    /* --- UTILIZATOR --- */
-    json_extrage_string(json, "user", intrare->utilizator, sizeof(intrare->utilizator));
-    if (strlen(intrare->utilizator) == 0) {
-        json_extrage_string(json, "source", intrare->utilizator, sizeof(intrare->utilizator));
+
+    /* --- Valoare numerica (prima aparitie castiga) --- */
+    switch (cheie->camp) {
+        case CAMP_PID:
+            if (!campuri->are_pid) {
+                campuri->pid = strtol(pozitie, NULL, 10);
+                campuri->are_pid = 1;
+            }
+            break;
+
+        case CAMP_CPU:
+            if (!campuri->are_cpu) {
+                campuri->procent_cpu = strtod(pozitie, NULL);
+                campuri->are_cpu = 1;
+            }
+            break;
+
+        case CAMP_MEMORIE:
+            if (!campuri->are_memorie) {
+                campuri->memorie_kb = strtol(pozitie, NULL, 10);
+                campuri->are_memorie = 1;
+            }
+            break;
+
+        case CAMP_TIMESTAMP:
+            /* Doar "timestamp" poate veni ca numar Unix, nu si "time" */
+            if (cheie->prioritate == 0 && campuri->timestamp_numeric == 0) {
+                campuri->timestamp_numeric = strtol(pozitie, NULL, 10);
+            }
+            break;
+
+        case CAMP_PROCESE:
+            if (*pozitie == '[' && campuri->procese == NULL) {
+                campuri->procese = pozitie;
+
+                /*
+                 * Daca stim deja hostname-ul snapshot-ului (clientul nostru
+                 * il pune primul, impreuna cu "type"), parsam procesele
+                 * chiar acum. Altfel le parsam la sfarsit, cand il aflam.
+                 */
+                if (context != NULL && campuri->texte[CAMP_HOSTNAME].prioritate != PRIORITATE_NEGASIT) {
+                    context->procese_parsate = 1;
+                    return parseaza_procese_mesaj(pozitie, campuri, context);
+                }
+            }
+            break;
+
+        case CAMP_SCHEMA_BINARA:
+            if (campuri->schema_binara == 0) {
+                campuri->schema_binara = strtol(pozitie, NULL, 10);
+            }
+            break;
+
+        case CAMP_ELIMINATE:
+            /* Le aplicam dupa procese, la sfarsitul mesajului */
+            if (*pozitie == '[' && campuri->eliminate == NULL) {
+                campuri->eliminate = pozitie;
+            }
+            break;
+
+        default:
+            break;
     }
-    if (strlen(intrare->utilizator) == 0) {
-        strncpy(intrare->utilizator, "system", sizeof(intrare->utilizator));
+
+    return sari_valoare(pozitie);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: parseaza_obiect
+ * -----------------------------------------------------------------------------
+ * Parcurge o singura data un obiect { "cheie": valoare, ... } si pune
+ * valorile cheilor cunoscute in 'campuri'. Se uita doar la cheile de pe
+ * nivelul obiectului - obiectele si listele din el sunt sarite, iar
+ * textele nu sunt niciodata confundate cu chei.
+ *
+ * pozitie = acolada de deschidere. Intoarce pozitia de dupa acolada de
+ * inchidere, sau NULL daca JSON-ul e gresit.
+ */
+static const char* parseaza_obiect(const char* pozitie, CampuriJson* campuri,
+                                   ContextMesaj* context) {
+    memset(campuri, 0, sizeof(*campuri));
+    for (int i = 0; i < NUMAR_CAMPURI_JSON; i++) {
+        campuri->texte[i].prioritate = PRIORITATE_NEGASIT;
     }
-    
-    /* --- MESAJ --- */
-    json_extrage_string(json, "message", intrare->mesaj, sizeof(intrare->mesaj));
-    if (strlen(intrare->mesaj) == 0) {
-        strncpy(intrare->mesaj, "Functional", sizeof(intrare->mesaj));
+
+    pozitie = sari_spatii(pozitie + 1);
+    if (*pozitie == '}') {
+        return pozitie + 1;  /* Obiect gol */
     }
-    
+
+    while (1) {
+        /* Pas 1: Cheia */
+        const char* cheie;
+        size_t lungime_cheie;
+
+        if (*pozitie != '"') {
+            return NULL;
+        }
+        pozitie = citeste_sir(pozitie, &cheie, &lungime_cheie);
+        if (pozitie == NULL) {
+            return NULL;
+        }
+
+        /* Pas 2: ':' */
+        pozitie = sari_spatii(pozitie);
+        if (*pozitie != ':') {
+            return NULL;
+        }
+        pozitie = sari_spatii(pozitie + 1);
+
+        /* Pas 3: Valoarea, direct in campul ei */
+        pozitie = pune_valoare(pozitie, cauta_cheie(cheie, lungime_cheie), campuri, context);
+        if (pozitie == NULL) {
+            return NULL;
+        }
+
+        /* Pas 4: ',' = mai urmeaza o cheie, '}' = gata */
+        pozitie = sari_spatii(pozitie);
+        if (*pozitie == '}') {
+            return pozitie + 1;
+        }
+        if (*pozitie != ',') {
+            return NULL;
+        }
+        pozitie = sari_spatii(pozitie + 1);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: simbol_camp
+ * -----------------------------------------------------------------------------
+ * Interneaza textul unui camp (taiat la 'maxim' caractere, ca pana acum),
+ * sau textul implicit daca campul lipseste.
+ */
+static IdSimbol simbol_camp(const ValoareText* text, size_t maxim, const char* implicit) {
+    if (text->prioritate == PRIORITATE_NEGASIT) {
+        return interneaza(implicit);
+    }
+    return interneaza_n(text->inceput, text->lungime < maxim ? text->lungime : maxim);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: este_mesaj_control
+ * -----------------------------------------------------------------------------
+ * HELLO, GOODBYE, PING, PONG (cu orice fel de litere) nu sunt loguri.
+ */
+static int este_mesaj_control(const ValoareText* tip) {
+    static const char* const tipuri[] = { "HELLO", "GOODBYE", "PING", "PONG" };
+
+    if (tip->prioritate == PRIORITATE_NEGASIT) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < sizeof(tipuri) / sizeof(tipuri[0]); i++) {
+        if (strlen(tipuri[i]) == tip->lungime &&
+            strncasecmp(tipuri[i], tip->inceput, tip->lungime) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: completeaza_intrare
+ * -----------------------------------------------------------------------------
+ * Din campurile gasite face un LogEntry, cu valorile implicite pentru
+ * cele lipsa.
+ *
+ * RETURNEAZA:
+ *     1 daca e un log, 0 daca e un mesaj de control
+ */
+static int completeaza_intrare(const CampuriJson* campuri, LogEntry* intrare,
+                               const char* ip_client, int64_t primit_ns) {
+    memset(intrare, 0, sizeof(LogEntry));
+
+    /*
+     * Mesajele de control (HELLO, GOODBYE, PING, PONG) le trimit clientii
+     * la conectare/deconectare. Nu sunt loguri de procese, deci le ignoram.
+     */
+    if (este_mesaj_control(&campuri->texte[CAMP_TIP])) {
+        return 0;
+    }
+
+    /* --- Numere --- */
+    intrare->pid = (int)campuri->pid;
+    intrare->procent_cpu = campuri->procent_cpu;
+    intrare->memorie_kb = (unsigned long)campuri->memorie_kb;
+
+    /* --- Texte (cu valorile implicite de pana acum) --- */
+    intrare->nume = simbol_camp(&campuri->texte[CAMP_NUME], LUNGIME_CAMP - 1, "unknown");
+    intrare->status = simbol_camp(&campuri->texte[CAMP_STATUS], LUNGIME_CAMP - 1, "static");
+    intrare->utilizator = simbol_camp(&campuri->texte[CAMP_UTILIZATOR], LUNGIME_CAMP - 1, "system");
+    intrare->mesaj = simbol_camp(&campuri->texte[CAMP_MESAJ], LUNGIME_CAMP * 2 - 1, "Functional");
+    intrare->hostname = simbol_camp(&campuri->texte[CAMP_HOSTNAME], LUNGIME_CAMP - 1, "");
+    intrare->ip_client = interneaza_adresa(ip_client, &intrare->port_client);
+
+    intrare->cod_status = cod_status(text_simbol(intrare->status));
+
     /* --- NIVEL (INFO/WARN/ERROR) --- */
-    /* Clientii pot trimite "level" sau "log_level" - acceptam ambele */
-    json_extrage_string(json, "level", intrare->nivel, sizeof(intrare->nivel));
-    if (strlen(intrare->nivel) == 0) {
-        json_extrage_string(json, "log_level", intrare->nivel, sizeof(intrare->nivel));
+    if (campuri->texte[CAMP_NIVEL].prioritate != PRIORITATE_NEGASIT) {
+        IdSimbol nivel = simbol_camp(&campuri->texte[CAMP_NIVEL], LUNGIME_CAMP - 1, "");
+        intrare->cod_nivel = cod_nivel(text_simbol(nivel));
+
+        /* Il pastram cu litere mari */
+        intrare->nivel = majuscule_simbol(nivel);
     }
-    
-    if (strlen(intrare->nivel) == 0) {
+    else {
         /*
          * Daca nivelul nu e specificat, il deducem din status si metrici
          */
-        char status_mare[32];
-        strncpy(status_mare, intrare->status, sizeof(status_mare));
-        transforma_in_majuscule(status_mare);
-        
-        if (strcmp(status_mare, "CRASHED") == 0 || strcmp(status_mare, "ZOMBIE") == 0) {
-            /* Proces mort = ERROR */
-            strncpy(intrare->nivel, "ERROR", sizeof(intrare->nivel));
-        } 
-        else if (intrare->procent_cpu > 80.0 || intrare->memorie_kb > 1024 * 1024) {
-            /* CPU > 80% sau memorie > 1GB = WARNING */
-            strncpy(intrare->nivel, "WARN", sizeof(intrare->nivel));
-        } 
-        else {
-            /* Altfel = INFO */
-            strncpy(intrare->nivel, "INFO", sizeof(intrare->nivel));
-        }
+        intrare->cod_nivel = deduce_nivel(intrare->cod_status, intrare->procent_cpu,
+                                          intrare->memorie_kb);
+        intrare->nivel = interneaza(nume_nivel(intrare->cod_nivel));
     }
-    
-    /* Ne asiguram ca nivelul e uppercase */
-    transforma_in_majuscule(intrare->nivel);
-    
+
     /* --- TIMESTAMP --- */
     /* Clientii pot trimite timestamp ca:
-     * - String: "2024-01-15 14:30:00"
+     * - String ISO: "2024-01-15 14:30:00" (cheia "timestamp" sau "time")
      * - Numar Unix: 1705324200
-     * Acceptam ambele formate */
-    json_extrage_string(json, "timestamp", intrare->timestamp, sizeof(intrare->timestamp));
-    if (strlen(intrare->timestamp) == 0) {
-        json_extrage_string(json, "time", intrare->timestamp, sizeof(intrare->timestamp));
-    }
-    if (strlen(intrare->timestamp) == 0) {
-        /* Verificam daca e timestamp numeric (Unix timestamp) */
-        long unix_time = json_extrage_long(json, "timestamp");
-        if (unix_time > 0) {
-            /* Convertim Unix timestamp in format citibil */
-            time_t raw_time = (time_t)unix_time;
-            struct tm* timp_local = localtime(&raw_time);
-            if (timp_local != NULL) {
-                strftime(intrare->timestamp, sizeof(intrare->timestamp), 
-                         "%Y-%m-%d %H:%M:%S", timp_local);
-            } else {
-                /* Daca conversia esueaza, punem timpul curent */
-                obtine_timpul_curent(intrare->timestamp, sizeof(intrare->timestamp));
+     * Acceptam ambele formate. Il pastram ca numar - textul il facem
+     * doar cand il afisam. */
+    const ValoareText* timp = &campuri->texte[CAMP_TIMESTAMP];
+
+    intrare->primit_ns = primit_ns;
+    intrare->timestamp_ns = primit_ns;  /* Daca nu avem timestamp (sau e stricat), punem timpul primirii */
+
+    if (timp->prioritate != PRIORITATE_NEGASIT) {
+        parseaza_timp_iso(timp->inceput, timp->lungime, &intrare->timestamp_ns);
+    }
+    else if (campuri->timestamp_numeric > 0) {
+        intrare->timestamp_ns = (int64_t)campuri->timestamp_numeric * NS_PE_SECUNDA;
+    }
+
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: campuri_trimise
+ * -----------------------------------------------------------------------------
+ * Ce campuri au venit de fapt in obiect (TRIMIS_*) - o delta poate lasa
+ * deoparte ce nu s-a schimbat.
+ */
+static unsigned int campuri_trimise(const CampuriJson* campuri) {
+    unsigned int trimise = 0;
+
+    if (campuri->texte[CAMP_NUME].prioritate != PRIORITATE_NEGASIT)       trimise |= TRIMIS_NUME;
+    if (campuri->texte[CAMP_UTILIZATOR].prioritate != PRIORITATE_NEGASIT) trimise |= TRIMIS_UTILIZATOR;
+    if (campuri->texte[CAMP_STATUS].prioritate != PRIORITATE_NEGASIT)     trimise |= TRIMIS_STATUS;
+    if (campuri->texte[CAMP_NIVEL].prioritate != PRIORITATE_NEGASIT)      trimise |= TRIMIS_NIVEL;
+    if (campuri->texte[CAMP_MESAJ].prioritate != PRIORITATE_NEGASIT)      trimise |= TRIMIS_MESAJ;
+    if (campuri->are_cpu)     trimise |= TRIMIS_CPU;
+    if (campuri->are_memorie) trimise |= TRIMIS_MEMORIE;
+
+    return trimise;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: parseaza_lista_procese
+ * -----------------------------------------------------------------------------
+ * pozitie = '[' listei "processes". Fiecare obiect din lista e parsat pe
+ * loc (fara copie) si pus in lotul thread-ului; context->numar_procese
+ * spune cate. Intr-un cadru complet sau o delta, fiecare proces e
+ * completat din (si pastrat in) starea host-ului.
+ *
+ * RETURNEAZA:
+ *     Pozitia de dupa ']', sau NULL daca JSON-ul e gresit (procesele
+ *     dinainte de greseala raman adaugate)
+ */
+static const char* parseaza_lista_procese(const char* pozitie, IdSimbol hostname,
+                                          ContextMesaj* context) {
+    context->numar_procese = 0;
+
+    pozitie = sari_spatii(pozitie + 1);
+
+    while (*pozitie != ']') {
+        if (*pozitie == '\0') {
+            return NULL;
+        }
+
+        if (*pozitie == '{') {
+            CampuriJson campuri;
+            LogEntry intrare;
+
+            pozitie = parseaza_obiect(pozitie, &campuri, NULL);
+            if (pozitie == NULL) {
+                return NULL;  /* JSON gresit - ne oprim aici */
+            }
+
+            if (completeaza_intrare(&campuri, &intrare, context->ip_client, context->primit_ns)) {
+                /* Daca nu are hostname, il punem pe cel din snapshot */
+                if (intrare.hostname == SIMBOL_GOL) {
+                    intrare.hostname = hostname;
+                }
+
+                if (context->gazda != NULL) {
+                    actualizeaza_proces(context->gazda, &intrare, campuri_trimise(&campuri));
+                }
+                
+                /*
+                 * Il adunam in lotul thread-ului; tot snapshot-ul intra
+                 * in coada dintr-o data, la sfarsit (vezi coada_loguri.h)
+                 */
+                adauga_in_lot(&intrare);
+                context->numar_procese++;
             }
         } else {
-            /* Daca nu avem timestamp deloc, punem timpul curent */
-            obtine_timpul_curent(intrare->timestamp, sizeof(intrare->timestamp));
+            /* Altceva decat un obiect - il sarim */
+            pozitie = sari_valoare(pozitie);
+            if (pozitie == NULL) {
+                return NULL;
+            }
+        }
+
+        /* Sarim peste spatii si virgule dintre elemente */
+        pozitie = sari_spatii(pozitie);
+        if (*pozitie == ',') {
+            pozitie = sari_spatii(pozitie + 1);
         }
     }
-    
-    /* --- HOSTNAME --- */
-    json_extrage_string(json, "hostname", intrare->hostname, sizeof(intrare->hostname));
-    
-    /* --- IP CLIENT --- */
-    strncpy(intrare->ip_client, ip_client, sizeof(intrare->ip_client));
-    
-    return 1;  /* Succes! */
+
+    return pozitie + 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: deschide_gazda_mesaj
+ * -----------------------------------------------------------------------------
+ * Un cadru complet sau o delta de la un host cunoscut: deschidem starea
+ * host-ului (o singura data pe mesaj). Mesajele fara "type" nu o ating.
+ */
+static void deschide_gazda_mesaj(const CampuriJson* campuri, IdSimbol hostname,
+                                 ContextMesaj* context) {
+    const ValoareText* tip = &campuri->texte[CAMP_TIP];
+
+    if (context->gazda != NULL || hostname == SIMBOL_GOL ||
+        tip->prioritate == PRIORITATE_NEGASIT) {
+        return;
+    }
+
+    context->tip = tip_snapshot(tip->inceput, tip->lungime);
+    if (context->tip != SNAPSHOT_SIMPLU) {
+        context->gazda = deschide_stare_gazda(hostname, context->tip);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: parseaza_procese_mesaj
+ * -----------------------------------------------------------------------------
+ * pozitie = '[' listei "processes" a mesajului; campuri = ce stim pana
+ * acum despre mesaj (hostname-ul si tipul lui).
+ */
+static const char* parseaza_procese_mesaj(const char* pozitie, const CampuriJson* campuri,
+                                          ContextMesaj* context) {
+    IdSimbol hostname = simbol_camp(&campuri->texte[CAMP_HOSTNAME], LUNGIME_CAMP - 1, "");
+
+    deschide_gazda_mesaj(campuri, hostname, context);
+    return parseaza_lista_procese(pozitie, hostname, context);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: aplica_eliminari
+ * -----------------------------------------------------------------------------
+ * pozitie = '[' listei "removed_pids": procesele disparute ies din starea
+ * host-ului. Nu fac loguri.
+ */
+static void aplica_eliminari(const char* pozitie, StareGazda* gazda) {
+    pozitie = sari_spatii(pozitie + 1);
+
+    while (*pozitie != ']' && *pozitie != '\0') {
+        char* dupa;
+        long pid = strtol(pozitie, &dupa, 10);
+
+        if (dupa == pozitie) {
+            /* Nu e un numar - il sarim */
+            pozitie = sari_valoare(pozitie);
+            if (pozitie == NULL) {
+                return;
+            }
+        } else {
+            elimina_proces(gazda, (int)pid);
+            pozitie = dupa;
+        }
+
+        pozitie = sari_spatii(pozitie);
+        if (*pozitie == ',') {
+            pozitie = sari_spatii(pozitie + 1);
+        }
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: parseaza_radacina
+ * -----------------------------------------------------------------------------
+ * Parseaza obiectul de pe primul nivel al unui mesaj. Daca are lista
+ * "processes", procesele ajung in lotul thread-ului si
+ * context->numar_procese spune cate au fost. Un cadru complet sau o
+ * delta actualizeaza si starea host-ului (vezi stare_gazde.h).
+ *
+ * RETURNEAZA:
+ *     1 daca JSON-ul e un obiect valid, 0 altfel
+ */
+static int parseaza_radacina(const char* json, ContextMesaj* context, CampuriJson* campuri) {
+    const char* pozitie = sari_spatii(json);
+    int valid = 0;
+
+    campuri->procese = NULL;
+    campuri->eliminate = NULL;
+
+    /* JSON-ul trebuie sa inceapa cu '{' */
+    if (*pozitie != '{') {
+        return 0;
+    }
+
+    /* Daca e gresit, procesele parsate inainte de greseala raman in lot */
+    if (parseaza_obiect(pozitie, campuri, context) != NULL) {
+        valid = 1;
+
+        /* Hostname-ul a venit dupa lista - abia acum putem parsa procesele */
+        if (campuri->procese != NULL && !context->procese_parsate) {
+            parseaza_procese_mesaj(campuri->procese, campuri, context);
+        }
+
+        /* Procesele disparute (clientul nu pune un PID in ambele liste) */
+        if (campuri->eliminate != NULL) {
+            deschide_gazda_mesaj(campuri,
+                                 simbol_camp(&campuri->texte[CAMP_HOSTNAME], LUNGIME_CAMP - 1, ""),
+                                 context);
+            if (context->gazda != NULL) {
+                aplica_eliminari(campuri->eliminate, context->gazda);
+            }
+        }
+    }
+
+    /* Starea host-ului a fost blocata cat am parsat mesajul. Dintr-un
+     * cadru complet stricat nu stergem nimic - nu stim ce lipsea. */
+    if (context->gazda != NULL) {
+        inchide_stare_gazda(context->gazda, valid ? context->tip : SNAPSHOT_DELTA);
+        context->gazda = NULL;
+    }
+
+    return valid;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: parseaza_json_proces
+ * -----------------------------------------------------------------------------
+ * 
+ * Aceasta functie e "inima" parser-ului. Ia un JSON cu datele unui proces
+ * si umple structura LogEntry.
+ */
+int parseaza_json_proces(const char* json, LogEntry* intrare, const char* ip_client) {
+    CampuriJson campuri;
+    const char* pozitie = sari_spatii(json);
+
+    memset(intrare, 0, sizeof(LogEntry));
+
+    if (*pozitie != '{' || parseaza_obiect(pozitie, &campuri, NULL) == NULL) {
+        return 0;  /* JSON invalid */
+    }
+
+    return completeaza_intrare(&campuri, intrare, ip_client, timp_curent_ns());
 }
 
 
@@ -342,122 +919,75 @@ int parseaza_json_proces(const char* json, LogEntry* intrare, const char* ip_cli
  * Aceasta functie parseaza lista si adauga fiecare proces in lista globala.
  */
 int parseaza_json_snapshot(const char* json, const char* ip_client) {
-    /* 
-     * Extragem hostname-ul din snapshot 
-     * (toate procesele din snapshot au acelasi hostname)
-     */
-    char hostname[LUNGIME_CAMP] = "";
-    json_extrage_string(json, "hostname", hostname, sizeof(hostname));
-    
-    /*
-     * Gasim inceputul array-ului de procese
-     * Cautam: "processes": [
-     */
-    char* inceput_procese = strstr(json, "\"processes\"");
-    if (inceput_procese == NULL) {
-        return 0;  /* Nu am gasit array-ul */
+    CampuriJson campuri;
+    ContextMesaj context = { ip_client, timp_curent_ns(), 0, 0, SNAPSHOT_SIMPLU, NULL };
+
+    parseaza_radacina(json, &context, &campuri);
+    trimite_lotul();
+
+    return context.numar_procese;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: parseaza_mesaj_json
+ * -----------------------------------------------------------------------------
+ */
+int parseaza_mesaj_json(const char* json, const char* ip_client) {
+    CampuriJson campuri;
+    ContextMesaj context = { ip_client, timp_curent_ns(), 0, 0, SNAPSHOT_SIMPLU, NULL };
+
+    int valid = parseaza_radacina(json, &context, &campuri);
+
+    /* Snapshot: procesele sunt deja in lot, le trimitem pe toate odata
+     * (o delta poate avea doar "removed_pids" - fara niciun log) */
+    if (campuri.procese != NULL || campuri.eliminate != NULL) {
+        trimite_lotul();
+        return context.numar_procese;
     }
-    
-    /* Cautam paranteza patrata de deschidere '[' */
-    char* inceput_array = strchr(inceput_procese, '[');
-    if (inceput_array == NULL) {
+
+    if (!valid) {
+        return 0;  /* JSON invalid */
+    }
+
+    /* Un singur proces - il adunam in lotul thread-ului, pleaca in coada
+     * impreuna cu celelalte mesaje din acelasi recv */
+    LogEntry intrare;
+    if (!completeaza_intrare(&campuri, &intrare, ip_client, context.primit_ns)) {
         return 0;
     }
-    
-    /*
-     * Parcurgem array-ul si extragem fiecare obiect JSON
-     */
-    char* pozitie = inceput_array + 1;  /* Dupa '[' */
-    int numar_procese = 0;
-    
-    while (*pozitie) {
-        /* Sarim peste spatii si virgule */
-        while (*pozitie && isspace(*pozitie)) pozitie++;
-        
-        /* Verificam daca am ajuns la sfarsitul array-ului */
-        if (*pozitie == ']') break;
-        
-        /* Sarim peste virgule dintre elemente */
-        if (*pozitie == ',') { 
-            pozitie++; 
-            continue; 
-        }
-        
-        /* Verificam daca incepe un obiect */
-        if (*pozitie == '{') {
-            /*
-             * Gasim sfarsitul obiectului numarand acoladele
-             * Trebuie sa tinem cont de acoladele imbricate
-             */
-            int adancime = 1;  /* Am intrat intr-o acolada */
-            char* inceput_obiect = pozitie;
-            pozitie++;  /* Trecem de '{' */
-            
-            while (*pozitie && adancime > 0) {
-                if (*pozitie == '{') {
-                    adancime++;  /* Am intrat in alta acolada */
-                }
-                else if (*pozitie == '}') {
-                    adancime--;  /* Am iesit dintr-o acolada */
-                }
-                pozitie++;
-            }
-            
-            /*
-             * Acum avem obiectul JSON intre inceput_obiect si pozitie
-             * Il copiem intr-un buffer separat pentru parsare
-             */
-            size_t lungime_obiect = pozitie - inceput_obiect;
-            char* obiect = malloc(lungime_obiect + 1);
-            
-            if (obiect == NULL) {
-                /* Eroare la alocare memorie - continuam cu urmatorul */
-                continue;
-            }
-            
-            strncpy(obiect, inceput_obiect, lungime_obiect);
-            obiect[lungime_obiect] = '\0';
-            
-            /*
-             * Parsam obiectul JSON ca un proces individual
-             */
-            LogEntry intrare;
-            if (parseaza_json_proces(obiect, &intrare, ip_client)) {
-                /* Daca nu are hostname, il punem pe cel din snapshot */
-                if (strlen(intrare.hostname) == 0 && strlen(hostname) > 0) {
-                    strncpy(intrare.hostname, hostname, sizeof(intrare.hostname));
-                }
-                
-                /*
-                 * Adaugam in lista globala de loguri
-                 * Trebuie sa folosim mutex pentru thread-safety!
-                 */
-                pthread_mutex_lock(&g_mutex_loguri);
-                
-                if (g_numar_loguri < MAX_LOGURI) {
-                    /* Avem loc, adaugam la sfarsit */
-                    g_lista_loguri[g_numar_loguri] = intrare;
-                    g_numar_loguri++;
-                } else {
-                    /* Lista e plina, stergem primul si adaugam la sfarsit (FIFO) */
-                    memmove(&g_lista_loguri[0], &g_lista_loguri[1], 
-                            (MAX_LOGURI - 1) * sizeof(LogEntry));
-                    g_lista_loguri[MAX_LOGURI - 1] = intrare;
-                }
-                
-                pthread_mutex_unlock(&g_mutex_loguri);
-                
-                numar_procese++;
-            }
-            
-            /* Eliberam memoria */
-            free(obiect);
-        } 
-        else {
-            /* Caracter neasteptat, trecem mai departe */
-            pozitie++;
-        }
+
+    adauga_in_lot(&intrare);
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: parseaza_hello
+ * -----------------------------------------------------------------------------
+ * Tot prin tokenizer: "client_name" vine de la client, iar o cautare dupa
+ * text ar gasi si o cheie scrisa inauntrul lui.
+ */
+int parseaza_hello(const char* json, CerereHello* cerere) {
+    CampuriJson campuri;
+    const char* pozitie = sari_spatii(json);
+
+    memset(cerere, 0, sizeof(*cerere));
+
+    if (*pozitie != '{' || parseaza_obiect(pozitie, &campuri, NULL) == NULL) {
+        return 0;
     }
-    
-    return numar_procese;
-}
\ No newline at end of file
+
+    const ValoareText* tip = &campuri.texte[CAMP_TIP];
+    if (tip->lungime != 5 || strncasecmp(tip->inceput, "HELLO", 5) != 0) {
+        return 0;
+    }
+
+    cerere->schema_binara = campuri.schema_binara > 0 && campuri.schema_binara <= INT_MAX
+                            ? (int)campuri.schema_binara : 0;
+    cerere->compresie = campuri.texte[CAMP_COMPRESIE].inceput;
+    cerere->lungime_compresie = campuri.texte[CAMP_COMPRESIE].lungime;
+    return 1;
+}
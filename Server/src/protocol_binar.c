@@ -0,0 +1,202 @@
+#include "protocol_binar.h"
+#include "parser_json.h"
+#include "coada_loguri.h"
+#include "tabela_simboluri.h"
+#include "coduri_loguri.h"
+#include "timp_loguri.h"
+#include "stare_gazde.h"
+#include "culori_si_configurari.h"
+
+#include <string.h>     /* Pentru memcpy(), memset() */
+#include <endian.h>     /* Pentru le16toh(), le64toh() */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: schema_binara_acceptata
+ * -----------------------------------------------------------------------------
+ */
+int schema_binara_acceptata(const char* json) {
+    CerereHello cerere;
+
+    if (!parseaza_hello(json, &cerere) || cerere.schema_binara <= 0) {
+        return 0;
+    }
+
+    return cerere.schema_binara < SCHEMA_BINARA ? cerere.schema_binara : SCHEMA_BINARA;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII HELPER: citeste_u16 / citeste_u64
+ * -----------------------------------------------------------------------------
+ * Numerele din mesaj nu sunt aliniate - le copiem cu memcpy (compilatorul
+ * face din asta o singura instructiune) si le aducem la ordinea
+ * octetilor procesorului.
+ */
+static inline uint16_t citeste_u16(const unsigned char* date) {
+    uint16_t valoare;
+    memcpy(&valoare, date, sizeof(valoare));
+    return le16toh(valoare);
+}
+
+static inline uint64_t citeste_u64(const unsigned char* date) {
+    uint64_t valoare;
+    memcpy(&valoare, date, sizeof(valoare));
+    return le64toh(valoare);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: simbol_text
+ * -----------------------------------------------------------------------------
+ * Interneaza un text din mesaj (taiat la 'maxim' caractere, ca la JSON),
+ * sau textul implicit daca e gol.
+ */
+static IdSimbol simbol_text(const unsigned char* text, size_t lungime, size_t maxim,
+                            const char* implicit) {
+    if (lungime == 0) {
+        return interneaza(implicit);
+    }
+    return interneaza_n((const char*)text, lungime < maxim ? lungime : maxim);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: decodeaza_mesaj_binar
+ * -----------------------------------------------------------------------------
+ */
+int decodeaza_mesaj_binar(const unsigned char* date, size_t lungime, const char* ip_client) {
+    /*
+     * Pas 1: Antetul
+     */
+    if (lungime < MARIME_ANTET_BINAR || date[0] != MAGIC_MESAJ_BINAR ||
+        date[1] == 0 || date[1] > SCHEMA_BINARA) {
+        return -1;
+    }
+
+    unsigned int schema = date[1];
+    size_t numar_inregistrari = citeste_u16(date + 2);
+    size_t lungime_hostname = citeste_u16(date + 4);
+    unsigned int steaguri = schema >= 2 ? citeste_u16(date + 6) : 0;
+    int64_t timp_snapshot = (int64_t)citeste_u64(date + 8);
+
+    if (lungime - MARIME_ANTET_BINAR < lungime_hostname) {
+        return -1;
+    }
+
+    int64_t primit_ns = timp_curent_ns();
+    IdSimbol hostname = simbol_text(date + MARIME_ANTET_BINAR, lungime_hostname, LUNGIME_CAMP - 1, "");
+    uint16_t port;
+    IdSimbol ip = interneaza_adresa(ip_client, &port);
+    IdSimbol mesaj = interneaza("Functional");
+
+    if (timp_snapshot == 0) {
+        timp_snapshot = primit_ns;
+    }
+
+    /* Cadru complet / delta: procesele trec prin starea host-ului */
+    TipSnapshot tip = (steaguri & STEAG_CADRU_COMPLET) ? SNAPSHOT_CADRU_COMPLET
+                    : (steaguri & STEAG_DELTA) ? SNAPSHOT_DELTA
+                    : SNAPSHOT_SIMPLU;
+    StareGazda* gazda = (tip != SNAPSHOT_SIMPLU && hostname != SIMBOL_GOL)
+                        ? deschide_stare_gazda(hostname, tip) : NULL;
+
+    /*
+     * Pas 2: Inregistrarile - o singura verificare de lungime pentru
+     * fiecare, restul sunt citiri de la pozitii fixe
+     */
+    const unsigned char* pozitie = date + MARIME_ANTET_BINAR + lungime_hostname;
+    const unsigned char* sfarsit = date + lungime;
+    int adaugate = 0;
+
+    for (size_t i = 0; i < numar_inregistrari; i++) {
+        if ((size_t)(sfarsit - pozitie) < MARIME_INREGISTRARE_BINARA) {
+            adaugate = -1;
+            break;
+        }
+
+        size_t lungime_nume = citeste_u16(pozitie + 30);
+        size_t lungime_user = citeste_u16(pozitie + 32);
+
+        if ((size_t)(sfarsit - pozitie) - MARIME_INREGISTRARE_BINARA < lungime_nume + lungime_user) {
+            adaugate = -1;
+            break;
+        }
+
+        const unsigned char* text = pozitie + MARIME_INREGISTRARE_BINARA;
+        LogEntry intrare;
+        uint32_t pid;
+
+        memcpy(&pid, pozitie + 24, sizeof(pid));
+
+        /* Proces disparut: iese din stare, fara log */
+        if (schema >= 2 && (citeste_u16(pozitie + 34) & STEAG_ELIMINAT)) {
+            if (gazda != NULL) {
+                elimina_proces(gazda, (int)le32toh(pid));
+            }
+            pozitie = text + lungime_nume + lungime_user;
+            continue;
+        }
+
+        uint64_t biti_cpu = citeste_u64(pozitie);
+        int64_t timp = (int64_t)citeste_u64(pozitie + 16);
+
+        memset(&intrare, 0, sizeof(intrare));
+        memcpy(&intrare.procent_cpu, &biti_cpu, sizeof(intrare.procent_cpu));
+
+        intrare.pid = (int)le32toh(pid);
+        intrare.memorie_kb = (unsigned long)citeste_u64(pozitie + 8);
+        intrare.primit_ns = primit_ns;
+        intrare.timestamp_ns = timp != 0 ? timp : timp_snapshot;
+
+        /* Codurile necunoscute devin valorile implicite de la JSON:
+         * status "static", nivel dedus din metrici */
+        unsigned int status = pozitie[28];
+        unsigned int nivel = pozitie[29];
+
+        intrare.cod_status = (status != 0 && status < NUMAR_STATUSURI) ? (StatusProces)status : STATUS_STATIC;
+        intrare.cod_nivel = (nivel != 0 && nivel < NUMAR_NIVELURI)
+                            ? (NivelLog)nivel
+                            : deduce_nivel(intrare.cod_status, intrare.procent_cpu, intrare.memorie_kb);
+
+        intrare.nume = simbol_text(text, lungime_nume, LUNGIME_CAMP - 1, "unknown");
+        intrare.utilizator = simbol_text(text + lungime_nume, lungime_user, LUNGIME_CAMP - 1, "system");
+        intrare.status = interneaza(nume_status(intrare.cod_status));
+        intrare.nivel = interneaza(nume_nivel(intrare.cod_nivel));
+        intrare.mesaj = mesaj;
+        intrare.hostname = hostname;
+        intrare.ip_client = ip;
+        intrare.port_client = port;
+
+        /* Ce lipseste (text gol, cod 0) vine din starea host-ului */
+        if (gazda != NULL) {
+            unsigned int trimise = TRIMIS_CPU | TRIMIS_MEMORIE;
+
+            if (lungime_nume > 0) trimise |= TRIMIS_NUME;
+            if (lungime_user > 0) trimise |= TRIMIS_UTILIZATOR;
+            if (status != 0 && status < NUMAR_STATUSURI) trimise |= TRIMIS_STATUS;
+            if (nivel != 0 && nivel < NUMAR_NIVELURI) trimise |= TRIMIS_NIVEL;
+
+            actualizeaza_proces(gazda, &intrare, trimise);
+        }
+
+        adauga_in_lot(&intrare);
+        adaugate++;
+
+        pozitie = text + lungime_nume + lungime_user;
+    }
+
+    /* Dintr-un cadru complet stricat nu stergem nimic - nu stim ce lipsea */
+    inchide_stare_gazda(gazda, adaugate >= 0 ? tip : SNAPSHOT_DELTA);
+
+    /* Snapshot: tot ce am decodat pleaca in coada odata */
+    if (numar_inregistrari > 1) {
+        trimite_lotul();
+    }
+
+    return adaugate;
+}
@@ -0,0 +1,559 @@
+#define _GNU_SOURCE  /* Necesar pentru accept4() si EPOLLEXCLUSIVE */
+
+#include "reactor_epoll.h"
+#include "retea.h"
+#include "structuri_date.h"
+#include "culori_si_configurari.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>         /* Pentru close() */
+#include <fcntl.h>          /* Pentru fcntl(), O_NONBLOCK */
+#include <errno.h>
+#include <pthread.h>
+#include <sys/epoll.h>      /* Pentru epoll_create1(), epoll_ctl(), epoll_wait() */
+#include <sys/socket.h>
+#include <sys/resource.h>   /* Pentru getrlimit(), setrlimit() */
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+
+/*
+ * Tot ce tine un thread de I/O: propriul epoll, buffer-ul de citire
+ * (comun pentru toate conexiunile lui) si lista conexiunilor pe care
+ * le deserveste. Buffer-ul are un octet in plus, pe care recv() nu il
+ * umple niciodata (vezi proceseaza_date_primite).
+ *
+ * gata_primul/gata_ultimul e coada conexiunilor care si-au epuizat runda
+ * de citiri (CITIRI_MAXIME_PE_TREZIRE) inainte sa goleasca socket-ul. In
+ * modul edge-triggered nu mai primim alt anunt pentru ele, asa ca le
+ * citim noi din nou dupa fiecare lot de evenimente.
+ *
+ * fd_rezerva e un descriptor tinut deschis degeaba: cand procesul ramane
+ * fara descriptori (EMFILE) il eliberam o clipa ca sa putem accepta - si
+ * inchide imediat - conexiunile care asteapta (vezi lipsa_descriptori).
+ */
+typedef struct {
+    pthread_t thread;
+    int epoll_fd;
+    int socket_server;
+    uint32_t evenimente_server;     /* cu ce flag-uri urmarim socket-ul server */
+    int fd_rezerva;
+    int accept_suspendat;           /* socket-ul server e scos din epoll */
+    time_t reluare_accept;          /* cand il punem la loc */
+    time_t ultima_avertizare;
+    StareConexiune* conexiuni;
+    StareConexiune* gata_primul;
+    StareConexiune* gata_ultimul;
+    char buffer[DIMENSIUNE_BUFFER + 1];
+} ThreadIO;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: seteaza_neblocant
+ * -----------------------------------------------------------------------------
+ * Pune un socket in modul neblocant: recv()/accept() se intorc imediat cu
+ * EAGAIN in loc sa astepte. Returneaza 0 la succes, -1 la eroare.
+ */
+static int seteaza_neblocant(int socket_fd, int neblocant) {
+    int flaguri = fcntl(socket_fd, F_GETFL, 0);
+    if (flaguri < 0) {
+        return -1;
+    }
+
+    flaguri = neblocant ? (flaguri | O_NONBLOCK) : (flaguri & ~O_NONBLOCK);
+    return fcntl(socket_fd, F_SETFL, flaguri);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: mareste_limita_fisiere
+ * -----------------------------------------------------------------------------
+ * Fiecare conexiune e un descriptor de fisier. Limita implicita (de obicei
+ * 1024) e prea mica pentru mii de agenti, asa ca o urcam pana la maximul
+ * permis de sistem.
+ */
+static void mareste_limita_fisiere(void) {
+    struct rlimit limita;
+
+    if (getrlimit(RLIMIT_NOFILE, &limita) == 0 && limita.rlim_cur < limita.rlim_max) {
+        limita.rlim_cur = limita.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limita);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: pune_in_lista_gata / scoate_din_lista_gata
+ * -----------------------------------------------------------------------------
+ * Coada conexiunilor care mai au date de citit (vezi ThreadIO). Scoaterea
+ * parcurge coada, dar se intampla doar cand inchidem o conexiune din ea.
+ */
+static void pune_in_lista_gata(ThreadIO* io, StareConexiune* conexiune) {
+    if (conexiune->in_lista_gata) {
+        return;
+    }
+
+    conexiune->in_lista_gata = 1;
+    conexiune->urmator_gata = NULL;
+    if (io->gata_ultimul != NULL) {
+        io->gata_ultimul->urmator_gata = conexiune;
+    } else {
+        io->gata_primul = conexiune;
+    }
+    io->gata_ultimul = conexiune;
+}
+
+static void scoate_din_lista_gata(ThreadIO* io, StareConexiune* conexiune) {
+    StareConexiune* anterior = NULL;
+    StareConexiune* curent = io->gata_primul;
+
+    while (curent != NULL && curent != conexiune) {
+        anterior = curent;
+        curent = curent->urmator_gata;
+    }
+    if (curent == NULL) {
+        return;
+    }
+
+    if (anterior != NULL) {
+        anterior->urmator_gata = conexiune->urmator_gata;
+    } else {
+        io->gata_primul = conexiune->urmator_gata;
+    }
+    if (io->gata_ultimul == conexiune) {
+        io->gata_ultimul = anterior;
+    }
+    conexiune->in_lista_gata = 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: scoate_din_lista / inchide_conexiune_io
+ * -----------------------------------------------------------------------------
+ * Scot conexiunea din listele thread-ului si o inchid. close() o scoate
+ * automat si din epoll.
+ */
+static void scoate_din_lista(ThreadIO* io, StareConexiune* conexiune) {
+    if (conexiune->anterior != NULL) {
+        conexiune->anterior->urmator = conexiune->urmator;
+    } else {
+        io->conexiuni = conexiune->urmator;
+    }
+
+    if (conexiune->urmator != NULL) {
+        conexiune->urmator->anterior = conexiune->anterior;
+    }
+}
+
+static void inchide_conexiune_io(ThreadIO* io, StareConexiune* conexiune) {
+    if (conexiune->in_lista_gata) {
+        scoate_din_lista_gata(io, conexiune);
+    }
+    scoate_din_lista(io, conexiune);
+    inchide_conexiune(conexiune);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: suspenda_accept / reia_accept
+ * -----------------------------------------------------------------------------
+ * Socket-ul server e urmarit level-triggered: cat timp are o conexiune in
+ * asteptare, epoll_wait() se intoarce imediat. Daca nu o putem accepta, il
+ * scoatem din epoll-ul thread-ului si il punem la loc dupa o pauza, altfel
+ * thread-ul s-ar invarti in gol.
+ */
+static void suspenda_accept(ThreadIO* io) {
+    if (epoll_ctl(io->epoll_fd, EPOLL_CTL_DEL, io->socket_server, NULL) == 0) {
+        io->accept_suspendat = 1;
+        io->reluare_accept = time(NULL) + PAUZA_ACCEPT_SECUNDE;
+    }
+}
+
+static void reia_accept(ThreadIO* io) {
+    struct epoll_event eveniment;
+    memset(&eveniment, 0, sizeof(eveniment));
+    eveniment.events = io->evenimente_server;
+    eveniment.data.ptr = NULL;
+
+    if (epoll_ctl(io->epoll_fd, EPOLL_CTL_ADD, io->socket_server, &eveniment) == 0) {
+        io->accept_suspendat = 0;
+    } else {
+        io->reluare_accept = time(NULL) + PAUZA_ACCEPT_SECUNDE;
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: lipsa_descriptori
+ * -----------------------------------------------------------------------------
+ * accept() a esuat cu EMFILE/ENFILE: conexiunea ramane in coada lui listen()
+ * si ne-ar trezi la nesfarsit. Eliberam descriptorul de rezerva, o acceptam
+ * si o inchidem pe loc (agentul se reconecteaza mai tarziu), apoi luam
+ * rezerva inapoi. Avertizam cel mult o data pe pauza, nu la fiecare incercare.
+ *
+ * RETURNEAZA:
+ *     1 daca am scos o conexiune din coada (mai incercam), 0 altfel
+ */
+static int lipsa_descriptori(ThreadIO* io) {
+    time_t acum = time(NULL);
+    if (acum - io->ultima_avertizare >= PAUZA_ACCEPT_SECUNDE) {
+        io->ultima_avertizare = acum;
+        fprintf(stderr, "[!] Prea multe fisiere deschise - refuzam conexiunile noi\n");
+    }
+
+    int refuzata = 0;
+    if (io->fd_rezerva >= 0) {
+        close(io->fd_rezerva);
+        int socket_client = accept4(io->socket_server, NULL, NULL, SOCK_CLOEXEC);
+        if (socket_client >= 0) {
+            close(socket_client);
+            refuzata = 1;
+        }
+        io->fd_rezerva = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+
+    /* Fara rezerva (sau alt thread ne-a luat-o) - nu putem goli coada */
+    if (!refuzata) {
+        suspenda_accept(io);
+    }
+    return refuzata;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: accepta_conexiuni
+ * -----------------------------------------------------------------------------
+ * Acceptam TOATE conexiunile care asteapta (pana la EAGAIN) si le adaugam
+ * in epoll-ul acestui thread.
+ */
+static void accepta_conexiuni(ThreadIO* io) {
+    while (g_server_ruleaza) {
+        struct sockaddr_in adresa_client;
+        socklen_t lungime_adresa = sizeof(adresa_client);
+
+        /* accept4() = accept() + setarea flag-urilor intr-un singur apel */
+        int socket_client = accept4(io->socket_server,
+                                    (struct sockaddr*)&adresa_client,
+                                    &lungime_adresa,
+                                    SOCK_NONBLOCK | SOCK_CLOEXEC);
+
+        if (socket_client < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EMFILE || errno == ENFILE) {
+                if (lipsa_descriptori(io)) {
+                    continue;
+                }
+                return;
+            }
+            if (errno != EAGAIN && errno != EWOULDBLOCK && g_server_ruleaza) {
+                /* Eroare reala (ex: prea multe fisiere deschise) */
+                perror("Eroare la accept");
+            }
+            return;
+        }
+
+        /* Formatam IP-ul clientului ca "IP:PORT" */
+        char ip_client[64];
+        snprintf(ip_client, sizeof(ip_client), "%s:%d",
+                 inet_ntoa(adresa_client.sin_addr),
+                 ntohs(adresa_client.sin_port));
+
+        StareConexiune* conexiune = deschide_conexiune(socket_client, ip_client);
+        if (conexiune == NULL) {
+            close(socket_client);
+            continue;
+        }
+
+        /*
+         * EPOLLIN    = anunta-ne cand sunt date de citit
+         * EPOLLRDHUP = anunta-ne cand clientul inchide conexiunea
+         * EPOLLET    = edge-triggered: un singur anunt per "val" de date
+         */
+        struct epoll_event eveniment;
+        memset(&eveniment, 0, sizeof(eveniment));
+        eveniment.events = EPOLLIN | EPOLLRDHUP | EPOLLET;
+        eveniment.data.ptr = conexiune;
+
+        if (epoll_ctl(io->epoll_fd, EPOLL_CTL_ADD, socket_client, &eveniment) < 0) {
+            perror("Eroare la epoll_ctl");
+            inchide_conexiune(conexiune);
+            continue;
+        }
+
+        /* O adaugam la inceputul listei thread-ului */
+        conexiune->anterior = NULL;
+        conexiune->urmator = io->conexiuni;
+        if (io->conexiuni != NULL) {
+            io->conexiuni->anterior = conexiune;
+        }
+        io->conexiuni = conexiune;
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: citeste_conexiune
+ * -----------------------------------------------------------------------------
+ * In modul edge-triggered TREBUIE sa citim pana golim socket-ul, altfel
+ * nu mai primim niciun anunt pentru datele ramase. Ca un singur client sa
+ * nu tina thread-ul ocupat, citim cel mult CITIRI_MAXIME_PE_TREZIRE
+ * buffere; daca socket-ul tot nu e gol, conexiunea intra in lista de
+ * "gata" si continuam cu ea dupa lotul curent de evenimente.
+ *
+ * RETURNEAZA:
+ *     1 daca conexiunea ramane deschisa, 0 daca trebuie inchisa
+ */
+static int citeste_conexiune(ThreadIO* io, StareConexiune* conexiune) {
+    int citiri = 0;
+
+    while (1) {
+        if (citiri == CITIRI_MAXIME_PE_TREZIRE) {
+            pune_in_lista_gata(io, conexiune);
+            return 1;
+        }
+
+        ssize_t octeti_primiti = recv(conexiune->socket, io->buffer, DIMENSIUNE_BUFFER, 0);
+
+        if (octeti_primiti > 0) {
+            citiri++;
+            if (!proceseaza_date_primite(conexiune, io->buffer, (size_t)octeti_primiti)) {
+                return 0;  /* Flux comprimat corupt */
+            }
+            continue;
+        }
+
+        if (octeti_primiti == 0) {
+            return 0;  /* Clientul s-a deconectat normal */
+        }
+
+        if (errno == EINTR) {
+            continue;
+        }
+
+        /* EAGAIN = am golit socket-ul, asteptam urmatorul anunt */
+        return (errno == EAGAIN || errno == EWOULDBLOCK);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: citeste_lista_gata
+ * -----------------------------------------------------------------------------
+ * Dam fiecarei conexiuni din lista de "gata" inca o runda de citiri. Luam
+ * toata lista de la inceput: cele care tot nu au golit socket-ul se pun
+ * singure intr-o lista noua, pentru urmatoarea trecere.
+ */
+static void citeste_lista_gata(ThreadIO* io) {
+    StareConexiune* conexiune = io->gata_primul;
+    io->gata_primul = NULL;
+    io->gata_ultimul = NULL;
+
+    while (conexiune != NULL) {
+        StareConexiune* urmatoarea = conexiune->urmator_gata;
+        conexiune->in_lista_gata = 0;
+
+        if (!citeste_conexiune(io, conexiune)) {
+            inchide_conexiune_io(io, conexiune);
+        }
+        conexiune = urmatoarea;
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: thread_io_epoll
+ * -----------------------------------------------------------------------------
+ * Bucla unui thread de I/O: asteapta evenimente si le trateaza.
+ */
+static void* thread_io_epoll(void* arg) {
+    ThreadIO* io = (ThreadIO*)arg;
+    struct epoll_event evenimente[MAX_EVENIMENTE_EPOLL];
+
+    while (g_server_ruleaza) {
+        /* Asteptam maxim 1 secunda, ca sa observam oprirea serverului;
+         * deloc daca avem conexiuni cu date ramase de citit */
+        int asteptare = io->gata_primul != NULL ? 0 : 1000;
+        int numar = epoll_wait(io->epoll_fd, evenimente, MAX_EVENIMENTE_EPOLL, asteptare);
+
+        if (numar < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Eroare la epoll_wait");
+            break;
+        }
+
+        if (io->accept_suspendat && time(NULL) >= io->reluare_accept) {
+            reia_accept(io);
+        }
+
+        for (int i = 0; i < numar; i++) {
+            StareConexiune* conexiune = (StareConexiune*)evenimente[i].data.ptr;
+
+            /* data.ptr == NULL inseamna socket-ul server: conexiuni noi */
+            if (conexiune == NULL) {
+                accepta_conexiuni(io);
+                continue;
+            }
+
+            /* Citim mai intai ce a ramas, abia apoi tratam inchiderea
+             * (daca a ramas si dupa runda asta, o inchidem cand recv()
+             * intoarce 0, din lista de "gata") */
+            if (!citeste_conexiune(io, conexiune) ||
+                ((evenimente[i].events & (EPOLLHUP | EPOLLERR)) && !conexiune->in_lista_gata)) {
+                inchide_conexiune_io(io, conexiune);
+            }
+        }
+
+        citeste_lista_gata(io);
+    }
+
+    /* Oprire: inchidem toate conexiunile acestui thread */
+    while (io->conexiuni != NULL) {
+        inchide_conexiune_io(io, io->conexiuni);
+    }
+
+    return NULL;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: ruleaza_reactor_epoll
+ * -----------------------------------------------------------------------------
+ */
+int ruleaza_reactor_epoll(int socket_server) {
+    /*
+     * Pas 1: Stabilim cate thread-uri de I/O pornim
+     */
+    long numar_threaduri = numar_threaduri_io();
+
+    ThreadIO* threaduri = calloc((size_t)numar_threaduri, sizeof(ThreadIO));
+    if (threaduri == NULL) {
+        return -1;
+    }
+
+    /*
+     * Pas 2: Cream cate un epoll pentru fiecare thread si ii dam de urmarit
+     * socket-ul server
+     *
+     * EPOLLEXCLUSIVE = la o conexiune noua nu trezim TOATE thread-urile,
+     * ci doar unul (sau cateva). Kernel-urile vechi nu il cunosc, caz in
+     * care renuntam la el - merge si fara, doar cu treziri in plus.
+     */
+    int pornite = 0;
+    int eroare = 0;
+
+    for (long i = 0; i < numar_threaduri; i++) {
+        threaduri[i].socket_server = socket_server;
+        threaduri[i].fd_rezerva = -1;
+        threaduri[i].epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+
+        if (threaduri[i].epoll_fd < 0) {
+            perror("Eroare la epoll_create1");
+            eroare = 1;
+            break;
+        }
+
+        struct epoll_event eveniment;
+        memset(&eveniment, 0, sizeof(eveniment));
+        eveniment.events = EPOLLIN | EPOLLEXCLUSIVE;
+        eveniment.data.ptr = NULL;  /* NULL = socket-ul server */
+
+        if (epoll_ctl(threaduri[i].epoll_fd, EPOLL_CTL_ADD, socket_server, &eveniment) < 0) {
+            eveniment.events = EPOLLIN;
+            if (epoll_ctl(threaduri[i].epoll_fd, EPOLL_CTL_ADD, socket_server, &eveniment) < 0) {
+                perror("Eroare la epoll_ctl (socket server)");
+                close(threaduri[i].epoll_fd);
+                eroare = 1;
+                break;
+            }
+        }
+
+        threaduri[i].evenimente_server = eveniment.events;
+        threaduri[i].fd_rezerva = open("/dev/null", O_RDONLY | O_CLOEXEC);
+        pornite++;
+    }
+
+    /*
+     * Pas 3: Socket-ul server trebuie sa fie neblocant - mai multe thread-uri
+     * pot fi trezite pentru aceeasi conexiune si doar unul o va primi
+     */
+    if (!eroare && seteaza_neblocant(socket_server, 1) < 0) {
+        perror("Eroare la fcntl");
+        eroare = 1;
+    }
+
+    if (eroare) {
+        /* Nu putem porni reactorul - lasam socket-ul cum l-am gasit */
+        for (int i = 0; i < pornite; i++) {
+            close(threaduri[i].epoll_fd);
+            if (threaduri[i].fd_rezerva >= 0) {
+                close(threaduri[i].fd_rezerva);
+            }
+        }
+        free(threaduri);
+        return -1;
+    }
+
+    mareste_limita_fisiere();
+
+    /*
+     * Pas 4: Pornim thread-urile si asteptam oprirea serverului
+     */
+    int create = 0;
+    for (long i = 0; i < numar_threaduri; i++) {
+        if (pthread_create(&threaduri[i].thread, NULL, thread_io_epoll, &threaduri[i]) != 0) {
+            perror("Eroare la pthread_create");
+            break;
+        }
+        create++;
+    }
+
+    /* epoll-urile fara thread nu trebuie sa mai "fure" conexiuni noi */
+    for (long i = create; i < numar_threaduri; i++) {
+        close(threaduri[i].epoll_fd);
+        if (threaduri[i].fd_rezerva >= 0) {
+            close(threaduri[i].fd_rezerva);
+        }
+    }
+
+    if (create == 0) {
+        /* Niciun thread pornit - inapoi la modul vechi */
+        free(threaduri);
+        seteaza_neblocant(socket_server, 0);
+        return -1;
+    }
+
+    for (int i = 0; i < create; i++) {
+        pthread_join(threaduri[i].thread, NULL);
+    }
+
+    /*
+     * Pas 5: Curatenie
+     */
+    for (int i = 0; i < create; i++) {
+        close(threaduri[i].epoll_fd);
+        if (threaduri[i].fd_rezerva >= 0) {
+            close(threaduri[i].fd_rezerva);
+        }
+    }
+    free(threaduri);
+
+    return 0;
+}
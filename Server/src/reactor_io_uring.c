@@ -0,0 +1,706 @@
+#define _GNU_SOURCE
+
+#include "reactor_io_uring.h"
+#include "retea.h"
+#include "structuri_date.h"
+#include "culori_si_configurari.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>         /* Pentru uintptr_t */
+#include <time.h>
+#include <unistd.h>         /* Pentru close(), syscall() */
+#include <errno.h>
+#include <pthread.h>
+#include <sys/mman.h>       /* Pentru mmap(), munmap() */
+#include <sys/socket.h>
+#include <sys/syscall.h>    /* Pentru __NR_io_uring_* */
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <linux/io_uring.h> /* Structurile si constantele io_uring */
+
+
+/*
+ * Nu depindem de liburing - vorbim direct cu kernel-ul prin cele trei
+ * apeluri de sistem io_uring. Astea sunt doar niste scurtaturi.
+ */
+static int io_uring_setup(unsigned intrari, struct io_uring_params* parametri) {
+    return (int)syscall(__NR_io_uring_setup, intrari, parametri);
+}
+
+static int io_uring_enter(int fd, unsigned de_trimis, unsigned minim_complete, unsigned flaguri) {
+    return (int)syscall(__NR_io_uring_enter, fd, de_trimis, minim_complete, flaguri, NULL, 0);
+}
+
+static int io_uring_register(int fd, unsigned operatie, void* argument, unsigned numar) {
+    return (int)syscall(__NR_io_uring_register, fd, operatie, argument, numar);
+}
+
+
+/*
+ * Valori speciale pentru user_data (ce operatie a produs un rezultat).
+ * Pentru recv punem direct adresa StareConexiune - adresele din heap nu
+ * pot fi niciodata 1 sau 2.
+ */
+#define OPERATIE_ACCEPT   1ULL
+#define OPERATIE_TIMEOUT  2ULL
+
+/* ID-ul grupului de buffere (avem un singur grup per inel) */
+#define GRUP_BUFFERE 0
+
+
+/*
+ * Tot ce tine un thread io_uring: inelul (cozile SQ/CQ partajate cu
+ * kernel-ul), inelul de buffere furnizate si conexiunile deservite.
+ */
+typedef struct {
+    pthread_t thread;
+    int fd;
+    int socket_server;
+
+    /* Coada de trimitere (Submission Queue) */
+    void* memorie_sq;
+    size_t dimensiune_sq;
+    unsigned* sq_cap;
+    unsigned* sq_coada;
+    unsigned* sq_masca;
+    unsigned* sq_indici;
+    struct io_uring_sqe* sqe;
+    size_t dimensiune_sqe;
+    unsigned sq_intrari;
+    unsigned sq_coada_locala;   /* Cererile pregatite dar nepublicate */
+    unsigned sq_trimise;        /* Pana unde am trimis deja la kernel */
+
+    /* Coada de rezultate (Completion Queue) */
+    void* memorie_cq;
+    size_t dimensiune_cq;
+    unsigned* cq_cap;
+    unsigned* cq_coada;
+    unsigned* cq_masca;
+    struct io_uring_cqe* cqe;
+
+    /* Inelul de buffere furnizate + memoria buffer-elor */
+    struct io_uring_buf_ring* inel_buffere;
+    size_t dimensiune_inel_buffere;
+    char* buffere;
+    unsigned short coada_buffere;
+
+    /* Timeout-ul periodic care ne trezeste ca sa observam oprirea */
+    struct __kernel_timespec interval;
+    int fara_timeout;           /* nu a incaput in coada, il cerem din nou */
+
+    /* Accept-ul oprit dupa o eroare (ex: EMFILE), reluat de timeout */
+    int accept_oprit;
+    time_t reluare_accept;
+    time_t ultima_avertizare;
+
+    /* 0 pe kernel-uri care stiu accept multishot dar nu si recv multishot */
+    int recv_multishot;
+
+    StareConexiune* conexiuni;
+    int numar_conexiuni;
+} InelIO;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: trimite_cereri
+ * -----------------------------------------------------------------------------
+ * Publica cererile pregatite si, optional, asteapta cel putin
+ * 'minim_complete' rezultate. Un singur apel de sistem pentru ambele.
+ */
+static int trimite_cereri(InelIO* inel, unsigned minim_complete) {
+    /* Publicam noua coada - kernel-ul trebuie sa vada intai cererile */
+    __atomic_store_n(inel->sq_coada, inel->sq_coada_locala, __ATOMIC_RELEASE);
+
+    unsigned de_trimis = inel->sq_coada_locala - inel->sq_trimise;
+    unsigned flaguri = minim_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+    if (de_trimis == 0 && minim_complete == 0) {
+        return 0;
+    }
+
+    int rezultat = io_uring_enter(inel->fd, de_trimis, minim_complete, flaguri);
+    if (rezultat < 0) {
+        return (errno == EINTR || errno == EAGAIN || errno == EBUSY) ? 0 : -1;
+    }
+
+    inel->sq_trimise += (unsigned)rezultat;
+    return 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: obtine_sqe
+ * -----------------------------------------------------------------------------
+ * Ia urmatorul loc liber din coada de trimitere (golita de zerouri).
+ * Daca e plina, trimitem intai ce avem la kernel.
+ */
+static struct io_uring_sqe* obtine_sqe(InelIO* inel) {
+    unsigned cap = __atomic_load_n(inel->sq_cap, __ATOMIC_ACQUIRE);
+
+    if (inel->sq_coada_locala - cap >= inel->sq_intrari) {
+        trimite_cereri(inel, 0);
+        cap = __atomic_load_n(inel->sq_cap, __ATOMIC_ACQUIRE);
+        if (inel->sq_coada_locala - cap >= inel->sq_intrari) {
+            return NULL;
+        }
+    }
+
+    unsigned index = inel->sq_coada_locala & *inel->sq_masca;
+    struct io_uring_sqe* sqe = &inel->sqe[index];
+
+    memset(sqe, 0, sizeof(*sqe));
+    inel->sq_indici[index] = index;
+    inel->sq_coada_locala++;
+
+    return sqe;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTII HELPER: cereri (accept, recv, timeout)
+ * -----------------------------------------------------------------------------
+ * obtine_sqe() a trimis deja ce era in coada; daca tot nu e loc, accept-ul
+ * si timeout-ul se reiau la urmatoarea tura, iar cere_recv() raporteaza
+ * esecul - o conexiune fara recv in curs nu ar mai fi citita niciodata.
+ */
+static void opreste_accept(InelIO* inel) {
+    inel->accept_oprit = 1;
+    inel->reluare_accept = time(NULL) + PAUZA_ACCEPT_SECUNDE;
+}
+
+static void cere_accept(InelIO* inel) {
+    struct io_uring_sqe* sqe = obtine_sqe(inel);
+    if (sqe == NULL) {
+        opreste_accept(inel);
+        return;
+    }
+    inel->accept_oprit = 0;
+
+    /* Accept multishot: ramane activ si produce un rezultat per conexiune */
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = inel->socket_server;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = OPERATIE_ACCEPT;
+}
+
+static int cere_recv(InelIO* inel, StareConexiune* conexiune) {
+    struct io_uring_sqe* sqe = obtine_sqe(inel);
+    if (sqe == NULL) {
+        return -1;
+    }
+
+    /* Fara buffer propriu: kernel-ul alege unul din grupul nostru */
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conexiune->socket;
+    sqe->ioprio = inel->recv_multishot ? IORING_RECV_MULTISHOT : 0;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = GRUP_BUFFERE;
+    sqe->user_data = (unsigned long long)(uintptr_t)conexiune;
+    return 0;
+}
+
+static void cere_timeout(InelIO* inel) {
+    struct io_uring_sqe* sqe = obtine_sqe(inel);
+    inel->fara_timeout = (sqe == NULL);
+    if (sqe == NULL) {
+        return;
+    }
+
+    sqe->opcode = IORING_OP_TIMEOUT;
+    sqe->addr = (unsigned long long)(uintptr_t)&inel->interval;
+    sqe->len = 1;
+    sqe->user_data = OPERATIE_TIMEOUT;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: recicleaza_buffer
+ * -----------------------------------------------------------------------------
+ * Dupa ce am procesat datele dintr-un buffer, il punem inapoi in inel ca
+ * sa-l poata folosi kernel-ul pentru urmatorul recv.
+ *
+ * Kernel-ul primeste buffer-ul fara ultimul octet: acela ramane liber
+ * pentru proceseaza_date_primite, chiar daca recv-ul umple tot.
+ */
+static void recicleaza_buffer(InelIO* inel, unsigned short id_buffer) {
+    unsigned short masca = NUMAR_BUFFERE_IO_URING - 1;
+    struct io_uring_buf* buffer = &inel->inel_buffere->bufs[inel->coada_buffere & masca];
+
+    buffer->addr = (unsigned long long)(uintptr_t)(inel->buffere + (size_t)id_buffer * DIMENSIUNE_BUFFER);
+    buffer->len = DIMENSIUNE_BUFFER - 1;
+    buffer->bid = id_buffer;
+
+    inel->coada_buffere++;
+    __atomic_store_n(&inel->inel_buffere->tail, inel->coada_buffere, __ATOMIC_RELEASE);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: inchide_conexiune_inel
+ * -----------------------------------------------------------------------------
+ */
+static void inchide_conexiune_inel(InelIO* inel, StareConexiune* conexiune) {
+    if (conexiune->anterior != NULL) {
+        conexiune->anterior->urmator = conexiune->urmator;
+    } else {
+        inel->conexiuni = conexiune->urmator;
+    }
+    if (conexiune->urmator != NULL) {
+        conexiune->urmator->anterior = conexiune->anterior;
+    }
+
+    inel->numar_conexiuni--;
+    inchide_conexiune(conexiune);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: trateaza_accept
+ * -----------------------------------------------------------------------------
+ * Fara IORING_CQE_F_MORE, cererea multishot s-a terminat. Dupa o conexiune
+ * reusita o refacem imediat; dupa o eroare (ex: EMFILE) conexiunea ramane
+ * in coada lui listen() si am primi aceeasi eroare pe loc, asa ca lasam
+ * timeout-ul periodic sa o refaca dupa PAUZA_ACCEPT_SECUNDE.
+ */
+static void trateaza_accept(InelIO* inel, const struct io_uring_cqe* cqe) {
+    int terminata = !(cqe->flags & IORING_CQE_F_MORE) && g_server_ruleaza;
+
+    if (cqe->res < 0) {
+        if (!g_server_ruleaza) {
+            return;
+        }
+        if (cqe->res == -ECANCELED) {
+            if (terminata) {
+                cere_accept(inel);
+            }
+            return;
+        }
+
+        time_t acum = time(NULL);
+        if (acum - inel->ultima_avertizare >= PAUZA_ACCEPT_SECUNDE) {
+            inel->ultima_avertizare = acum;
+            fprintf(stderr, "Eroare la accept (io_uring): %s\n", strerror(-cqe->res));
+        }
+        if (terminata) {
+            opreste_accept(inel);
+        }
+        return;
+    }
+
+    if (terminata) {
+        cere_accept(inel);
+    }
+
+    int socket_client = cqe->res;
+
+    /* Accept multishot nu ne da adresa, o cerem separat */
+    struct sockaddr_in adresa_client;
+    socklen_t lungime_adresa = sizeof(adresa_client);
+    memset(&adresa_client, 0, sizeof(adresa_client));
+    getpeername(socket_client, (struct sockaddr*)&adresa_client, &lungime_adresa);
+
+    char ip_client[64];
+    snprintf(ip_client, sizeof(ip_client), "%s:%d",
+             inet_ntoa(adresa_client.sin_addr),
+             ntohs(adresa_client.sin_port));
+
+    StareConexiune* conexiune = deschide_conexiune(socket_client, ip_client);
+    if (conexiune == NULL) {
+        close(socket_client);
+        return;
+    }
+
+    conexiune->anterior = NULL;
+    conexiune->urmator = inel->conexiuni;
+    if (inel->conexiuni != NULL) {
+        inel->conexiuni->anterior = conexiune;
+    }
+    inel->conexiuni = conexiune;
+    inel->numar_conexiuni++;
+
+    if (cere_recv(inel, conexiune) < 0) {
+        inchide_conexiune_inel(inel, conexiune);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: trateaza_recv
+ * -----------------------------------------------------------------------------
+ */
+static void trateaza_recv(InelIO* inel, StareConexiune* conexiune, const struct io_uring_cqe* cqe) {
+    int mai_urmeaza = (cqe->flags & IORING_CQE_F_MORE) != 0;
+
+    if (cqe->res > 0) {
+        /* ID-ul buffer-ului ales de kernel e in bitii de sus ai flag-urilor */
+        unsigned short id_buffer = (unsigned short)(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+        char* date = inel->buffere + (size_t)id_buffer * DIMENSIUNE_BUFFER;
+
+        int ramane_deschisa = proceseaza_date_primite(conexiune, date, (size_t)cqe->res);
+        recicleaza_buffer(inel, id_buffer);
+
+        if (!ramane_deschisa && mai_urmeaza) {
+            /* Flux comprimat corupt, dar recv-ul multishot inca foloseste
+             * conexiunea: dupa shutdown() kernelul il termina (res 0, fara
+             * IORING_CQE_F_MORE) si abia atunci o inchidem */
+            shutdown(conexiune->socket, SHUT_RDWR);
+            return;
+        }
+        if (ramane_deschisa && (mai_urmeaza || cere_recv(inel, conexiune) == 0)) {
+            return;
+        }
+    }
+    else if (mai_urmeaza) {
+        return;  /* Cererea e inca activa, nu avem ce face */
+    }
+    else if (cqe->res == -ENOBUFS) {
+        /* Toate buffer-ele erau ocupate - reincercam */
+        if (cere_recv(inel, conexiune) == 0) {
+            return;
+        }
+    }
+    else if (cqe->res == -EINVAL && inel->recv_multishot) {
+        /* Kernel fara recv multishot - trecem pe recv simplu */
+        inel->recv_multishot = 0;
+        if (cere_recv(inel, conexiune) == 0) {
+            return;
+        }
+    }
+
+    /* 0 = clientul s-a deconectat, negativ = eroare, sau nu am putut
+     * cere urmatorul recv (coada de trimitere plina) */
+    inchide_conexiune_inel(inel, conexiune);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: culege_rezultate
+ * -----------------------------------------------------------------------------
+ * Parcurge toate rezultatele din coada CQ si le trateaza.
+ */
+static void culege_rezultate(InelIO* inel) {
+    unsigned cap = *inel->cq_cap;
+    unsigned coada = __atomic_load_n(inel->cq_coada, __ATOMIC_ACQUIRE);
+
+    while (cap != coada) {
+        const struct io_uring_cqe* cqe = &inel->cqe[cap & *inel->cq_masca];
+
+        if (cqe->user_data == OPERATIE_ACCEPT) {
+            trateaza_accept(inel, cqe);
+        }
+        else if (cqe->user_data == OPERATIE_TIMEOUT) {
+            if (g_server_ruleaza || inel->numar_conexiuni > 0) {
+                cere_timeout(inel);
+            }
+            if (inel->accept_oprit && g_server_ruleaza && time(NULL) >= inel->reluare_accept) {
+                cere_accept(inel);
+            }
+        }
+        else {
+            trateaza_recv(inel, (StareConexiune*)(uintptr_t)cqe->user_data, cqe);
+        }
+
+        cap++;
+
+        /* Am terminat cu rezultatele vechi - pot veni altele intre timp */
+        if (cap == coada) {
+            __atomic_store_n(inel->cq_cap, cap, __ATOMIC_RELEASE);
+            coada = __atomic_load_n(inel->cq_coada, __ATOMIC_ACQUIRE);
+        }
+    }
+
+    __atomic_store_n(inel->cq_cap, cap, __ATOMIC_RELEASE);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: distruge_inel
+ * -----------------------------------------------------------------------------
+ */
+static void distruge_inel(InelIO* inel) {
+    if (inel->fd >= 0) {
+        close(inel->fd);
+    }
+    if (inel->memorie_cq != NULL && inel->memorie_cq != inel->memorie_sq) {
+        munmap(inel->memorie_cq, inel->dimensiune_cq);
+    }
+    if (inel->memorie_sq != NULL) {
+        munmap(inel->memorie_sq, inel->dimensiune_sq);
+    }
+    if (inel->sqe != NULL) {
+        munmap(inel->sqe, inel->dimensiune_sqe);
+    }
+    if (inel->inel_buffere != NULL) {
+        munmap(inel->inel_buffere, inel->dimensiune_inel_buffere);
+    }
+    free(inel->buffere);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: initializeaza_inel
+ * -----------------------------------------------------------------------------
+ * Creeaza inelul io_uring, mapeaza cozile in memoria noastra si
+ * inregistreaza inelul de buffere furnizate.
+ *
+ * RETURNEAZA:
+ *     0 la succes, -1 daca kernel-ul nu suporta ce ne trebuie
+ */
+static int initializeaza_inel(InelIO* inel, int socket_server) {
+    memset(inel, 0, sizeof(*inel));
+    inel->fd = -1;
+    inel->socket_server = socket_server;
+    inel->recv_multishot = 1;
+    inel->interval.tv_sec = 1;
+
+    /*
+     * Pas 1: Cream inelul
+     *
+     * COOP_TASKRUN: kernel-ul nu ne intrerupe thread-ul ca sa termine
+     * operatii, le termina cand intram oricum in io_uring_enter().
+     * Kernel-urile mai vechi nu il cunosc - reincercam fara el.
+     */
+    struct io_uring_params parametri;
+    memset(&parametri, 0, sizeof(parametri));
+    parametri.flags = IORING_SETUP_COOP_TASKRUN;
+
+    inel->fd = io_uring_setup(INTRARI_IO_URING, &parametri);
+    if (inel->fd < 0 && errno == EINVAL) {
+        memset(&parametri, 0, sizeof(parametri));
+        inel->fd = io_uring_setup(INTRARI_IO_URING, &parametri);
+    }
+    if (inel->fd < 0) {
+        return -1;
+    }
+
+    /*
+     * Pas 2: Mapam cozile SQ si CQ in memoria procesului
+     *
+     * Cozile sunt memorie partajata cu kernel-ul: el citeste cererile
+     * noastre si scrie rezultatele direct acolo, fara copieri.
+     */
+    inel->dimensiune_sq = parametri.sq_off.array + parametri.sq_entries * sizeof(unsigned);
+    inel->dimensiune_cq = parametri.cq_off.cqes + parametri.cq_entries * sizeof(struct io_uring_cqe);
+
+    int o_singura_mapare = (parametri.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (o_singura_mapare && inel->dimensiune_cq > inel->dimensiune_sq) {
+        inel->dimensiune_sq = inel->dimensiune_cq;
+    }
+
+    inel->memorie_sq = mmap(NULL, inel->dimensiune_sq, PROT_READ | PROT_WRITE,
+                            MAP_SHARED | MAP_POPULATE, inel->fd, IORING_OFF_SQ_RING);
+    if (inel->memorie_sq == MAP_FAILED) {
+        inel->memorie_sq = NULL;
+        distruge_inel(inel);
+        return -1;
+    }
+
+    if (o_singura_mapare) {
+        inel->memorie_cq = inel->memorie_sq;
+    } else {
+        inel->memorie_cq = mmap(NULL, inel->dimensiune_cq, PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, inel->fd, IORING_OFF_CQ_RING);
+        if (inel->memorie_cq == MAP_FAILED) {
+            inel->memorie_cq = NULL;
+            distruge_inel(inel);
+            return -1;
+        }
+    }
+
+    inel->dimensiune_sqe = parametri.sq_entries * sizeof(struct io_uring_sqe);
+    inel->sqe = mmap(NULL, inel->dimensiune_sqe, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, inel->fd, IORING_OFF_SQES);
+    if (inel->sqe == MAP_FAILED) {
+        inel->sqe = NULL;
+        distruge_inel(inel);
+        return -1;
+    }
+
+    char* sq = (char*)inel->memorie_sq;
+    inel->sq_cap = (unsigned*)(sq + parametri.sq_off.head);
+    inel->sq_coada = (unsigned*)(sq + parametri.sq_off.tail);
+    inel->sq_masca = (unsigned*)(sq + parametri.sq_off.ring_mask);
+    inel->sq_indici = (unsigned*)(sq + parametri.sq_off.array);
+    inel->sq_intrari = parametri.sq_entries;
+    inel->sq_coada_locala = *inel->sq_coada;
+    inel->sq_trimise = inel->sq_coada_locala;
+
+    char* cq = (char*)inel->memorie_cq;
+    inel->cq_cap = (unsigned*)(cq + parametri.cq_off.head);
+    inel->cq_coada = (unsigned*)(cq + parametri.cq_off.tail);
+    inel->cq_masca = (unsigned*)(cq + parametri.cq_off.ring_mask);
+    inel->cqe = (struct io_uring_cqe*)(cq + parametri.cq_off.cqes);
+
+    /*
+     * Pas 3: Inelul de buffere furnizate
+     *
+     * Alocam NUMAR_BUFFERE_IO_URING buffere si le punem pe toate in inel.
+     * Inregistrarea esueaza pe kernel-uri mai vechi de 5.19 - care nu stiu
+     * nici accept multishot - deci e si testul nostru de compatibilitate.
+     */
+    inel->dimensiune_inel_buffere = NUMAR_BUFFERE_IO_URING * sizeof(struct io_uring_buf);
+    inel->inel_buffere = mmap(NULL, inel->dimensiune_inel_buffere, PROT_READ | PROT_WRITE,
+                              MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (inel->inel_buffere == MAP_FAILED) {
+        inel->inel_buffere = NULL;
+        distruge_inel(inel);
+        return -1;
+    }
+
+    inel->buffere = malloc((size_t)NUMAR_BUFFERE_IO_URING * DIMENSIUNE_BUFFER);
+    if (inel->buffere == NULL) {
+        distruge_inel(inel);
+        return -1;
+    }
+
+    struct io_uring_buf_reg inregistrare;
+    memset(&inregistrare, 0, sizeof(inregistrare));
+    inregistrare.ring_addr = (unsigned long long)(uintptr_t)inel->inel_buffere;
+    inregistrare.ring_entries = NUMAR_BUFFERE_IO_URING;
+    inregistrare.bgid = GRUP_BUFFERE;
+
+    if (io_uring_register(inel->fd, IORING_REGISTER_PBUF_RING, &inregistrare, 1) < 0) {
+        distruge_inel(inel);
+        return -1;
+    }
+
+    for (unsigned short i = 0; i < NUMAR_BUFFERE_IO_URING; i++) {
+        recicleaza_buffer(inel, i);
+    }
+
+    return 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE: thread_io_uring
+ * -----------------------------------------------------------------------------
+ * Bucla unui thread io_uring: trimite cererile noi si asteapta rezultate,
+ * totul intr-un singur apel de sistem per tura.
+ */
+static void* thread_io_uring(void* arg) {
+    InelIO* inel = (InelIO*)arg;
+
+    cere_accept(inel);
+    cere_timeout(inel);
+
+    while (g_server_ruleaza) {
+        if (inel->fara_timeout) {
+            cere_timeout(inel);
+        }
+        if (trimite_cereri(inel, 1) < 0) {
+            perror("Eroare la io_uring_enter");
+            break;
+        }
+        culege_rezultate(inel);
+    }
+
+    /*
+     * Oprire: inchidem conexiunile "frumos" - shutdown() termina cererile
+     * recv in curs, abia apoi eliberam starea (kernel-ul nu trebuie sa mai
+     * scrie in buffere dupa ce le-am eliberat)
+     */
+    for (StareConexiune* c = inel->conexiuni; c != NULL; c = c->urmator) {
+        shutdown(c->socket, SHUT_RDWR);
+    }
+
+    for (int tura = 0; tura < 3 && inel->numar_conexiuni > 0; tura++) {
+        if (trimite_cereri(inel, 1) < 0) {
+            break;
+        }
+        culege_rezultate(inel);
+    }
+
+    return NULL;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: ruleaza_reactor_io_uring
+ * -----------------------------------------------------------------------------
+ */
+int ruleaza_reactor_io_uring(int socket_server) {
+    int numar_threaduri = numar_threaduri_io();
+
+    InelIO* inele = calloc((size_t)numar_threaduri, sizeof(InelIO));
+    if (inele == NULL) {
+        return -1;
+    }
+
+    /*
+     * Pas 1: Cream toate inelele inainte sa pornim vreun thread - daca
+     * kernel-ul nu suporta io_uring, aflam acum si lasam epoll sa preia
+     */
+    for (int i = 0; i < numar_threaduri; i++) {
+        if (initializeaza_inel(&inele[i], socket_server) < 0) {
+            for (int j = 0; j < i; j++) {
+                distruge_inel(&inele[j]);
+            }
+            free(inele);
+            return -1;
+        }
+    }
+
+    /*
+     * Pas 2: Pornim thread-urile si asteptam oprirea serverului
+     */
+    int create = 0;
+    for (int i = 0; i < numar_threaduri; i++) {
+        if (pthread_create(&inele[i].thread, NULL, thread_io_uring, &inele[i]) != 0) {
+            perror("Eroare la pthread_create");
+            break;
+        }
+        create++;
+    }
+
+    for (int i = create; i < numar_threaduri; i++) {
+        distruge_inel(&inele[i]);
+    }
+
+    if (create == 0) {
+        free(inele);
+        return -1;
+    }
+
+    for (int i = 0; i < create; i++) {
+        pthread_join(inele[i].thread, NULL);
+    }
+
+    /*
+     * Pas 3: Curatenie
+     *
+     * Conexiunile care nu s-au inchis la timp raman cu cereri recv in
+     * kernel; pentru ele nu eliberam buffer-ele (mai bine o scurgere
+     * de memorie la oprire decat o scriere in memorie eliberata).
+     */
+    for (int i = 0; i < create; i++) {
+        int fara_cereri_active = (inele[i].numar_conexiuni == 0);
+
+        while (inele[i].conexiuni != NULL) {
+            inchide_conexiune_inel(&inele[i], inele[i].conexiuni);
+        }
+
+        if (!fara_cereri_active) {
+            inele[i].buffere = NULL;
+        }
+        distruge_inel(&inele[i]);
+    }
+    free(inele);
+
+    return 0;
+}
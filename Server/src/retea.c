@@ -1,16 +1,25 @@
 #define _GNU_SOURCE  /* Necesar pentru unele extensii POSIX */
 
 #include "retea.h"
+#include "reactor_epoll.h"
+#include "reactor_io_uring.h"
 #include "structuri_date.h"
 #include "parser_json.h"
+#include "coada_loguri.h"
 #include "afisare.h"
 #include "utilitare.h"
+#include "scanare_structurala.h"
+#include "protocol_binar.h"
+#include "compresie_flux.h"
+#include "stocare_loguri.h"
+#include "stare_gazde.h"
+#include "tabela_simboluri.h"
 #include "culori_si_configurari.h"
 
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <unistd.h>         /* Pentru close(), sleep() */
+#include <unistd.h>         /* Pentru close(), sleep(), sysconf() */
 #include <sys/socket.h>     /* Pentru socket(), bind(), listen(), accept(), recv(), send() */
 #include <netinet/in.h>     /* Pentru struct sockaddr_in */
 #include <arpa/inet.h>      /* Pentru inet_ntoa() */
@@ -19,229 +28,783 @@
 #include <ctype.h>          /* Pentru isspace() */
 
 
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: proceseaza_mesaj_json
+ * -----------------------------------------------------------------------------
+ * Primeste un JSON complet (terminat cu '\0') si il trimite la parser-ul
+ * potrivit, apoi adauga rezultatul in lista de loguri.
+ */
+static void proceseaza_mesaj_json(const char* json, const char* ip_client) {
+    /*
+     * Parser-ul isi da singur seama de tip (snapshot, un proces, mesaj de
+     * control) din cheile pe care le intalneste, intr-o singura trecere.
+     * Logurile le aduna in lotul thread-ului - pleaca in coada impreuna cu
+     * celelalte mesaje din acelasi recv (vezi proceseaza_date_primite).
+     */
+    parseaza_mesaj_json(json, ip_client);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: livreaza_mesaj
+ * -----------------------------------------------------------------------------
+ * Parser-ul lucreaza cu string-uri terminate cu '\0'. Nu copiem JSON-ul
+ * [date, date + lungime): punem temporar un '\0' in octetul de dupa el,
+ * il parsam pe loc, direct in buffer-ul in care a venit, si apoi punem
+ * octetul la loc (poate fi inceputul urmatorului mesaj).
+ *
+ * Dupa orice zona primita exista mereu un octet liber in care putem
+ * scrie (vezi proceseaza_date_primite), deci nu facem nicio alocare.
+ */
+static void livreaza_mesaj(char* date, size_t lungime, const char* ip_client) {
+    char dupa = date[lungime];
+
+    date[lungime] = '\0';
+    proceseaza_mesaj_json(date, ip_client);
+    date[lungime] = dupa;
+}
+
+
+/* Cate JSON-uri mai mari decat DIMENSIUNE_MAXIMA_MESAJ am aruncat */
+static unsigned long g_mesaje_prea_mari = 0;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: extrage_mesaje_complete
+ * -----------------------------------------------------------------------------
+ * Cauta JSON-uri complete in zona [date, date + lungime) si le proceseaza.
+ *
+ * Un JSON e complet cand numarul de '{' e egal cu numarul de '}'.
+ * Trebuie sa fim atenti la ghilimele - nu numaram acoladele din string-uri.
+ * Orice octet din afara unui obiect (spatii, prefixe de lungime, gunoi)
+ * e sarit.
+ *
+ * Nu ne uitam la fiecare octet: indexeaza_structura() ne da, bloc cu bloc,
+ * doar pozitiile ghilimelelor, backslash-urilor si acoladelor, iar noi
+ * mergem din pozitie in pozitie.
+ *
+ * Scanarea se reia de unde a ramas data trecuta (conexiune->scanare):
+ * octetii unui JSON neterminat nu sunt scanati din nou la fiecare bucata
+ * care mai vine din el.
+ *
+ * Un JSON mai mare decat DIMENSIUNE_MAXIMA_MESAJ nu e pastrat (nici
+ * trunchiat): il numaram, ii aruncam octetii pe masura ce vin si ne
+ * sincronizam din nou dupa acolada lui de inchidere.
+ *
+ * RETURNEAZA:
+ *     Cati octeti de la inceput au fost consumati. Restul (un JSON
+ *     incomplet) trebuie pastrat pana vin mai multe date.
+ */
+static size_t extrage_mesaje_complete(StareConexiune* conexiune, char* date, size_t lungime) {
+    StareScanare* scanare = &conexiune->scanare;
+    uint16_t pozitii[MARIME_BLOC_STRUCTURAL];
+    size_t consumat;
+
+    for (size_t bloc = scanare->pozitie; bloc < lungime; bloc += MARIME_BLOC_STRUCTURAL) {
+        size_t numar = indexeaza_structura(date + bloc, lungime - bloc, pozitii);
+
+        for (size_t i = 0; i < numar; i++) {
+            size_t pozitie = bloc + pozitii[i];
+            char c = date[pozitie];
+
+            if (scanare->adancime == 0) {
+                /* Sarim peste tot ce nu e inceput de JSON */
+                if (c == '{') {
+                    scanare->inceput_json = pozitie;
+                    scanare->adancime = 1;
+                    scanare->in_string = 0;
+                }
+                continue;
+            }
+
+            if (scanare->in_string) {
+                /* In string: sarim peste escape-uri (\" nu inchide string-ul) */
+                if (pozitie < scanare->sari_pana) {
+                    continue;
+                }
+                if (c == '\\') {
+                    scanare->sari_pana = pozitie + 2;
+                } else if (c == '"') {
+                    scanare->in_string = 0;
+                }
+            }
+            else if (c == '"') {
+                scanare->in_string = 1;
+            }
+            else if (c == '{') {
+                scanare->adancime++;
+            }
+            else if (c == '}') {
+                scanare->adancime--;
+
+                if (scanare->adancime == 0) {
+                    /* Am gasit un JSON complet! Includem si ultima '}' */
+                    size_t lungime_json = pozitie + 1 - scanare->inceput_json;
+
+                    if (scanare->arunca) {
+                        /* Sfarsitul unui JSON prea mare - deja numarat */
+                        scanare->arunca = 0;
+                    } else if (lungime_json > DIMENSIUNE_MAXIMA_MESAJ) {
+                        __atomic_fetch_add(&g_mesaje_prea_mari, 1, __ATOMIC_RELAXED);
+                    } else {
+                        livreaza_mesaj(date + scanare->inceput_json, lungime_json, conexiune->ip);
+                    }
+                }
+            }
+        }
+    }
+
+    if (scanare->adancime == 0) {
+        /* Dupa ultimul JSON au ramas doar octeti care nu ne intereseaza */
+        consumat = lungime;
+    } else if (scanare->arunca || lungime - scanare->inceput_json > DIMENSIUNE_MAXIMA_MESAJ) {
+        /* JSON prea mare: nu il mai pastram, doar il urmarim pana la capat */
+        if (!scanare->arunca) {
+            scanare->arunca = 1;
+            __atomic_fetch_add(&g_mesaje_prea_mari, 1, __ATOMIC_RELAXED);
+        }
+        consumat = lungime;
+    } else {
+        /* Nu am gasit JSON complet - asteptam mai multe date */
+        consumat = scanare->inceput_json;
+    }
+
+    /* Pozitiile salvate sunt fata de primul octet neconsumat */
+    scanare->pozitie = lungime - consumat;
+    scanare->inceput_json = (consumat < scanare->inceput_json) ? scanare->inceput_json - consumat : 0;
+    scanare->sari_pana = (consumat < scanare->sari_pana) ? scanare->sari_pana - consumat : 0;
+
+    return consumat;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: citeste_antet_cadru
+ * -----------------------------------------------------------------------------
+ * Lungimea din antet e in ordinea "retelei" (big-endian): primul octet e
+ * cel mai semnificativ.
+ */
+static size_t citeste_antet_cadru(const char* date) {
+    const unsigned char* octeti = (const unsigned char*)date;
+
+    return ((size_t)octeti[0] << 24) | ((size_t)octeti[1] << 16) |
+           ((size_t)octeti[2] << 8)  |  (size_t)octeti[3];
+}
+
+
+static void trimite_bun_venit(StareConexiune* conexiune);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: negociaza_protocol
+ * -----------------------------------------------------------------------------
+ * Primul mesaj de pe o conexiune incadrata e (la clientii nostri) HELLO.
+ * Din el aflam daca clientul stie formatul binar si daca vrea compresie,
+ * apoi ii raspundem cu mesajul de bun venit, in care spunem ce am ales.
+ * Clientii care nu trimit HELLO primesc acelasi bun venit, cu
+ * "protocol":"json" si "compression":"none".
+ */
+static void negociaza_protocol(StareConexiune* conexiune, char* mesaj, size_t lungime) {
+    char dupa = mesaj[lungime];
+
+    mesaj[lungime] = '\0';
+    conexiune->schema_binara = schema_binara_acceptata(mesaj);
+    if (compresie_ceruta(mesaj)) {
+        /* Fara memorie pentru decompresor - raspundem "none" */
+        conexiune->flux_compresie = porneste_decompresia();
+        conexiune->compresie.activa = conexiune->flux_compresie != NULL;
+    }
+    mesaj[lungime] = dupa;
+
+    trimite_bun_venit(conexiune);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: extrage_mesaje_incadrate
+ * -----------------------------------------------------------------------------
+ * Pentru conexiunile cu mesaje incadrate: citim lungimea din antet si dam
+ * parser-ului exact atatia octeti. Nu ne uitam deloc in interiorul JSON-ului.
+ * Mesajele binare (daca au fost negociate) merg la decodorul lor.
+ *
+ * Daca un antet are o lungime imposibila (0 sau peste limita), am pierdut
+ * sincronizarea cu clientul - trecem conexiunea pe cautarea dupa acolade,
+ * care stie sa sara peste octetii care nu fac parte dintr-un JSON.
+ *
+ * RETURNEAZA:
+ *     Cati octeti de la inceput au fost consumati (mesaje intregi)
+ */
+static size_t extrage_mesaje_incadrate(StareConexiune* conexiune, char* date, size_t lungime) {
+    size_t consumat = 0;
+
+    while (lungime - consumat >= DIMENSIUNE_ANTET_CADRU) {
+        size_t lungime_json = citeste_antet_cadru(date + consumat);
+
+        if (lungime_json == 0 ||
+            lungime_json > DIMENSIUNE_MAXIMA_MESAJ - DIMENSIUNE_ANTET_CADRU) {
+            conexiune->incadrare = INCADRARE_ACOLADE;
+            break;
+        }
+
+        if (lungime - consumat - DIMENSIUNE_ANTET_CADRU < lungime_json) {
+            /* Mesajul nu a sosit inca in intregime */
+            break;
+        }
+
+        char* mesaj = date + consumat + DIMENSIUNE_ANTET_CADRU;
+
+        if (!conexiune->bun_venit_trimis) {
+            negociaza_protocol(conexiune, mesaj, lungime_json);
+
+            /* Dupa HELLO urmeaza fluxul comprimat - il lasam apelantului */
+            if (conexiune->flux_compresie != NULL) {
+                livreaza_mesaj(mesaj, lungime_json, conexiune->ip);
+                consumat += DIMENSIUNE_ANTET_CADRU + lungime_json;
+                break;
+            }
+        }
+
+        /* Dupa negociere, un mesaj poate fi binar; JSON-ul ramane valabil */
+        if (conexiune->schema_binara != 0 && (unsigned char)mesaj[0] == MAGIC_MESAJ_BINAR) {
+            decodeaza_mesaj_binar((const unsigned char*)mesaj, lungime_json, conexiune->ip);
+        } else {
+            livreaza_mesaj(mesaj, lungime_json, conexiune->ip);
+        }
+        consumat += DIMENSIUNE_ANTET_CADRU + lungime_json;
+    }
+
+    return consumat;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: detecteaza_incadrare
+ * -----------------------------------------------------------------------------
+ * Ne uitam la primii octeti primiti pe conexiune:
+ * - '{' sau spatiu        -> JSON-uri fara antet (cautam acoladele)
+ * - o lungime plauzibila  -> mesaje incadrate
+ * - orice altceva         -> tot acolade (ele sar peste "gunoi")
+ *
+ * RETURNEAZA:
+ *     1 daca am stabilit modul, 0 daca mai asteptam octeti
+ */
+static int detecteaza_incadrare(StareConexiune* conexiune, const char* date, size_t lungime) {
+    if (lungime == 0) {
+        return 0;
+    }
+
+    if (date[0] == '{' || isspace((unsigned char)date[0])) {
+        conexiune->incadrare = INCADRARE_ACOLADE;
+        return 1;
+    }
+
+    if (lungime < DIMENSIUNE_ANTET_CADRU) {
+        return 0;
+    }
+
+    size_t lungime_json = citeste_antet_cadru(date);
+
+    if (lungime_json > 0 && lungime_json <= DIMENSIUNE_MAXIMA_MESAJ - DIMENSIUNE_ANTET_CADRU) {
+        conexiune->incadrare = INCADRARE_LUNGIME;
+    } else {
+        conexiune->incadrare = INCADRARE_ACOLADE;
+    }
+
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: trimite_bun_venit
+ * -----------------------------------------------------------------------------
+ * Raspundem clientului in acelasi format in care ne vorbeste el: clientii
+ * care incadreaza mesajele citesc intai cei 4 octeti de lungime, deci
+ * primesc si ei raspunsul incadrat.
+ *
+ * Tot aici ii spunem clientului in ce format sa trimita logurile
+ * (vezi protocol_binar.h).
+ */
+static void trimite_bun_venit(StareConexiune* conexiune) {
+    char mesaj_bun_venit[512];
+    char timestamp[64];
+    obtine_timpul_curent(timestamp, sizeof(timestamp));
+
+    /* Lasam loc in fata pentru antet */
+    char* json = mesaj_bun_venit + DIMENSIUNE_ANTET_CADRU;
+    int lungime_json = snprintf(json, sizeof(mesaj_bun_venit) - DIMENSIUNE_ANTET_CADRU,
+                                "{\"connection_status\":\"connected\","
+                                "\"message\":\"Conectat cu succes la server!\","
+                                "\"server_port\":%d,"
+                                "\"timestamp\":\"%s\","
+                                "\"protocol\":\"%s\","
+                                "\"binary_schema\":%d,"
+                                "\"compression\":\"%s\"}",
+                                SERVER_PORT, timestamp,
+                                conexiune->schema_binara != 0 ? "binary" : "json",
+                                conexiune->schema_binara,
+                                conexiune->flux_compresie != NULL ? NUME_COMPRESIE : "none");
+
+    conexiune->bun_venit_trimis = 1;
+
+    if (lungime_json < 0 || (size_t)lungime_json >= sizeof(mesaj_bun_venit) - DIMENSIUNE_ANTET_CADRU - 1) {
+        return;
+    }
+
+    if (conexiune->incadrare == INCADRARE_LUNGIME) {
+        mesaj_bun_venit[0] = (char)((lungime_json >> 24) & 0xFF);
+        mesaj_bun_venit[1] = (char)((lungime_json >> 16) & 0xFF);
+        mesaj_bun_venit[2] = (char)((lungime_json >> 8) & 0xFF);
+        mesaj_bun_venit[3] = (char)(lungime_json & 0xFF);
+
+        send(conexiune->socket, mesaj_bun_venit,
+             DIMENSIUNE_ANTET_CADRU + (size_t)lungime_json, MSG_NOSIGNAL);
+    } else {
+        /* Fara antet - ca inainte, JSON urmat de linie noua */
+        json[lungime_json] = '\n';
+        send(conexiune->socket, json, (size_t)lungime_json + 1, MSG_NOSIGNAL);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: elibereaza_buffer
+ * -----------------------------------------------------------------------------
+ * Nimic in asteptare - eliberam buffer-ul, conexiunea inactiva nu trebuie
+ * sa tina memorie ocupata.
+ */
+static void elibereaza_buffer(StareConexiune* conexiune) {
+    free(conexiune->buffer_date);
+    conexiune->buffer_date = NULL;
+    conexiune->inceput_date = 0;
+    conexiune->lungime_date = 0;
+    conexiune->capacitate_date = 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: adauga_in_buffer
+ * -----------------------------------------------------------------------------
+ * Pune octetii primiti la sfarsitul buffer-ului conexiunii.
+ *
+ * Datele deja procesate de la inceputul buffer-ului le stergem (mutand
+ * restul peste ele) doar cand nu mai incape nimic la sfarsit - nu dupa
+ * fiecare mesaj. Abia daca nici asa nu ajunge, marim buffer-ul.
+ *
+ * Alocam mereu cu un octet in plus fata de date, pentru livreaza_mesaj.
+ *
+ * RETURNEAZA:
+ *     1 daca am pastrat datele, 0 daca nu avem memorie
+ */
+static int adauga_in_buffer(StareConexiune* conexiune, const char* date, size_t lungime) {
+    if (conexiune->lungime_date + lungime + 1 > conexiune->capacitate_date &&
+        conexiune->inceput_date > 0) {
+        size_t neprocesate = conexiune->lungime_date - conexiune->inceput_date;
+
+        memmove(conexiune->buffer_date, conexiune->buffer_date + conexiune->inceput_date, neprocesate);
+        conexiune->inceput_date = 0;
+        conexiune->lungime_date = neprocesate;
+    }
+
+    size_t necesar = conexiune->lungime_date + lungime + 1;
+
+    if (necesar > conexiune->capacitate_date) {
+        size_t capacitate = conexiune->capacitate_date * 2;
+        if (capacitate < DIMENSIUNE_BUFFER) {
+            capacitate = DIMENSIUNE_BUFFER;
+        }
+        if (capacitate < necesar) {
+            capacitate = necesar;
+        }
+
+        char* nou = realloc(conexiune->buffer_date, capacitate);
+        if (nou == NULL) {
+            return 0;
+        }
+        conexiune->buffer_date = nou;
+        conexiune->capacitate_date = capacitate;
+    }
+
+    memcpy(conexiune->buffer_date + conexiune->lungime_date, date, lungime);
+    conexiune->lungime_date += lungime;
+    return 1;
+}
+
+
+static int decomprima_date(StareConexiune* conexiune, const char* date, size_t lungime);
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: proceseaza_date_clare
+ * -----------------------------------------------------------------------------
+ * Datele asa cum le-a scris clientul (primite direct, sau iesite din
+ * decompresor): le asamblam, cautam mesajele complete si le procesam.
+ * date[lungime] trebuie sa poata fi scris (vezi livreaza_mesaj).
+ *
+ * RETURNEAZA:
+ *     1, sau 0 daca restul datelor (comprimat dupa HELLO) e un flux corupt
+ */
+static int proceseaza_date_clare(StareConexiune* conexiune, char* date, size_t lungime) {
+    char* zona;
+    size_t lungime_zona;
+    int era_comprimat = conexiune->flux_compresie != NULL;
+
+    /*
+     * Pas 1: Alegem unde cautam JSON-urile
+     *
+     * Cazul obisnuit: nu avem nimic in asteptare, deci cautam direct in
+     * datele primite, fara nicio copiere. Doar daca un JSON a venit in mai
+     * multe "bucati" (fragmente TCP) le asamblam in buffer-ul conexiunii.
+     */
+    if (conexiune->lungime_date == conexiune->inceput_date) {
+        zona = date;
+        lungime_zona = lungime;
+    } else {
+        if (!adauga_in_buffer(conexiune, date, lungime)) {
+            /* Fara memorie - pierdem mesajul neterminat si aceste date */
+            elibereaza_buffer(conexiune);
+            memset(&conexiune->scanare, 0, sizeof(conexiune->scanare));
+            return 1;
+        }
+
+        zona = conexiune->buffer_date + conexiune->inceput_date;
+        lungime_zona = conexiune->lungime_date - conexiune->inceput_date;
+    }
+
+    /*
+     * Pas 2: La inceputul conexiunii aflam cum sunt delimitate mesajele
+     */
+    if (conexiune->incadrare == INCADRARE_NEDETECTATA) {
+        detecteaza_incadrare(conexiune, zona, lungime_zona);
+    }
+
+    /*
+     * Pas 3: Procesam mesajele complete
+     *
+     * Mesajele incadrate merg direct la parser. Daca pe parcurs pierdem
+     * sincronizarea, restul datelor trece prin cautarea dupa acolade.
+     */
+    size_t consumat = 0;
+
+    if (conexiune->incadrare == INCADRARE_LUNGIME) {
+        consumat = extrage_mesaje_incadrate(conexiune, zona, lungime_zona);
+    }
+    if (conexiune->incadrare == INCADRARE_ACOLADE) {
+        consumat += extrage_mesaje_complete(conexiune, zona + consumat, lungime_zona - consumat);
+    }
+
+    /*
+     * Pe conexiunile incadrate mesajul de bun venit a plecat dupa HELLO
+     * (vezi negociaza_protocol). Fara incadrare nu putem primi binar,
+     * deci raspundem imediat - si cand o conexiune incadrata si-a pierdut
+     * sincronizarea inainte de primul mesaj.
+     */
+    if (conexiune->incadrare == INCADRARE_ACOLADE && !conexiune->bun_venit_trimis) {
+        trimite_bun_venit(conexiune);
+    }
+
+    /* Toate logurile din datele de acum intra in coada dintr-o data */
+    trimite_lotul();
+
+    /*
+     * Clientul a cerut compresie chiar acum (in HELLO): tot ce urmeaza
+     * dupa HELLO e deja comprimat si trece prin decompresor. Buffer-ul
+     * conexiunii va tine de acum datele decomprimate, asa ca il luam
+     * deoparte cat timp decomprimam restul din el.
+     */
+    if (!era_comprimat && conexiune->flux_compresie != NULL) {
+        char* vechi = (zona != date) ? conexiune->buffer_date : NULL;
+
+        conexiune->buffer_date = NULL;
+        elibereaza_buffer(conexiune);
+
+        int rezultat = 1;
+        if (consumat < lungime_zona) {
+            rezultat = decomprima_date(conexiune, zona + consumat, lungime_zona - consumat);
+        }
+        free(vechi);
+        return rezultat;
+    }
+
+    /*
+     * Pas 4: Pastram restul (mesajul incomplet) pentru data viitoare
+     *
+     * In buffer doar mutam inceputul dupa ce am consumat. Datele
+     * primite acum (cand nu aveam nimic in asteptare) le copiem.
+     */
+    if (consumat == lungime_zona) {
+        elibereaza_buffer(conexiune);
+        return 1;
+    }
+
+    if (zona != date) {
+        conexiune->inceput_date += consumat;
+        return 1;
+    }
+
+    if (!adauga_in_buffer(conexiune, zona + consumat, lungime_zona - consumat)) {
+        elibereaza_buffer(conexiune);
+        memset(&conexiune->scanare, 0, sizeof(conexiune->scanare));
+    }
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: primeste_decomprimate / decomprima_date
+ * -----------------------------------------------------------------------------
+ * Pe o conexiune comprimata, datele primite trec intai prin decompresor;
+ * ce iese merge pe drumul obisnuit (proceseaza_date_clare). Daca fluxul
+ * se strica, nu mai putem intelege nimic de la acest client: intoarcem 0
+ * si conexiunea e inchisa - clientul se reconecteaza, negociaza din nou
+ * compresia si trimite un cadru complet.
+ */
+static void primeste_decomprimate(void* context, char* date, size_t lungime) {
+    proceseaza_date_clare((StareConexiune*)context, date, lungime);
+}
+
+static int decomprima_date(StareConexiune* conexiune, const char* date, size_t lungime) {
+    return decomprima_flux(conexiune->flux_compresie, date, lungime, &conexiune->compresie,
+                           primeste_decomprimate, conexiune);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: proceseaza_date_primite
+ * -----------------------------------------------------------------------------
+ */
+int proceseaza_date_primite(StareConexiune* conexiune, char* date, size_t lungime) {
+    if (conexiune->flux_compresie != NULL) {
+        return decomprima_date(conexiune, date, lungime);
+    }
+
+    return proceseaza_date_clare(conexiune, date, lungime);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: mesaje_prea_mari
+ * -----------------------------------------------------------------------------
+ */
+unsigned long mesaje_prea_mari(void) {
+    return __atomic_load_n(&g_mesaje_prea_mari, __ATOMIC_RELAXED);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: loc_in_lista_clienti
+ * -----------------------------------------------------------------------------
+ * Se asigura ca lista de clienti mai are un loc liber, dubland-o la
+ * nevoie. Se apeleaza cu g_mutex_clienti blocat.
+ *
+ * RETURNEAZA:
+ *     1 daca e loc, 0 daca nu avem memorie (clientul nu apare in lista,
+ *     dar conexiunea merge mai departe)
+ */
+static int loc_in_lista_clienti(void) {
+    if (g_numar_clienti < g_capacitate_clienti) {
+        return 1;
+    }
+
+    int capacitate = g_capacitate_clienti ? g_capacitate_clienti * 2 : MAX_CLIENTI;
+
+    char** ip_uri = realloc(g_clienti_conectati, (size_t)capacitate * sizeof(char*));
+    if (ip_uri == NULL) {
+        return 0;
+    }
+    g_clienti_conectati = ip_uri;
+
+    const StatisticiCompresie** compresii = realloc(g_compresie_clienti,
+                                                    (size_t)capacitate * sizeof(StatisticiCompresie*));
+    if (compresii == NULL) {
+        return 0;
+    }
+    g_compresie_clienti = compresii;
+
+    g_capacitate_clienti = capacitate;
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: deschide_conexiune
+ * -----------------------------------------------------------------------------
+ */
+StareConexiune* deschide_conexiune(int socket_client, const char* ip_client) {
+    StareConexiune* conexiune = calloc(1, sizeof(StareConexiune));
+    if (conexiune == NULL) {
+        return NULL;
+    }
+
+    conexiune->socket = socket_client;
+    strncpy(conexiune->ip, ip_client, sizeof(conexiune->ip) - 1);
+
+    /*
+     * Pas 1: Adaugam clientul in lista de clienti conectati
+     *
+     * IMPORTANT: Folosim mutex pentru ca mai multe thread-uri pot incerca
+     * sa modifice lista simultan!
+     */
+    pthread_mutex_lock(&g_mutex_clienti);  /* Blocam accesul altora */
+
+    if (loc_in_lista_clienti()) {
+        /* strdup() creeaza o copie a string-ului (cu malloc intern) */
+        char* ip = strdup(conexiune->ip);
+        if (ip != NULL) {
+            g_clienti_conectati[g_numar_clienti] = ip;
+            g_compresie_clienti[g_numar_clienti] = &conexiune->compresie;
+            g_numar_clienti++;
+        }
+    }
+
+    pthread_mutex_unlock(&g_mutex_clienti);  /* Deblocam */
+
+    /* Mesajul de bun venit il trimitem dupa primii octeti primiti, cand
+     * stim daca clientul foloseste mesaje incadrate si ce protocol vrea
+     * (vezi trimite_bun_venit) */
+
+    return conexiune;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: inchide_conexiune
+ * -----------------------------------------------------------------------------
+ */
+void inchide_conexiune(StareConexiune* conexiune) {
+    /* Eliminam clientul din lista */
+    pthread_mutex_lock(&g_mutex_clienti);
+
+    for (int i = 0; i < g_numar_clienti; i++) {
+        if (g_compresie_clienti[i] == &conexiune->compresie) {
+            /* Eliberam memoria string-ului */
+            free(g_clienti_conectati[i]);
+
+            /* Mutam restul elementelor cu o pozitie la stanga */
+            for (int j = i; j < g_numar_clienti - 1; j++) {
+                g_clienti_conectati[j] = g_clienti_conectati[j + 1];
+                g_compresie_clienti[j] = g_compresie_clienti[j + 1];
+            }
+
+            g_numar_clienti--;
+            break;
+        }
+    }
+
+    pthread_mutex_unlock(&g_mutex_clienti);
+
+    /* Inchidem socket-ul si eliberam starea */
+    close(conexiune->socket);
+    opreste_decompresia(conexiune->flux_compresie);
+    free(conexiune->buffer_date);
+    free(conexiune);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: numar_threaduri_io
+ * -----------------------------------------------------------------------------
+ */
+int numar_threaduri_io(void) {
+    long numar_threaduri = NUMAR_THREADURI_IO;
+
+    if (numar_threaduri <= 0) {
+        numar_threaduri = sysconf(_SC_NPROCESSORS_ONLN);  /* Cate nuclee avem */
+    }
+    if (numar_threaduri < 1) {
+        numar_threaduri = 1;
+    }
+    if (numar_threaduri > MAX_THREADURI_IO) {
+        numar_threaduri = MAX_THREADURI_IO;
+    }
+
+    return (int)numar_threaduri;
+}
+
+
 /*
  * -----------------------------------------------------------------------------
  * IMPLEMENTARE: thread_gestionare_client
  * -----------------------------------------------------------------------------
- * 
+ *
  * Aceasta functie e executata de un thread separat pentru FIECARE client.
  * Gandeste-te la ea ca la un "angajat" dedicat unui singur client.
+ *
+ * E folosita doar cand reactorul epoll nu poate porni (vezi thread_server).
  */
 void* thread_gestionare_client(void* arg) {
     /*
      * Pas 1: Extragem informatiile despre client
-     * 
+     *
      * arg e un pointer generic (void*) pe care il convertim la tipul nostru.
      * Facem asta pentru ca pthread_create() cere void* ca parametru.
      */
     InfoClient* info = (InfoClient*)arg;
-    int socket_client = info->socket;
-    
-    char ip_client[64];
-    strncpy(ip_client, info->ip, sizeof(ip_client));
-    
+
+    /* Inregistram clientul si ii trimitem mesajul de bun venit */
+    StareConexiune* conexiune = deschide_conexiune(info->socket, info->ip);
+
+    if (conexiune == NULL) {
+        close(info->socket);
+        free(info);
+        return NULL;
+    }
+
     /* Eliberam structura - nu mai avem nevoie de ea
      * Datele importante le-am copiat deja */
     free(info);
-    
-    /*
-     * Pas 2: Adaugam clientul in lista de clienti conectati
-     * 
-     * IMPORTANT: Folosim mutex pentru ca mai multe thread-uri pot incerca
-     * sa modifice lista simultan!
-     */
-    pthread_mutex_lock(&g_mutex_clienti);  /* Blocam accesul altora */
-    
-    if (g_numar_clienti < MAX_CLIENTI) {
-        /* strdup() creeaza o copie a string-ului (cu malloc intern) */
-        g_clienti_conectati[g_numar_clienti] = strdup(ip_client);
-        g_numar_clienti++;
-    }
-    
-    pthread_mutex_unlock(&g_mutex_clienti);  /* Deblocam */
-    
-    /*
-     * Pas 3: Trimitem mesaj de confirmare catre client
-     * 
-     * Asta ii spune clientului ca s-a conectat cu succes.
-     */
-    char mesaj_bun_venit[512];
-    char timestamp[64];
-    obtine_timpul_curent(timestamp, sizeof(timestamp));
-    
-    snprintf(mesaj_bun_venit, sizeof(mesaj_bun_venit), 
-             "{\"connection_status\":\"connected\","
-             "\"message\":\"Conectat cu succes la server!\","
-             "\"server_port\":%d,"
-             "\"timestamp\":\"%s\"}\n",
-             SERVER_PORT, timestamp);
-    
-    /* send() trimite date prin socket
-     * Parametri: socket, date, lungime, flags (0 = default) */
-    send(socket_client, mesaj_bun_venit, strlen(mesaj_bun_venit), 0);
-    
+
     /*
-     * Pas 4: Bucla principala - primim date de la client
+     * Pas 2: Bucla principala - primim date de la client
      */
-    char buffer[DIMENSIUNE_BUFFER];
-    char buffer_date[DIMENSIUNE_BUFFER * 4] = "";  /* Buffer mai mare pentru JSON-uri fragmentate */
-    
+    char buffer[DIMENSIUNE_BUFFER + 1];  /* + octetul liber de dupa date */
+
     while (g_server_ruleaza) {
         /*
          * recv() citeste date de la client
          * BLOCHEAZA pana primeste ceva sau clientul se deconecteaza
-         * 
+         *
          * Returneaza:
          * - numar pozitiv = cati octeti am primit
          * - 0 = clientul s-a deconectat normal
          * - -1 = eroare
          */
-        ssize_t octeti_primiti = recv(socket_client, buffer, DIMENSIUNE_BUFFER - 1, 0);
-        
+        ssize_t octeti_primiti = recv(conexiune->socket, buffer, DIMENSIUNE_BUFFER, 0);
+
         if (octeti_primiti <= 0) {
             /* Clientul s-a deconectat sau eroare - iesim din bucla */
             break;
         }
-        
-        /* Adaugam terminatorul de string */
-        buffer[octeti_primiti] = '\0';
-        
-        /*
-         * Pas 5: Adaugam datele primite in buffer-ul nostru
-         * 
-         * De ce buffer separat? Pentru ca un JSON mare poate veni in mai
-         * multe "bucati" (fragmente TCP). Trebuie sa le asamblam.
-         */
-        size_t lungime_curenta = strlen(buffer_date);
-        
-        if (lungime_curenta + octeti_primiti < sizeof(buffer_date) - 1) {
-            strcat(buffer_date, buffer);
-        } else {
-            /* Buffer overflow - resetam (nu ar trebui sa se intample) */
-            strncpy(buffer_date, buffer, sizeof(buffer_date) - 1);
-        }
-        
-        /*
-         * Pas 6: Procesam JSON-urile complete din buffer
-         * 
-         * Un JSON e complet cand numarul de '{' e egal cu numarul de '}'.
-         * Trebuie sa fim atenti la ghilimele - nu numaram acoladele din string-uri.
-         */
-        char* start = buffer_date;
-        
-        while (*start) {
-            /* Sarim peste spatii */
-            while (*start && isspace(*start)) start++;
-            
-            /* Verificam daca incepe un JSON */
-            if (*start != '{') {
-                if (*start) start++;
-                continue;
-            }
-            
-            /* Numaram acoladele pentru a gasi sfarsitul JSON-ului */
-            int adancime = 0;
-            char* pozitie = start;
-            int in_string = 0;  /* Flag: suntem in interiorul unui string? */
-            
-            while (*pozitie) {
-                /* Detectam intrarea/iesirea din string-uri */
-                if (*pozitie == '"' && (pozitie == start || *(pozitie-1) != '\\')) {
-                    in_string = !in_string;
-                }
-                
-                /* Numaram acoladele doar daca nu suntem in string */
-                if (!in_string) {
-                    if (*pozitie == '{') {
-                        adancime++;
-                    }
-                    else if (*pozitie == '}') {
-                        adancime--;
-                        
-                        if (adancime == 0) {
-                            /* Am gasit un JSON complet! */
-                            pozitie++;  /* Include si ultima '}' */
-                            
-                            /* Extragem JSON-ul */
-                            size_t lungime_json = pozitie - start;
-                            char* json = malloc(lungime_json + 1);
-                            
-                            if (json != NULL) {
-                                strncpy(json, start, lungime_json);
-                                json[lungime_json] = '\0';
-                                
-                                /*
-                                 * Verificam tipul de JSON:
-                                 * - Daca contine "processes" -> e un snapshot (lista de procese)
-                                 * - Altfel -> e un singur proces
-                                 */
-                                if (strstr(json, "\"processes\"") != NULL) {
-                                    parseaza_json_snapshot(json, ip_client);
-                                } else {
-                                    /* Parsam ca proces individual si adaugam in lista */
-                                    LogEntry intrare;
-                                    if (parseaza_json_proces(json, &intrare, ip_client)) {
-                                        pthread_mutex_lock(&g_mutex_loguri);
-                                        
-                                        if (g_numar_loguri < MAX_LOGURI) {
-                                            g_lista_loguri[g_numar_loguri] = intrare;
-                                            g_numar_loguri++;
-                                        } else {
-                                            /* Lista plina - stergem primul (FIFO) */
-                                            memmove(&g_lista_loguri[0], &g_lista_loguri[1], 
-                                                    (MAX_LOGURI - 1) * sizeof(LogEntry));
-                                            g_lista_loguri[MAX_LOGURI - 1] = intrare;
-                                        }
-                                        
-                                        pthread_mutex_unlock(&g_mutex_loguri);
-                                    }
-                                }
-                                
-                                free(json);
-                            }
-                            
-                            /* Mutam restul buffer-ului la inceput */
-                            memmove(buffer_date, pozitie, strlen(pozitie) + 1);
-                            start = buffer_date;
-                            continue;  /* Continuam sa cautam alte JSON-uri */
-                        }
-                    }
-                }
-                pozitie++;
-            }
-            
-            /* Nu am gasit JSON complet - asteptam mai multe date */
+
+        /* Asamblam fragmentele si procesam JSON-urile complete
+         * (un flux comprimat corupt inchide conexiunea) */
+        if (!proceseaza_date_primite(conexiune, buffer, (size_t)octeti_primiti)) {
             break;
         }
     }
-    
+
     /*
-     * Pas 7: Clientul s-a deconectat - facem curatenie
+     * Pas 3: Clientul s-a deconectat - facem curatenie
      */
-    
-    /* Eliminam clientul din lista */
-    pthread_mutex_lock(&g_mutex_clienti);
-    
-    for (int i = 0; i < g_numar_clienti; i++) {
-        if (strcmp(g_clienti_conectati[i], ip_client) == 0) {
-            /* Eliberam memoria string-ului */
-            free(g_clienti_conectati[i]);
-            
-            /* Mutam restul elementelor cu o pozitie la stanga */
-            for (int j = i; j < g_numar_clienti - 1; j++) {
-                g_clienti_conectati[j] = g_clienti_conectati[j + 1];
-            }
-            
-            g_numar_clienti--;
-            break;
-        }
-    }
-    
-    pthread_mutex_unlock(&g_mutex_clienti);
-    
-    /* Inchidem socket-ul */
-    close(socket_client);
-    
+    inchide_conexiune(conexiune);
+
     return NULL;
 }
 
@@ -311,16 +874,40 @@ void* thread_server(void* arg) {
     /*
      * Pas 5: Incepem sa ascultam pentru conexiuni (listen)
      * 
-     * MAX_CLIENTI = cate conexiuni pot astepta in coada
+     * COADA_CONEXIUNI = cate conexiuni pot astepta in coada
      */
-    if (listen(g_socket_server, MAX_CLIENTI) < 0) {
+    if (listen(g_socket_server, COADA_CONEXIUNI) < 0) {
         perror("Eroare la listen");
         close(g_socket_server);
         return NULL;
     }
     
     /*
-     * Pas 6: Setam un timeout pentru accept()
+     * Pas 6: Pornim reactorul ales la pornire
+     * 
+     * Cateva thread-uri de I/O deservesc TOATE conexiunile. Functia se
+     * intoarce doar cand serverul se opreste. Daca un reactor nu poate
+     * porni (returneaza -1), coboram un nivel: io_uring -> epoll -> vechiul
+     * mod, cu un thread per client.
+     */
+    if (g_mod_retea == MOD_RETEA_IO_URING) {
+        if (ruleaza_reactor_io_uring(g_socket_server) == 0) {
+            close(g_socket_server);
+            return NULL;
+        }
+        g_mod_retea = MOD_RETEA_EPOLL;
+    }
+    
+    if (g_mod_retea == MOD_RETEA_EPOLL) {
+        if (ruleaza_reactor_epoll(g_socket_server) == 0) {
+            close(g_socket_server);
+            return NULL;
+        }
+        g_mod_retea = MOD_RETEA_THREADURI;
+    }
+    
+    /*
+     * Pas 7: Setam un timeout pentru accept()
      * 
      * Asta ne permite sa verificam periodic daca serverul trebuie oprit.
      * Fara timeout, accept() ar bloca la infinit.
@@ -331,7 +918,7 @@ void* thread_server(void* arg) {
     setsockopt(g_socket_server, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
     
     /*
-     * Pas 7: Bucla principala - acceptam clienti
+     * Pas 8: Bucla principala - acceptam clienti
      */
     while (g_server_ruleaza) {
         struct sockaddr_in adresa_client;
@@ -361,7 +948,7 @@ void* thread_server(void* arg) {
         }
         
         /*
-         * Pas 8: Cream structura cu informatiile clientului
+         * Pas 9: Cream structura cu informatiile clientului
          */
         InfoClient* info = malloc(sizeof(InfoClient));
         info->socket = socket_client;
@@ -372,7 +959,7 @@ void* thread_server(void* arg) {
                  ntohs(adresa_client.sin_port));      /* Converteste portul din format retea */
         
         /*
-         * Pas 9: Cream un thread nou pentru acest client
+         * Pas 10: Cream un thread nou pentru acest client
          * 
          * Fiecare client are propriul thread, asa pot comunica toti simultan.
          */
@@ -390,6 +977,24 @@ void* thread_server(void* arg) {
 }
 
 
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: recupereaza_simboluri
+ * -----------------------------------------------------------------------------
+ * Textele folosite de loguri si de starea host-urilor raman in tabela de
+ * simboluri; restul sunt recuperate (vezi tabela_simboluri.h).
+ */
+static void recupereaza_simboluri(void) {
+    if (!incepe_recuperare_simboluri()) {
+        return;  /* Nimic nou de la ultima recuperare */
+    }
+
+    marcheaza_simboluri_loguri();
+    marcheaza_simboluri_gazde();
+    termina_recuperare_simboluri();
+}
+
+
 /*
  * -----------------------------------------------------------------------------
  * IMPLEMENTARE: thread_refresh_automat
@@ -400,16 +1005,21 @@ void* thread_server(void* arg) {
 void* thread_refresh_automat(void* arg) {
     (void)arg;  /* Nefolosit */
     
-    int numar_anterior = 0;  /* Cate loguri erau la ultima verificare */
+    unsigned long numar_anterior = 0;  /* Cate loguri primisem la ultima verificare */
+    int secunde_pana_la_recuperare = PERIOADA_RECUPERARE_SIMBOLURI;
     
     while (g_server_ruleaza) {
         /* Asteptam 1 secunda */
         sleep(1);
         
-        /* Verificam daca s-a schimbat numarul de loguri */
-        pthread_mutex_lock(&g_mutex_loguri);
-        int numar_curent = g_numar_loguri;
-        pthread_mutex_unlock(&g_mutex_loguri);
+        if (--secunde_pana_la_recuperare == 0) {
+            secunde_pana_la_recuperare = PERIOADA_RECUPERARE_SIMBOLURI;
+            recupereaza_simboluri();
+        }
+        
+        /* Verificam daca au venit loguri noi
+         * (g_numar_loguri nu mai creste cand lista e plina) */
+        unsigned long numar_curent = __atomic_load_n(&g_total_loguri_primite, __ATOMIC_RELAXED);
         
         if (numar_curent != numar_anterior) {
             /* Au aparut loguri noi - actualizam ecranul */
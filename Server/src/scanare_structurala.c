@@ -0,0 +1,175 @@
+#include "scanare_structurala.h"
+
+#include <string.h>     /* Pentru memcpy(), memset() */
+
+#if defined(__x86_64__) || defined(__i386__)
+#define SCANARE_X86 1
+#include <immintrin.h>  /* Pentru instructiunile SSE4.2 / AVX2 */
+#endif
+
+
+/*
+ * Fiecare implementare primeste 32 de octeti si intoarce o "masca":
+ * bitul i e 1 daca octetul i e structural.
+ */
+typedef uint32_t (*FunctieMasca)(const char* bloc);
+
+#define OCTETI_MASCA 32
+
+
+/* Varianta simpla: un tabel cu 1 pe pozitiile caracterelor structurale */
+static const unsigned char g_este_structural[256] = {
+    ['\0'] = 1, ['"'] = 1, ['\\'] = 1,
+    ['{'] = 1, ['}'] = 1, ['['] = 1, [']'] = 1,
+};
+
+static uint32_t masca_simpla(const char* bloc) {
+    uint32_t masca = 0;
+
+    for (int i = 0; i < OCTETI_MASCA; i++) {
+        masca |= (uint32_t)g_este_structural[(unsigned char)bloc[i]] << i;
+    }
+    return masca;
+}
+
+
+#ifdef SCANARE_X86
+
+/*
+ * AVX2: 32 de octeti deodata. '[' (0x5B) si '{' (0x7B) difera doar prin
+ * bitul 0x20, la fel ']' si '}' - dupa un OR cu 0x20 ajung doua comparatii
+ * pentru toate patru.
+ */
+__attribute__((target("avx2")))
+static uint32_t masca_avx2(const char* bloc) {
+    __m256i octeti = _mm256_loadu_si256((const __m256i*)bloc);
+    __m256i fara_majuscula = _mm256_or_si256(octeti, _mm256_set1_epi8(0x20));
+
+    __m256i gasite = _mm256_cmpeq_epi8(octeti, _mm256_set1_epi8('"'));
+    gasite = _mm256_or_si256(gasite, _mm256_cmpeq_epi8(octeti, _mm256_set1_epi8('\\')));
+    gasite = _mm256_or_si256(gasite, _mm256_cmpeq_epi8(octeti, _mm256_setzero_si256()));
+    gasite = _mm256_or_si256(gasite, _mm256_cmpeq_epi8(fara_majuscula, _mm256_set1_epi8('{')));
+    gasite = _mm256_or_si256(gasite, _mm256_cmpeq_epi8(fara_majuscula, _mm256_set1_epi8('}')));
+
+    return (uint32_t)_mm256_movemask_epi8(gasite);
+}
+
+/*
+ * SSE4.2: PCMPESTRM compara fiecare din cei 16 octeti cu tot setul odata.
+ * Lungimile sunt date explicit, asa ca '\0' poate fi in set.
+ */
+#define MOD_PCMPESTRM (_SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_BIT_MASK)
+
+__attribute__((target("sse4.2")))
+static uint32_t masca_sse42(const char* bloc) {
+    const __m128i set = _mm_setr_epi8('"', '\\', '{', '}', '[', ']', '\0',
+                                      0, 0, 0, 0, 0, 0, 0, 0, 0);
+
+    __m128i jos = _mm_loadu_si128((const __m128i*)bloc);
+    __m128i sus = _mm_loadu_si128((const __m128i*)(bloc + 16));
+
+    uint32_t masca_jos = (uint32_t)_mm_cvtsi128_si32(_mm_cmpestrm(set, 7, jos, 16, MOD_PCMPESTRM));
+    uint32_t masca_sus = (uint32_t)_mm_cvtsi128_si32(_mm_cmpestrm(set, 7, sus, 16, MOD_PCMPESTRM));
+
+    return (masca_jos & 0xFFFF) | (masca_sus << 16);
+}
+
+#endif /* SCANARE_X86 */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: functie_masca
+ * -----------------------------------------------------------------------------
+ * Alege implementarea la primul apel. Daca doua thread-uri o aleg in
+ * acelasi timp, ajung la acelasi rezultat - nu avem nevoie de lacat.
+ */
+static FunctieMasca g_functie_masca = NULL;
+
+static FunctieMasca functie_masca(void) {
+    FunctieMasca functie = __atomic_load_n(&g_functie_masca, __ATOMIC_RELAXED);
+
+    if (functie == NULL) {
+        functie = masca_simpla;
+#ifdef SCANARE_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2")) {
+            functie = masca_avx2;
+        } else if (__builtin_cpu_supports("sse4.2")) {
+            functie = masca_sse42;
+        }
+#endif
+        __atomic_store_n(&g_functie_masca, functie, __ATOMIC_RELAXED);
+    }
+    return functie;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: indexeaza_structura
+ * -----------------------------------------------------------------------------
+ */
+size_t indexeaza_structura(const char* date, size_t lungime, uint16_t* pozitii) {
+    FunctieMasca masca_bloc = functie_masca();
+    size_t numar = 0;
+
+    if (lungime > MARIME_BLOC_STRUCTURAL) {
+        lungime = MARIME_BLOC_STRUCTURAL;
+    }
+
+    for (size_t bloc = 0; bloc < lungime; bloc += OCTETI_MASCA) {
+        uint32_t masca;
+
+        if (lungime - bloc >= OCTETI_MASCA) {
+            masca = masca_bloc(date + bloc);
+        } else {
+            /* Ultima bucata, incompleta: o copiem intr-un bloc intreg
+             * umplut cu un octet oarecare, nestructural */
+            char rest[OCTETI_MASCA];
+            memset(rest, ' ', sizeof(rest));
+            memcpy(rest, date + bloc, lungime - bloc);
+            masca = masca_bloc(rest);
+        }
+
+        /* Fiecare bit 1 e o pozitie; __builtin_ctz da cel mai de jos */
+        while (masca != 0) {
+            pozitii[numar++] = (uint16_t)(bloc + (size_t)__builtin_ctz(masca));
+            masca &= masca - 1;
+        }
+    }
+
+    return numar;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: urmatorul_structural
+ * -----------------------------------------------------------------------------
+ * Nu stim lungimea textului, doar ca se termina cu '\0'. Citim blocuri de
+ * 32 de octeti ALINIATE la 32: un astfel de bloc nu trece niciodata peste
+ * granita unei pagini de memorie, deci nu putem citi din memorie
+ * nealocata, chiar daca blocul se intinde dupa '\0' (la fel face si
+ * strlen din biblioteca standard). Bitii dinaintea lui "text" sunt
+ * ignorati, iar '\0' ne opreste inainte sa ne uitam la ce urmeaza.
+ */
+const char* urmatorul_structural(const char* text) {
+    FunctieMasca masca_bloc = functie_masca();
+
+    size_t decalaj = (uintptr_t)text & (OCTETI_MASCA - 1);
+    const char* bloc = text - decalaj;
+    uint32_t masca = masca_bloc(bloc) >> decalaj;
+
+    if (masca != 0) {
+        return text + __builtin_ctz(masca);
+    }
+
+    for (;;) {
+        bloc += OCTETI_MASCA;
+        masca = masca_bloc(bloc);
+        if (masca != 0) {
+            return bloc + __builtin_ctz(masca);
+        }
+    }
+}
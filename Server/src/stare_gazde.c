@@ -0,0 +1,419 @@
+#include "stare_gazde.h"
+#include "tabela_simboluri.h"
+#include "coduri_loguri.h"
+
+#include <stdlib.h>     /* Pentru calloc(), free() */
+#include <strings.h>    /* Pentru strncasecmp() */
+#include <pthread.h>
+
+
+/* Cu cate locuri porneste tabelul unui host (putere a lui 2) */
+#define CAPACITATE_INITIALA_PROCESE 64
+
+/* Cu cate locuri porneste lista de host-uri (putere a lui 2) */
+#define CAPACITATE_INITIALA_GAZDE 16
+
+
+/* Un loc din tabelul unui host: ultimul log stiut al unui PID */
+typedef struct {
+    uint32_t generatie;         /* 0 = loc liber */
+    LogEntry ultima;
+} LocProces;
+
+struct StareGazda {
+    IdSimbol hostname;
+    pthread_mutex_t mutex;      /* Un mesaj o data, pentru acest host */
+    LocProces* locuri;
+    uint32_t capacitate;        /* Putere a lui 2 (0 = nu avem memorie) */
+    uint32_t numar;
+    uint32_t generatie;         /* Generatia curenta (niciodata 0) */
+};
+
+/*
+ * Host-urile: o tabela hash dupa numarul hostname-ului (adresare
+ * deschisa, ca la simboluri). O stare odata creata nu se mai muta si nu
+ * se mai sterge pana la oprire - un client care se reconecteaza isi
+ * regaseste starea.
+ */
+static pthread_mutex_t g_mutex_gazde = PTHREAD_MUTEX_INITIALIZER;
+static StareGazda** g_gazde = NULL;     /* NULL = loc liber */
+static uint32_t g_capacitate_gazde = 0;
+static uint32_t g_numar_gazde = 0;
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: amesteca
+ * -----------------------------------------------------------------------------
+ * PID-urile si numerele de simboluri sunt mici si consecutive; le
+ * amestecam bitii ca sa nu se stranga toate in acelasi colt al tabelului.
+ */
+static inline uint32_t amesteca(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x45d9f3bu;
+    x ^= x >> 16;
+    return x;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: tip_snapshot
+ * -----------------------------------------------------------------------------
+ */
+TipSnapshot tip_snapshot(const char* text, size_t lungime) {
+    if (text == NULL) {
+        return SNAPSHOT_SIMPLU;
+    }
+    if (lungime == 8 && strncasecmp(text, "KEYFRAME", 8) == 0) {
+        return SNAPSHOT_CADRU_COMPLET;
+    }
+    if (lungime == 5 && strncasecmp(text, "DELTA", 5) == 0) {
+        return SNAPSHOT_DELTA;
+    }
+    return SNAPSHOT_SIMPLU;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: loc_proces
+ * -----------------------------------------------------------------------------
+ * Locul PID-ului in tabel: cel in care e deja, sau locul liber in care ar
+ * trebui pus. Tabelul nu e niciodata plin (vezi creste_tabel).
+ */
+static LocProces* loc_proces(LocProces* locuri, uint32_t capacitate, int pid) {
+    uint32_t masca = capacitate - 1;
+    uint32_t i = amesteca((uint32_t)pid) & masca;
+
+    while (locuri[i].generatie != 0 && locuri[i].ultima.pid != pid) {
+        i = (i + 1) & masca;
+    }
+    return &locuri[i];
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: muta_procese
+ * -----------------------------------------------------------------------------
+ * Muta intr-un tabel nou, gol, procesele din generatia 'generatie' (sau
+ * pe toate, daca generatia e 0) si elibereaza tabelul vechi.
+ *
+ * RETURNEAZA:
+ *     1 daca a mers, 0 daca nu avem memorie (tabelul vechi ramane)
+ */
+static int muta_procese(StareGazda* gazda, uint32_t capacitate_noua, uint32_t generatie) {
+    LocProces* noi = calloc(capacitate_noua, sizeof(LocProces));
+    if (noi == NULL) {
+        return 0;
+    }
+
+    uint32_t numar = 0;
+    for (uint32_t i = 0; i < gazda->capacitate; i++) {
+        const LocProces* vechi = &gazda->locuri[i];
+
+        if (vechi->generatie != 0 && (generatie == 0 || vechi->generatie == generatie)) {
+            *loc_proces(noi, capacitate_noua, vechi->ultima.pid) = *vechi;
+            numar++;
+        }
+    }
+
+    free(gazda->locuri);
+    gazda->locuri = noi;
+    gazda->capacitate = capacitate_noua;
+    gazda->numar = numar;
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: creste_tabel
+ * -----------------------------------------------------------------------------
+ * Tinem tabelul cel mult 70% plin, ca sirurile de locuri ocupate (pe care
+ * le parcurgem la cautare) sa ramana scurte. Se dubleaza cand e nevoie.
+ *
+ * RETURNEAZA:
+ *     1 daca mai e loc pentru un proces nou, 0 daca nu avem memorie
+ */
+static int creste_tabel(StareGazda* gazda) {
+    if (gazda->capacitate == 0) {
+        return muta_procese(gazda, CAPACITATE_INITIALA_PROCESE, 0);
+    }
+
+    if ((uint64_t)(gazda->numar + 1) * 10 <= (uint64_t)gazda->capacitate * 7) {
+        return 1;
+    }
+
+    return muta_procese(gazda, gazda->capacitate * 2, 0);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: gaseste_gazda
+ * -----------------------------------------------------------------------------
+ * Starea unui host, creata la primul mesaj. Se apeleaza cu
+ * g_mutex_gazde blocat.
+ */
+static StareGazda* gaseste_gazda(IdSimbol hostname) {
+    /* Pas 1: Lista de host-uri e cel mult pe jumatate plina */
+    if ((g_numar_gazde + 1) * 2 > g_capacitate_gazde) {
+        uint32_t capacitate = g_capacitate_gazde ? g_capacitate_gazde * 2 : CAPACITATE_INITIALA_GAZDE;
+        StareGazda** noi = calloc(capacitate, sizeof(StareGazda*));
+        if (noi == NULL) {
+            return NULL;
+        }
+
+        for (uint32_t i = 0; i < g_capacitate_gazde; i++) {
+            if (g_gazde[i] != NULL) {
+                uint32_t j = amesteca(g_gazde[i]->hostname) & (capacitate - 1);
+                while (noi[j] != NULL) {
+                    j = (j + 1) & (capacitate - 1);
+                }
+                noi[j] = g_gazde[i];
+            }
+        }
+
+        free(g_gazde);
+        g_gazde = noi;
+        g_capacitate_gazde = capacitate;
+    }
+
+    /* Pas 2: Cautam host-ul */
+    uint32_t masca = g_capacitate_gazde - 1;
+    uint32_t i = amesteca(hostname) & masca;
+
+    while (g_gazde[i] != NULL) {
+        if (g_gazde[i]->hostname == hostname) {
+            return g_gazde[i];
+        }
+        i = (i + 1) & masca;
+    }
+
+    /* Pas 3: Nu exista - o cream (tabelul de procese vine la primul proces) */
+    StareGazda* gazda = calloc(1, sizeof(StareGazda));
+    if (gazda == NULL) {
+        return NULL;
+    }
+
+    gazda->hostname = hostname;
+    gazda->generatie = 1;
+    pthread_mutex_init(&gazda->mutex, NULL);
+
+    g_gazde[i] = gazda;
+    g_numar_gazde++;
+    return gazda;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: deschide_stare_gazda / inchide_stare_gazda
+ * -----------------------------------------------------------------------------
+ */
+StareGazda* deschide_stare_gazda(IdSimbol hostname, TipSnapshot tip) {
+    pthread_mutex_lock(&g_mutex_gazde);
+    StareGazda* gazda = gaseste_gazda(hostname);
+    pthread_mutex_unlock(&g_mutex_gazde);
+
+    if (gazda == NULL) {
+        return NULL;
+    }
+
+    pthread_mutex_lock(&gazda->mutex);
+
+    /* Cadru complet: procesele primite de acum primesc o generatie noua */
+    if (tip == SNAPSHOT_CADRU_COMPLET) {
+        gazda->generatie++;
+        if (gazda->generatie == 0) {
+            gazda->generatie = 1;  /* 0 inseamna loc liber */
+        }
+    }
+
+    return gazda;
+}
+
+void inchide_stare_gazda(StareGazda* gazda, TipSnapshot tip) {
+    if (gazda == NULL) {
+        return;
+    }
+
+    /*
+     * Cadru complet: ce a ramas cu alta generatie nu mai exista pe host.
+     * Mutam doar procesele ramase intr-un tabel nou - e mai simplu decat
+     * sa stergem din mijlocul sirurilor de locuri ocupate, si se intampla
+     * doar o data la cateva cicluri. Daca nu avem memorie, cei disparuti
+     * raman pana la urmatorul cadru complet.
+     */
+    if (tip == SNAPSHOT_CADRU_COMPLET && gazda->capacitate > 0) {
+        muta_procese(gazda, gazda->capacitate, gazda->generatie);
+    }
+
+    pthread_mutex_unlock(&gazda->mutex);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: actualizeaza_proces
+ * -----------------------------------------------------------------------------
+ */
+void actualizeaza_proces(StareGazda* gazda, LogEntry* intrare, unsigned int trimise) {
+    if (!creste_tabel(gazda)) {
+        return;  /* Fara memorie: logul pleaca asa cum a venit */
+    }
+
+    LocProces* loc = loc_proces(gazda->locuri, gazda->capacitate, intrare->pid);
+
+    /*
+     * Pas 1: Procesul e cunoscut - ce nu a venit in mesaj nu s-a schimbat
+     */
+    if (loc->generatie != 0) {
+        const LogEntry* vechi = &loc->ultima;
+
+        if (!(trimise & TRIMIS_NUME)) {
+            intrare->nume = vechi->nume;
+        }
+        if (!(trimise & TRIMIS_UTILIZATOR)) {
+            intrare->utilizator = vechi->utilizator;
+        }
+        if (!(trimise & TRIMIS_MESAJ)) {
+            intrare->mesaj = vechi->mesaj;
+        }
+        if (!(trimise & TRIMIS_STATUS)) {
+            intrare->status = vechi->status;
+            intrare->cod_status = vechi->cod_status;
+        }
+        if (!(trimise & TRIMIS_CPU)) {
+            intrare->procent_cpu = vechi->procent_cpu;
+        }
+        if (!(trimise & TRIMIS_MEMORIE)) {
+            intrare->memorie_kb = vechi->memorie_kb;
+        }
+
+        /* Nivelul lipsa il deducem din nou, din valorile completate */
+        if (!(trimise & TRIMIS_NIVEL)) {
+            intrare->cod_nivel = deduce_nivel(intrare->cod_status, intrare->procent_cpu,
+                                              intrare->memorie_kb);
+            intrare->nivel = interneaza(nume_nivel(intrare->cod_nivel));
+        }
+    } else {
+        gazda->numar++;
+    }
+
+    /*
+     * Pas 2: Asta e de acum starea procesului
+     */
+    loc->ultima = *intrare;
+    loc->generatie = gazda->generatie;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: elimina_proces
+ * -----------------------------------------------------------------------------
+ * Stergerea dintr-un tabel cu cautare liniara: nu putem lasa pur si
+ * simplu locul gol, ar rupe sirul pentru procesele de dupa el. Le mutam
+ * inapoi, pe rand, pe cele care si-ar fi gasit locul mai devreme.
+ */
+void elimina_proces(StareGazda* gazda, int pid) {
+    if (gazda->capacitate == 0) {
+        return;
+    }
+
+    uint32_t masca = gazda->capacitate - 1;
+    LocProces* loc = loc_proces(gazda->locuri, gazda->capacitate, pid);
+    if (loc->generatie == 0) {
+        return;  /* Nu il stiam */
+    }
+
+    uint32_t gol = (uint32_t)(loc - gazda->locuri);
+    uint32_t i = gol;
+
+    while (1) {
+        i = (i + 1) & masca;
+        if (gazda->locuri[i].generatie == 0) {
+            break;
+        }
+
+        /* Locul in care ar fi vrut sa stea: daca nu e intre 'gol' si 'i'
+         * (mergand circular), il putem muta in 'gol' */
+        uint32_t dorit = amesteca((uint32_t)gazda->locuri[i].ultima.pid) & masca;
+        if (((i - dorit) & masca) >= ((i - gol) & masca)) {
+            gazda->locuri[gol] = gazda->locuri[i];
+            gol = i;
+        }
+    }
+
+    gazda->locuri[gol].generatie = 0;
+    gazda->numar--;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: elibereaza_stari_gazde
+ * -----------------------------------------------------------------------------
+ */
+void elibereaza_stari_gazde(void) {
+    pthread_mutex_lock(&g_mutex_gazde);
+
+    for (uint32_t i = 0; i < g_capacitate_gazde; i++) {
+        if (g_gazde[i] != NULL) {
+            pthread_mutex_destroy(&g_gazde[i]->mutex);
+            free(g_gazde[i]->locuri);
+            free(g_gazde[i]);
+        }
+    }
+
+    free(g_gazde);
+    g_gazde = NULL;
+    g_capacitate_gazde = 0;
+    g_numar_gazde = 0;
+
+    pthread_mutex_unlock(&g_mutex_gazde);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: marcheaza_simboluri_gazde
+ * -----------------------------------------------------------------------------
+ * Lacatul unui host e luat doar cu g_mutex_gazde deja luat (niciodata
+ * invers), deci nu ne putem bloca reciproc cu un mesaj.
+ */
+void marcheaza_simboluri_gazde(void) {
+    pthread_mutex_lock(&g_mutex_gazde);
+
+    for (uint32_t i = 0; i < g_capacitate_gazde; i++) {
+        StareGazda* gazda = g_gazde[i];
+        if (gazda == NULL) {
+            continue;
+        }
+
+        pthread_mutex_lock(&gazda->mutex);
+
+        marcheaza_simbol(gazda->hostname);
+        for (uint32_t j = 0; j < gazda->capacitate; j++) {
+            const LogEntry* ultima = &gazda->locuri[j].ultima;
+            if (gazda->locuri[j].generatie == 0) {
+                continue;
+            }
+
+            marcheaza_simbol(ultima->nume);
+            marcheaza_simbol(ultima->nivel);
+            marcheaza_simbol(ultima->status);
+            marcheaza_simbol(ultima->utilizator);
+            marcheaza_simbol(ultima->mesaj);
+            marcheaza_simbol(ultima->hostname);
+            marcheaza_simbol(ultima->ip_client);
+        }
+
+        pthread_mutex_unlock(&gazda->mutex);
+    }
+
+    pthread_mutex_unlock(&g_mutex_gazde);
+}
@@ -0,0 +1,548 @@
+#include "stocare_loguri.h"
+#include "structuri_date.h"
+#include "culori_si_configurari.h"
+#include "tabela_simboluri.h"
+#include "utilitare.h"
+
+#include <string.h>     /* Pentru memset() */
+#include <pthread.h>
+
+
+/*
+ * Un shard: coloanele buffer-ului circular si lacatul lui.
+ *
+ * Logurile NU stau ca un array de LogEntry ("rand cu rand"), ci pe
+ * coloane: toate nivelurile unul dupa altul, toate PID-urile unul dupa
+ * altul, etc. Logul de pe pozitia p e format din elementul p al fiecarei
+ * coloane. Un filtru dupa nivel citeste doar coloana de coduri de nivel -
+ * 64 de loguri intr-o linie de cache - in loc sa treaca prin logurile
+ * intregi.
+ *
+ * Pe langa fiecare log tinem si "ordinea" in care a fost primit (un numar
+ * global, crescator). In fiecare shard ordinea creste de la cel mai vechi
+ * la cel mai nou, asa ca interclasarea dupa ea reface ordinea sosirii.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    int inceput;                /* Pozitia celui mai vechi log */
+    int numar;                  /* Cate loguri are shard-ul */
+
+    /* Coloanele citite la interclasare si la filtrare */
+    unsigned long ordine[MAX_LOGURI];
+    int64_t timestamp_ns[MAX_LOGURI];
+    unsigned char cod_nivel[MAX_LOGURI];    /* NivelLog */
+    unsigned char cod_status[MAX_LOGURI];   /* StatusProces */
+
+    /* Coloanele numerice */
+    int64_t primit_ns[MAX_LOGURI];
+    int pid[MAX_LOGURI];
+    double procent_cpu[MAX_LOGURI];
+    unsigned long memorie_kb[MAX_LOGURI];
+
+    /* Restul textelor (numere din tabela de simboluri) */
+    IdSimbol nume[MAX_LOGURI];
+    IdSimbol nivel[MAX_LOGURI];
+    IdSimbol status[MAX_LOGURI];
+    IdSimbol utilizator[MAX_LOGURI];
+    IdSimbol mesaj[MAX_LOGURI];
+    IdSimbol hostname[MAX_LOGURI];
+    IdSimbol ip_client[MAX_LOGURI];
+    uint16_t port_client[MAX_LOGURI];
+} ShardLoguri;
+
+/* Un log din lista interclasata: shard-ul lui si pozitia in shard */
+typedef struct {
+    int shard;
+    int pozitie;
+} ReferintaLog;
+
+static ShardLoguri g_sharduri[NUMAR_SHARDURI];
+
+/* Initializatorul de mutex nu merge pe elementele unui array static, asa
+ * ca le initializam la prima folosire */
+static pthread_once_t g_initializare = PTHREAD_ONCE_INIT;
+
+/* Lista interclasata, refacuta la fiecare blocheaza_loguri() */
+static ReferintaLog g_vedere[NUMAR_SHARDURI * MAX_LOGURI];
+
+/* Indicii care au trecut ultimul filtreaza_loguri() */
+static int g_indici_filtrati[NUMAR_SHARDURI * MAX_LOGURI];
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: initializeaza_sharduri
+ * -----------------------------------------------------------------------------
+ */
+static void initializeaza_sharduri(void) {
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        pthread_mutex_init(&g_sharduri[i].mutex, NULL);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: pozitie_in_shard
+ * -----------------------------------------------------------------------------
+ * Traduce un index logic (0 = cel mai vechi) in pozitia din array. Dupa
+ * ultima pozitie o luam de la capat - o scadere e mai ieftina decat un
+ * modulo.
+ */
+static int pozitie_in_shard(const ShardLoguri* shard, int index) {
+    int pozitie = shard->inceput + index;
+
+    if (pozitie >= MAX_LOGURI) {
+        pozitie -= MAX_LOGURI;
+    }
+
+    return pozitie;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: shard_pentru_log
+ * -----------------------------------------------------------------------------
+ * Acelasi host are mereu acelasi numar de simbol, asa ca amestecam direct
+ * numarul (hash multiplicativ) - nu mai citim textul.
+ */
+int shard_pentru_log(const LogEntry* intrare) {
+    IdSimbol cheie = intrare->hostname != SIMBOL_GOL ? intrare->hostname : intrare->ip_client;
+    unsigned int hash = (unsigned int)cheie * 2654435761u;
+
+    return (int)((hash >> 16) % NUMAR_SHARDURI);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: adauga_loguri
+ * -----------------------------------------------------------------------------
+ */
+void adauga_loguri(int index_shard, const LogEntry* intrari, int numar) {
+    if (numar <= 0) {
+        return;
+    }
+
+    pthread_once(&g_initializare, initializeaza_sharduri);
+    ShardLoguri* shard = &g_sharduri[index_shard];
+
+    pthread_mutex_lock(&shard->mutex);
+
+    /*
+     * Numerele de ordine ale acestor loguri. Le luam sub lacatul shard-ului:
+     * altfel doi scriitori ai aceluiasi shard le-ar putea scrie invers si
+     * shard-ul n-ar mai fi sortat dupa ordine (interclasarea se bazeaza pe asta)
+     */
+    unsigned long prima_ordine = __atomic_fetch_add(&g_total_loguri_primite,
+                                                    (unsigned long)numar, __ATOMIC_RELAXED);
+
+    /* Din mai mult de MAX_LOGURI loguri ar ramane oricum doar ultimele */
+    if (numar > MAX_LOGURI) {
+        prima_ordine += (unsigned long)(numar - MAX_LOGURI);
+        intrari += numar - MAX_LOGURI;
+        numar = MAX_LOGURI;
+    }
+
+    /*
+     * Pas 1: Impartim fiecare log pe coloane, dupa cel mai nou (cand
+     * shard-ul e plin, asta inseamna peste cele mai vechi)
+     */
+    int pozitie = pozitie_in_shard(shard, shard->numar);
+
+    for (int i = 0; i < numar; i++) {
+        const LogEntry* intrare = &intrari[i];
+
+        shard->ordine[pozitie] = prima_ordine + (unsigned long)i;
+        shard->timestamp_ns[pozitie] = intrare->timestamp_ns;
+        shard->primit_ns[pozitie] = intrare->primit_ns;
+        shard->cod_nivel[pozitie] = (unsigned char)intrare->cod_nivel;
+        shard->cod_status[pozitie] = (unsigned char)intrare->cod_status;
+        shard->nivel[pozitie] = intrare->nivel;
+        shard->pid[pozitie] = intrare->pid;
+        shard->procent_cpu[pozitie] = intrare->procent_cpu;
+        shard->memorie_kb[pozitie] = intrare->memorie_kb;
+        shard->nume[pozitie] = intrare->nume;
+        shard->status[pozitie] = intrare->status;
+        shard->utilizator[pozitie] = intrare->utilizator;
+        shard->mesaj[pozitie] = intrare->mesaj;
+        shard->hostname[pozitie] = intrare->hostname;
+        shard->ip_client[pozitie] = intrare->ip_client;
+        shard->port_client[pozitie] = intrare->port_client;
+
+        if (++pozitie == MAX_LOGURI) {
+            pozitie = 0;
+        }
+    }
+
+    /*
+     * Pas 2: Actualizam numarul si, daca am suprascris loguri vechi,
+     * inceputul shard-ului
+     */
+    int numar_nou = shard->numar + numar;
+
+    if (numar_nou > MAX_LOGURI) {
+        shard->inceput = pozitie_in_shard(shard, numar_nou - MAX_LOGURI);
+        numar_nou = MAX_LOGURI;
+    }
+
+    /* Atomic - numar_total_loguri() il citeste fara lacat */
+    __atomic_store_n(&shard->numar, numar_nou, __ATOMIC_RELAXED);
+
+    pthread_mutex_unlock(&shard->mutex);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: adauga_log
+ * -----------------------------------------------------------------------------
+ */
+void adauga_log(const LogEntry* intrare) {
+    adauga_loguri(shard_pentru_log(intrare), intrare, 1);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: goleste_loguri
+ * -----------------------------------------------------------------------------
+ */
+void goleste_loguri(void) {
+    pthread_once(&g_initializare, initializeaza_sharduri);
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        pthread_mutex_lock(&g_sharduri[i].mutex);
+        g_sharduri[i].inceput = 0;
+        __atomic_store_n(&g_sharduri[i].numar, 0, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&g_sharduri[i].mutex);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: ia_lacatele / elibereaza_lacatele
+ * -----------------------------------------------------------------------------
+ * g_mutex_loguri si lacatele tuturor shard-urilor - mereu in aceeasi
+ * ordine, ca sa nu ne blocam reciproc cu alt cititor.
+ */
+static void ia_lacatele(void) {
+    pthread_once(&g_initializare, initializeaza_sharduri);
+
+    pthread_mutex_lock(&g_mutex_loguri);
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        pthread_mutex_lock(&g_sharduri[i].mutex);
+    }
+}
+
+static void elibereaza_lacatele(void) {
+    for (int i = NUMAR_SHARDURI - 1; i >= 0; i--) {
+        pthread_mutex_unlock(&g_sharduri[i].mutex);
+    }
+    pthread_mutex_unlock(&g_mutex_loguri);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: blocheaza_loguri
+ * -----------------------------------------------------------------------------
+ */
+void blocheaza_loguri(void) {
+    /*
+     * Pas 1: Luam lacatele
+     */
+    ia_lacatele();
+
+    /*
+     * Pas 2: Interclasam shard-urile
+     *
+     * Fiecare shard e deja in ordinea sosirii. La fiecare pas alegem
+     * dintre "capetele" shard-urilor (sunt doar cateva) logul sosit primul.
+     * Citim doar coloana ordine.
+     *
+     * NU interclasam dupa timestamp: el vine de la client (ceasul agentului)
+     * si un shard nu e sortat dupa el - interclasarea unor liste nesortate
+     * nu ar da nici ordinea timpului, nici pe cea a sosirii.
+     */
+    int urmatorul[NUMAR_SHARDURI] = {0};
+    int total = 0;
+
+    while (1) {
+        int ales = -1;
+        int pozitie_aleasa = 0;
+        unsigned long ordine_aleasa = 0;
+
+        for (int i = 0; i < NUMAR_SHARDURI; i++) {
+            const ShardLoguri* shard = &g_sharduri[i];
+            if (urmatorul[i] >= shard->numar) {
+                continue;
+            }
+
+            int pozitie = pozitie_in_shard(shard, urmatorul[i]);
+
+            if (ales < 0 || shard->ordine[pozitie] < ordine_aleasa) {
+                ales = i;
+                pozitie_aleasa = pozitie;
+                ordine_aleasa = shard->ordine[pozitie];
+            }
+        }
+
+        if (ales < 0) {
+            break;  /* Am epuizat toate shard-urile */
+        }
+
+        g_vedere[total].shard = ales;
+        g_vedere[total].pozitie = pozitie_aleasa;
+        total++;
+        urmatorul[ales]++;
+    }
+
+    g_numar_loguri = total;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: deblocheaza_loguri
+ * -----------------------------------------------------------------------------
+ */
+void deblocheaza_loguri(void) {
+    elibereaza_lacatele();
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: obtine_log
+ * -----------------------------------------------------------------------------
+ * Reface randul din coloane.
+ */
+static void citeste_rand(const ShardLoguri* shard, int p, LogEntry* intrare) {
+    intrare->pid = shard->pid[p];
+    intrare->nume = shard->nume[p];
+    intrare->status = shard->status[p];
+    intrare->cod_status = (StatusProces)shard->cod_status[p];
+    intrare->procent_cpu = shard->procent_cpu[p];
+    intrare->memorie_kb = shard->memorie_kb[p];
+    intrare->utilizator = shard->utilizator[p];
+    intrare->mesaj = shard->mesaj[p];
+    intrare->nivel = shard->nivel[p];
+    intrare->cod_nivel = (NivelLog)shard->cod_nivel[p];
+    intrare->timestamp_ns = shard->timestamp_ns[p];
+    intrare->primit_ns = shard->primit_ns[p];
+    intrare->ip_client = shard->ip_client[p];
+    intrare->port_client = shard->port_client[p];
+    intrare->hostname = shard->hostname[p];
+}
+
+void obtine_log(int index, LogEntry* intrare) {
+    citeste_rand(&g_sharduri[g_vedere[index].shard], g_vedere[index].pozitie, intrare);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: contine_textul
+ * -----------------------------------------------------------------------------
+ * Cautarea de text: singurul filtru care are nevoie de string-uri, si
+ * doar din coloanele in care cautam.
+ */
+static int contine_textul(const ShardLoguri* shard, int p, const char* text) {
+    return contine_text_insensitiv(text_simbol(shard->nume[p]), text) ||
+           contine_text_insensitiv(text_simbol(shard->utilizator[p]), text) ||
+           contine_text_insensitiv(text_simbol(shard->mesaj[p]), text) ||
+           contine_text_insensitiv(text_simbol(shard->status[p]), text) ||
+           contine_text_insensitiv(text_simbol(shard->hostname[p]), text);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: trece_filtrul
+ * -----------------------------------------------------------------------------
+ */
+static int trece_filtrul(const ShardLoguri* shard, int p, const FiltruLoguri* filtru) {
+    if (filtru->nivel != NIVEL_NECUNOSCUT && shard->cod_nivel[p] != filtru->nivel) {
+        return 0;
+    }
+    if (filtru->status != STATUS_NECUNOSCUT && shard->cod_status[p] != filtru->status) {
+        return 0;
+    }
+    if (filtru->text != NULL && filtru->text[0] != '\0' && !contine_textul(shard, p, filtru->text)) {
+        return 0;
+    }
+
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: filtreaza_loguri
+ * -----------------------------------------------------------------------------
+ */
+const int* filtreaza_loguri(const FiltruLoguri* filtru, int* numar_gasite) {
+    int gasite = 0;
+
+    for (int i = 0; i < g_numar_loguri; i++) {
+        if (trece_filtrul(&g_sharduri[g_vedere[i].shard], g_vedere[i].pozitie, filtru)) {
+            g_indici_filtrati[gasite++] = i;
+        }
+    }
+
+    *numar_gasite = gasite;
+    return g_indici_filtrati;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: numara_pe_niveluri
+ * -----------------------------------------------------------------------------
+ * Parcurgem doar coloana de coduri de nivel a fiecarui shard, direct
+ * (ordinea nu conteaza cand doar numaram).
+ */
+void numara_pe_niveluri(int numar_pe_nivel[NUMAR_NIVELURI]) {
+    memset(numar_pe_nivel, 0, NUMAR_NIVELURI * sizeof(int));
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        const ShardLoguri* shard = &g_sharduri[i];
+
+        for (int j = 0; j < shard->numar; j++) {
+            numar_pe_nivel[shard->cod_nivel[pozitie_in_shard(shard, j)]]++;
+        }
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: numar_total_loguri
+ * -----------------------------------------------------------------------------
+ */
+int numar_total_loguri(void) {
+    int total = 0;
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        total += __atomic_load_n(&g_sharduri[i].numar, __ATOMIC_RELAXED);
+    }
+
+    return total;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: marcheaza_simboluri_loguri
+ * -----------------------------------------------------------------------------
+ * Ca la numarare, ordinea nu conteaza - trecem direct prin coloanele de
+ * texte ale fiecarui shard.
+ */
+void marcheaza_simboluri_loguri(void) {
+    pthread_once(&g_initializare, initializeaza_sharduri);
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        const ShardLoguri* shard = &g_sharduri[i];
+
+        pthread_mutex_lock(&g_sharduri[i].mutex);
+
+        for (int j = 0; j < shard->numar; j++) {
+            int p = pozitie_in_shard(shard, j);
+
+            marcheaza_simbol(shard->nume[p]);
+            marcheaza_simbol(shard->nivel[p]);
+            marcheaza_simbol(shard->status[p]);
+            marcheaza_simbol(shard->utilizator[p]);
+            marcheaza_simbol(shard->mesaj[p]);
+            marcheaza_simbol(shard->hostname[p]);
+            marcheaza_simbol(shard->ip_client[p]);
+        }
+
+        pthread_mutex_unlock(&g_sharduri[i].mutex);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: primul_de_la
+ * -----------------------------------------------------------------------------
+ * Indexul logic (0 = cel mai vechi) al primului log din shard cu ordinea
+ * cel putin 'ordine'. Shard-ul e sortat dupa ordine, deci cautam binar.
+ */
+static int primul_de_la(const ShardLoguri* shard, unsigned long ordine) {
+    int stanga = 0;
+    int dreapta = shard->numar;
+
+    while (stanga < dreapta) {
+        int mijloc = stanga + (dreapta - stanga) / 2;
+
+        if (shard->ordine[pozitie_in_shard(shard, mijloc)] < ordine) {
+            stanga = mijloc + 1;
+        } else {
+            dreapta = mijloc;
+        }
+    }
+
+    return stanga;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: copiaza_loguri
+ * -----------------------------------------------------------------------------
+ * Aceeasi interclasare ca in blocheaza_loguri, dar pornita de la cursor
+ * si oprita dupa 'maxim' loguri - lacatele stau luate doar cat copiem o
+ * bucata, nu cat parcurgem toata lista.
+ */
+int copiaza_loguri(const FiltruLoguri* filtru, unsigned long* de_la, unsigned long pana_la,
+                   LogEntry* destinatie, int maxim) {
+    int urmatorul[NUMAR_SHARDURI];
+    int copiate = 0;
+
+    ia_lacatele();
+
+    for (int i = 0; i < NUMAR_SHARDURI; i++) {
+        urmatorul[i] = primul_de_la(&g_sharduri[i], *de_la);
+    }
+
+    while (copiate < maxim) {
+        int ales = -1;
+        int pozitie_aleasa = 0;
+        unsigned long ordine_aleasa = 0;
+
+        for (int i = 0; i < NUMAR_SHARDURI; i++) {
+            const ShardLoguri* shard = &g_sharduri[i];
+            if (urmatorul[i] >= shard->numar) {
+                continue;
+            }
+
+            int pozitie = pozitie_in_shard(shard, urmatorul[i]);
+
+            if (ales < 0 || shard->ordine[pozitie] < ordine_aleasa) {
+                ales = i;
+                pozitie_aleasa = pozitie;
+                ordine_aleasa = shard->ordine[pozitie];
+            }
+        }
+
+        if (ales < 0 || ordine_aleasa >= pana_la) {
+            break;
+        }
+
+        urmatorul[ales]++;
+        *de_la = ordine_aleasa + 1;
+
+        if (trece_filtrul(&g_sharduri[ales], pozitie_aleasa, filtru)) {
+            citeste_rand(&g_sharduri[ales], pozitie_aleasa, &destinatie[copiate++]);
+        }
+    }
+
+    elibereaza_lacatele();
+
+    return copiate;
+}
@@ -0,0 +1,754 @@
+#include "tabela_simboluri.h"
+#include "culori_si_configurari.h"
+
+#include <stdio.h>      /* Pentru fprintf() */
+#include <stdlib.h>     /* Pentru malloc(), calloc(), realloc(), free() */
+#include <string.h>     /* Pentru memcpy(), memcmp(), strlen(), strrchr() */
+#include <pthread.h>
+
+
+/* Textele sunt numerotate in blocuri de cate SIMBOLURI_PE_BLOC; un bloc
+ * e alocat abia cand ajungem la el si nu se mai muta niciodata */
+#define BITI_BLOC_SIMBOLURI   12
+#define SIMBOLURI_PE_BLOC     (1u << BITI_BLOC_SIMBOLURI)
+#define MAX_BLOCURI_SIMBOLURI 4096      /* Maxim ~16 milioane de texte */
+
+/* Textele propriu-zise sunt copiate in bucati mari de memorie, unul dupa
+ * altul - un malloc() la cateva mii de texte, nu la fiecare */
+#define DIMENSIUNE_BUCATA_TEXT 65536
+
+/* In bucati, fiecare text ocupa un multiplu de PAS_CLASA_TEXT octeti (cu
+ * tot cu '\0'). Locul unui text recuperat e refolosit de un text nou din
+ * aceeasi clasa. Textele mai lungi de MAX_TEXT_IN_BUCATA au malloc() propriu. */
+#define PAS_CLASA_TEXT        16
+#define MAX_TEXT_IN_BUCATA    512
+#define NUMAR_CLASE_TEXT      (MAX_TEXT_IN_BUCATA / PAS_CLASA_TEXT)
+
+/* Cate texte tine minte fiecare thread (putere a lui 2) */
+#define MARIME_CACHE_SIMBOLURI 256
+
+/* Cu cate locuri porneste tabela unei benzi (putere a lui 2) */
+#define CAPACITATE_INITIALA_BANDA 1024
+
+
+/* Ce stim despre un text internat */
+typedef struct {
+    const char* text;
+    uint32_t lungime;
+    IdSimbol majuscule;         /* Acelasi text, cu litere mari */
+    uint32_t epoca;             /* Ultima epoca in care a fost folosit */
+} Simbol;
+
+/*
+ * O banda: o tabela hash (adresare deschisa, cu cautare liniara) si
+ * lacatul ei. In fiecare loc tinem numarul textului si hash-ul lui, ca sa
+ * nu comparam string-uri decat cand hash-urile sunt egale.
+ */
+typedef struct {
+    pthread_mutex_t mutex;
+    IdSimbol* sloturi;          /* SIMBOL_GOL = loc liber */
+    uint32_t* hashuri;
+    uint32_t capacitate;
+    uint32_t numar;
+
+    char* bucata;               /* Bucata in care copiem textele noi */
+    size_t ramas;               /* Cati octeti mai incap in ea */
+    char* libere[NUMAR_CLASE_TEXT];     /* Locuri de texte recuperate, pe clase */
+} BandaSimboluri;
+
+/* Intrarea din cache-ul unui thread */
+typedef struct {
+    uint32_t hash;
+    IdSimbol simbol;
+    uint32_t generatie;         /* g_generatie cand a fost pus aici */
+} IntrareCacheSimbol;
+
+/* Un simbol scos din tabela, care asteapta o recuperare ca sa fie refolosit */
+typedef struct {
+    IdSimbol simbol;
+    uint32_t banda;
+} SimbolRecuperat;
+
+
+/* Blocurile de simboluri - citite fara lacat, deci publicate atomic */
+static Simbol* g_blocuri[MAX_BLOCURI_SIMBOLURI];
+
+/* Numerele care se pot da: cele recuperate, apoi urmatorul nefolosit
+ * inca (0 e rezervat pentru textul gol) */
+static pthread_mutex_t g_mutex_numere = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t g_urmatorul_simbol = 1;
+static IdSimbol* g_numere_libere = NULL;
+static size_t g_numar_libere = 0;
+static size_t g_capacitate_libere = 0;
+static int g_avertizat_plina = 0;
+
+static BandaSimboluri g_benzi[NUMAR_BENZI_SIMBOLURI];
+static pthread_once_t g_initializare = PTHREAD_ONCE_INIT;
+
+/*
+ * Recuperarea (vezi tabela_simboluri.h):
+ * - g_epoca creste la fiecare recuperare; un simbol folosit sau marcat
+ *   primeste epoca curenta
+ * - g_generatie e impara cat timp o recuperare scoate simboluri din
+ *   tabela; cache-ul thread-urilor e valabil doar in generatia lui
+ * - simbolurile scoase acum sunt refolosite abia la recuperarea urmatoare,
+ *   cand nimeni nu mai poate fi in mijlocul unei citiri a textului lor
+ */
+static uint32_t g_epoca = 2;
+static uint32_t g_generatie = 0;
+static uint32_t g_create_de_la_recuperare = 0;
+static SimbolRecuperat* g_in_asteptare = NULL;
+static size_t g_numar_in_asteptare = 0;
+
+static __thread IntrareCacheSimbol t_cache[MARIME_CACHE_SIMBOLURI];
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: initializeaza_benzi
+ * -----------------------------------------------------------------------------
+ */
+static void initializeaza_benzi(void) {
+    for (int i = 0; i < NUMAR_BENZI_SIMBOLURI; i++) {
+        pthread_mutex_init(&g_benzi[i].mutex, NULL);
+        g_benzi[i].sloturi = calloc(CAPACITATE_INITIALA_BANDA, sizeof(IdSimbol));
+        g_benzi[i].hashuri = calloc(CAPACITATE_INITIALA_BANDA, sizeof(uint32_t));
+        g_benzi[i].capacitate = (g_benzi[i].sloturi && g_benzi[i].hashuri)
+                                ? CAPACITATE_INITIALA_BANDA : 0;
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: hash_text
+ * -----------------------------------------------------------------------------
+ * Hash FNV-1a, ca la alegerea shard-ului.
+ */
+static uint32_t hash_text(const char* text, size_t lungime) {
+    uint32_t hash = 2166136261u;
+
+    for (size_t i = 0; i < lungime; i++) {
+        hash ^= (unsigned char)text[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: simbol
+ * -----------------------------------------------------------------------------
+ * Intrarea unui numar deja dat (blocul lui exista sigur).
+ */
+static const Simbol* simbol(IdSimbol id) {
+    const Simbol* bloc = __atomic_load_n(&g_blocuri[id >> BITI_BLOC_SIMBOLURI], __ATOMIC_ACQUIRE);
+    return &bloc[id & (SIMBOLURI_PE_BLOC - 1)];
+}
+
+static int simbol_egal(IdSimbol id, const char* text, size_t lungime) {
+    const Simbol* s = simbol(id);
+    return s->lungime == lungime && memcmp(s->text, text, lungime) == 0;
+}
+
+/* Simbolul e folosit in epoca curenta (scriem doar daca s-a schimbat, ca
+ * simbolurile foarte folosite sa nu se plimbe intre nucleele procesorului) */
+static void atinge_simbol(IdSimbol id) {
+    Simbol* s = (Simbol*)simbol(id);
+    uint32_t epoca = __atomic_load_n(&g_epoca, __ATOMIC_SEQ_CST);
+
+    if (__atomic_load_n(&s->epoca, __ATOMIC_RELAXED) != epoca) {
+        __atomic_store_n(&s->epoca, epoca, __ATOMIC_SEQ_CST);
+    }
+}
+
+/* Folosit in epoca curenta sau in cea dinainte - altfel nu l-a mai atins
+ * nimeni de cel putin PERIOADA_RECUPERARE_SIMBOLURI secunde */
+static int simbol_recent(IdSimbol id, uint32_t epoca) {
+    return epoca - __atomic_load_n(&simbol(id)->epoca, __ATOMIC_SEQ_CST) < 2;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: bloc_pentru
+ * -----------------------------------------------------------------------------
+ * Blocul in care intra un numar nou. Daca nu exista il alocam; daca doua
+ * thread-uri il aloca deodata, castiga primul, iar celalalt il elibereaza
+ * pe al lui.
+ */
+static Simbol* bloc_pentru(IdSimbol id) {
+    Simbol** loc = &g_blocuri[id >> BITI_BLOC_SIMBOLURI];
+    Simbol* bloc = __atomic_load_n(loc, __ATOMIC_ACQUIRE);
+
+    if (bloc == NULL) {
+        Simbol* nou = calloc(SIMBOLURI_PE_BLOC, sizeof(Simbol));
+        if (nou == NULL) {
+            return NULL;
+        }
+
+        if (__atomic_compare_exchange_n(loc, &bloc, nou, 0,
+                                        __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            bloc = nou;
+        } else {
+            free(nou);  /* bloc = cel pus de celalalt thread */
+        }
+    }
+
+    return bloc;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: cauta_in_banda
+ * -----------------------------------------------------------------------------
+ * Pozitia textului in tabela benzii, sau a locului liber unde ar trebui
+ * pus. Se apeleaza cu lacatul benzii luat.
+ */
+static uint32_t cauta_in_banda(const BandaSimboluri* banda, uint32_t hash,
+                               const char* text, size_t lungime) {
+    uint32_t masca = banda->capacitate - 1;
+    uint32_t pozitie = hash & masca;
+
+    while (banda->sloturi[pozitie] != SIMBOL_GOL) {
+        if (banda->hashuri[pozitie] == hash &&
+            simbol_egal(banda->sloturi[pozitie], text, lungime)) {
+            break;
+        }
+        pozitie = (pozitie + 1) & masca;
+    }
+
+    return pozitie;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: mareste_banda
+ * -----------------------------------------------------------------------------
+ * Dubleaza tabela benzii cand se umple peste 70%. Hash-urile sunt salvate,
+ * asa ca nu recitim niciun text.
+ */
+static int mareste_banda(BandaSimboluri* banda) {
+    uint32_t capacitate_noua = banda->capacitate * 2;
+    IdSimbol* sloturi = calloc(capacitate_noua, sizeof(IdSimbol));
+    uint32_t* hashuri = calloc(capacitate_noua, sizeof(uint32_t));
+
+    if (sloturi == NULL || hashuri == NULL) {
+        free(sloturi);
+        free(hashuri);
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < banda->capacitate; i++) {
+        if (banda->sloturi[i] == SIMBOL_GOL) {
+            continue;
+        }
+
+        uint32_t pozitie = banda->hashuri[i] & (capacitate_noua - 1);
+        while (sloturi[pozitie] != SIMBOL_GOL) {
+            pozitie = (pozitie + 1) & (capacitate_noua - 1);
+        }
+        sloturi[pozitie] = banda->sloturi[i];
+        hashuri[pozitie] = banda->hashuri[i];
+    }
+
+    free(banda->sloturi);
+    free(banda->hashuri);
+    banda->sloturi = sloturi;
+    banda->hashuri = hashuri;
+    banda->capacitate = capacitate_noua;
+    return 0;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: copiaza_text / elibereaza_text
+ * -----------------------------------------------------------------------------
+ * Copiaza textul (plus '\0') in banda: intr-un loc recuperat din aceeasi
+ * clasa, daca avem unul, altfel in bucata curenta. Textele foarte lungi
+ * primesc un malloc() separat, ca sa nu irosim o bucata intreaga.
+ *
+ * Un loc liber tine in primii octeti adresa urmatorului loc liber.
+ */
+static char* copiaza_text(BandaSimboluri* banda, const char* text, size_t lungime) {
+    char* copie;
+
+    if (lungime + 1 > MAX_TEXT_IN_BUCATA) {
+        copie = malloc(lungime + 1);
+    } else {
+        size_t clasa = lungime / PAS_CLASA_TEXT;
+        size_t marime = (clasa + 1) * PAS_CLASA_TEXT;
+
+        if (banda->libere[clasa] != NULL) {
+            copie = banda->libere[clasa];
+            memcpy(&banda->libere[clasa], copie, sizeof(char*));
+        } else {
+            if (banda->ramas < marime) {
+                /* Bucata veche ramane alocata - textele din ea sunt folosite */
+                banda->bucata = malloc(DIMENSIUNE_BUCATA_TEXT);
+                banda->ramas = banda->bucata ? DIMENSIUNE_BUCATA_TEXT : 0;
+                if (banda->bucata == NULL) {
+                    return NULL;
+                }
+            }
+            copie = banda->bucata;
+            banda->bucata += marime;
+            banda->ramas -= marime;
+        }
+    }
+
+    if (copie != NULL) {
+        memcpy(copie, text, lungime);
+        copie[lungime] = '\0';
+    }
+    return copie;
+}
+
+static void elibereaza_text(BandaSimboluri* banda, char* text, size_t lungime) {
+    if (lungime + 1 > MAX_TEXT_IN_BUCATA) {
+        free(text);
+        return;
+    }
+
+    size_t clasa = lungime / PAS_CLASA_TEXT;
+    memcpy(text, &banda->libere[clasa], sizeof(char*));
+    banda->libere[clasa] = text;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: ia_numar / returneaza_numar
+ * -----------------------------------------------------------------------------
+ * Un numar pentru un simbol nou: unul recuperat, sau urmatorul nefolosit.
+ * Cand nu mai avem niciunul, anuntam o singura data (pana la urmatoarea
+ * recuperare) - textele noi raman goale pana atunci.
+ */
+static IdSimbol ia_numar(void) {
+    IdSimbol id = SIMBOL_GOL;
+
+    pthread_mutex_lock(&g_mutex_numere);
+
+    if (g_numar_libere > 0) {
+        id = g_numere_libere[--g_numar_libere];
+    } else if (g_urmatorul_simbol < (uint32_t)MAX_BLOCURI_SIMBOLURI * SIMBOLURI_PE_BLOC) {
+        id = g_urmatorul_simbol++;
+    } else if (!g_avertizat_plina) {
+        g_avertizat_plina = 1;
+        fprintf(stderr, "[!] Tabela de simboluri e plina - textele noi raman goale "
+                        "pana la urmatoarea recuperare\n");
+    }
+
+    pthread_mutex_unlock(&g_mutex_numere);
+    return id;
+}
+
+/* Se apeleaza cu g_mutex_numere blocat */
+static int pune_numar_liber(IdSimbol id) {
+    if (g_numar_libere == g_capacitate_libere) {
+        size_t capacitate = g_capacitate_libere ? g_capacitate_libere * 2 : SIMBOLURI_PE_BLOC;
+        IdSimbol* numere = realloc(g_numere_libere, capacitate * sizeof(IdSimbol));
+        if (numere == NULL) {
+            return 0;  /* Numarul se pierde - nu stricam nimic */
+        }
+        g_numere_libere = numere;
+        g_capacitate_libere = capacitate;
+    }
+
+    g_numere_libere[g_numar_libere++] = id;
+    return 1;
+}
+
+static void returneaza_numar(IdSimbol id) {
+    pthread_mutex_lock(&g_mutex_numere);
+    pune_numar_liber(id);
+    pthread_mutex_unlock(&g_mutex_numere);
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: adauga_in_banda
+ * -----------------------------------------------------------------------------
+ * Da un numar nou textului si il pune la pozitia gasita de
+ * cauta_in_banda(). Se apeleaza cu lacatul benzii luat.
+ */
+static IdSimbol adauga_in_banda(BandaSimboluri* banda, uint32_t pozitie, uint32_t hash,
+                                const char* text, size_t lungime, IdSimbol majuscule) {
+    IdSimbol id = ia_numar();
+    if (id == SIMBOL_GOL) {
+        return SIMBOL_GOL;  /* Tabela plina */
+    }
+
+    Simbol* bloc = bloc_pentru(id);
+    char* copie = bloc != NULL ? copiaza_text(banda, text, lungime) : NULL;
+    if (copie == NULL) {
+        returneaza_numar(id);
+        return SIMBOL_GOL;  /* Fara memorie: logul ramane cu campul gol */
+    }
+
+    Simbol* s = &bloc[id & (SIMBOLURI_PE_BLOC - 1)];
+    s->text = copie;
+    s->lungime = (uint32_t)lungime;
+    s->majuscule = (majuscule != SIMBOL_GOL) ? majuscule : id;
+    s->epoca = __atomic_load_n(&g_epoca, __ATOMIC_SEQ_CST);
+    __atomic_fetch_add(&g_create_de_la_recuperare, 1, __ATOMIC_RELAXED);
+
+    banda->sloturi[pozitie] = id;
+    banda->hashuri[pozitie] = hash;
+    banda->numar++;
+
+    if (banda->numar * 10 > banda->capacitate * 7) {
+        mareste_banda(banda);  /* Daca nu reusim, tabela doar devine mai lenta */
+    }
+
+    return id;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: interneaza_n
+ * -----------------------------------------------------------------------------
+ */
+IdSimbol interneaza_n(const char* text, size_t lungime) {
+    if (lungime == 0) {
+        return SIMBOL_GOL;
+    }
+
+    /*
+     * Pas 1: Cache-ul thread-ului - fara lacat. Daca intre timp a inceput
+     * o recuperare, simbolul poate fi chiar in curs de scoatere, asa ca
+     * trecem pe drumul cu lacat (generatia s-a schimbat).
+     */
+    uint32_t hash = hash_text(text, lungime);
+    IntrareCacheSimbol* cache = &t_cache[hash & (MARIME_CACHE_SIMBOLURI - 1)];
+    uint32_t generatie = __atomic_load_n(&g_generatie, __ATOMIC_ACQUIRE);
+
+    if (cache->simbol != SIMBOL_GOL && cache->generatie == generatie && cache->hash == hash &&
+        simbol_egal(cache->simbol, text, lungime)) {
+        atinge_simbol(cache->simbol);
+        if (__atomic_load_n(&g_generatie, __ATOMIC_SEQ_CST) == generatie) {
+            return cache->simbol;
+        }
+    }
+
+    /*
+     * Pas 2: Tabela benzii. Bitii de sus ai hash-ului aleg banda, cei de
+     * jos pozitia in tabela ei.
+     */
+    pthread_once(&g_initializare, initializeaza_benzi);
+    BandaSimboluri* banda = &g_benzi[(hash >> 24) % NUMAR_BENZI_SIMBOLURI];
+
+    pthread_mutex_lock(&banda->mutex);
+
+    if (banda->capacitate == 0) {
+        pthread_mutex_unlock(&banda->mutex);
+        return SIMBOL_GOL;  /* Initializarea a esuat (fara memorie) */
+    }
+
+    uint32_t pozitie = cauta_in_banda(banda, hash, text, lungime);
+    IdSimbol id = banda->sloturi[pozitie];
+    if (id != SIMBOL_GOL) {
+        atinge_simbol(id);
+    }
+    generatie = g_generatie;  /* Para - recuperarea tine toate lacatele */
+
+    pthread_mutex_unlock(&banda->mutex);
+
+    /*
+     * Pas 3: Text nou. Mai intai internam varianta cu litere mari (fara
+     * lacat - poate fi in alta banda), apoi il adaugam. Intre timp l-ar fi
+     * putut adauga alt thread, asa ca il cautam din nou.
+     */
+    if (id == SIMBOL_GOL) {
+        IdSimbol majuscule = SIMBOL_GOL;
+        char local[LUNGIME_CAMP];
+        char* mare = (lungime < sizeof(local)) ? local : malloc(lungime);
+        int are_litere_mici = 0;
+
+        if (mare != NULL) {
+            for (size_t i = 0; i < lungime; i++) {
+                char c = text[i];
+                if (c >= 'a' && c <= 'z') {
+                    c = (char)(c - 'a' + 'A');
+                    are_litere_mici = 1;
+                }
+                mare[i] = c;
+            }
+
+            if (are_litere_mici) {
+                majuscule = interneaza_n(mare, lungime);
+            }
+            if (mare != local) {
+                free(mare);
+            }
+        }
+
+        pthread_mutex_lock(&banda->mutex);
+
+        pozitie = cauta_in_banda(banda, hash, text, lungime);
+        id = banda->sloturi[pozitie];
+        if (id == SIMBOL_GOL) {
+            id = adauga_in_banda(banda, pozitie, hash, text, lungime, majuscule);
+        } else {
+            atinge_simbol(id);
+        }
+        generatie = g_generatie;
+
+        pthread_mutex_unlock(&banda->mutex);
+    }
+
+    cache->hash = hash;
+    cache->simbol = id;
+    cache->generatie = generatie;
+    return id;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: interneaza
+ * -----------------------------------------------------------------------------
+ */
+IdSimbol interneaza(const char* text) {
+    return interneaza_n(text, strlen(text));
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: text_simbol
+ * -----------------------------------------------------------------------------
+ * Nu luam niciun lacat: cine are un numar l-a primit dupa ce intrarea lui
+ * a fost completata (prin lacatul benzii sau prin coada de loguri).
+ */
+const char* text_simbol(IdSimbol id) {
+    if (id == SIMBOL_GOL) {
+        return "";
+    }
+    return simbol(id)->text;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: majuscule_simbol
+ * -----------------------------------------------------------------------------
+ */
+IdSimbol majuscule_simbol(IdSimbol id) {
+    if (id == SIMBOL_GOL) {
+        return SIMBOL_GOL;
+    }
+    return simbol(id)->majuscule;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: interneaza_adresa
+ * -----------------------------------------------------------------------------
+ */
+IdSimbol interneaza_adresa(const char* adresa, uint16_t* port) {
+    const char* doua_puncte = strrchr(adresa, ':');
+    unsigned long numar = 0;
+
+    *port = 0;
+    if (doua_puncte == NULL || doua_puncte[1] == '\0') {
+        return interneaza(adresa);
+    }
+
+    for (const char* p = doua_puncte + 1; *p; p++) {
+        if (*p < '0' || *p > '9' || numar > 65535) {
+            return interneaza(adresa);
+        }
+        numar = numar * 10 + (unsigned long)(*p - '0');
+    }
+    if (numar > 65535) {
+        return interneaza(adresa);
+    }
+
+    *port = (uint16_t)numar;
+    return interneaza_n(adresa, (size_t)(doua_puncte - adresa));
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: incepe_recuperare_simboluri
+ * -----------------------------------------------------------------------------
+ * Trecem intr-o epoca noua: de acum, tot ce e folosit sau marcat primeste
+ * epoca noua. Daca nu s-a creat niciun simbol de la ultima recuperare,
+ * tabela nu a crescut si nu are rost sa cautam.
+ */
+int incepe_recuperare_simboluri(void) {
+    pthread_once(&g_initializare, initializeaza_benzi);
+
+    if (__atomic_exchange_n(&g_create_de_la_recuperare, 0, __ATOMIC_RELAXED) == 0 &&
+        g_numar_in_asteptare == 0) {
+        return 0;
+    }
+
+    __atomic_fetch_add(&g_epoca, 1, __ATOMIC_SEQ_CST);
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: marcheaza_simbol
+ * -----------------------------------------------------------------------------
+ */
+void marcheaza_simbol(IdSimbol id) {
+    if (id != SIMBOL_GOL) {
+        atinge_simbol(id);
+    }
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: curata_banda
+ * -----------------------------------------------------------------------------
+ * Reface tabela benzii doar cu simbolurile recente; celelalte trec in
+ * asteptare. Se apeleaza cu toate lacatele luate.
+ *
+ * RETURNEAZA:
+ *     Cate simboluri au fost scoase
+ */
+static size_t curata_banda(uint32_t index_banda, uint32_t epoca, size_t* capacitate_asteptare) {
+    BandaSimboluri* banda = &g_benzi[index_banda];
+    IdSimbol* sloturi = calloc(banda->capacitate, sizeof(IdSimbol));
+    uint32_t* hashuri = calloc(banda->capacitate, sizeof(uint32_t));
+
+    if (sloturi == NULL || hashuri == NULL) {
+        free(sloturi);
+        free(hashuri);
+        return 0;  /* Fara memorie - pastram tot, poate data viitoare */
+    }
+
+    uint32_t masca = banda->capacitate - 1;
+    uint32_t numar = 0;
+    size_t scoase = 0;
+
+    for (uint32_t i = 0; i < banda->capacitate; i++) {
+        IdSimbol id = banda->sloturi[i];
+        if (id == SIMBOL_GOL) {
+            continue;
+        }
+
+        if (!simbol_recent(id, epoca)) {
+            if (g_numar_in_asteptare == *capacitate_asteptare) {
+                size_t capacitate = *capacitate_asteptare ? *capacitate_asteptare * 2 : SIMBOLURI_PE_BLOC;
+                SimbolRecuperat* lista = realloc(g_in_asteptare, capacitate * sizeof(SimbolRecuperat));
+                if (lista != NULL) {
+                    g_in_asteptare = lista;
+                    *capacitate_asteptare = capacitate;
+                }
+            }
+            if (g_numar_in_asteptare < *capacitate_asteptare) {
+                g_in_asteptare[g_numar_in_asteptare].simbol = id;
+                g_in_asteptare[g_numar_in_asteptare].banda = index_banda;
+                g_numar_in_asteptare++;
+                scoase++;
+                continue;
+            }
+            /* Nu avem unde sa-l tinem minte - ramane in tabela */
+        }
+
+        uint32_t pozitie = banda->hashuri[i] & masca;
+        while (sloturi[pozitie] != SIMBOL_GOL) {
+            pozitie = (pozitie + 1) & masca;
+        }
+        sloturi[pozitie] = id;
+        hashuri[pozitie] = banda->hashuri[i];
+        numar++;
+    }
+
+    free(banda->sloturi);
+    free(banda->hashuri);
+    banda->sloturi = sloturi;
+    banda->hashuri = hashuri;
+    banda->numar = numar;
+    return scoase;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: termina_recuperare_simboluri
+ * -----------------------------------------------------------------------------
+ */
+size_t termina_recuperare_simboluri(void) {
+    static size_t capacitate_asteptare = 0;
+    uint32_t epoca = __atomic_load_n(&g_epoca, __ATOMIC_SEQ_CST);
+
+    for (int i = 0; i < NUMAR_BENZI_SIMBOLURI; i++) {
+        pthread_mutex_lock(&g_benzi[i].mutex);
+    }
+
+    /* Impara: cache-urile thread-urilor nu mai sunt de incredere */
+    __atomic_fetch_add(&g_generatie, 1, __ATOMIC_SEQ_CST);
+
+    /*
+     * Pas 1: Varianta cu litere mari a unui simbol pastrat trebuie si ea
+     * pastrata (majuscule_simbol o poate cere oricand). Varianta cu litere
+     * mari a unui text cu litere mari e chiar el, deci o trecere ajunge.
+     */
+    for (int i = 0; i < NUMAR_BENZI_SIMBOLURI; i++) {
+        const BandaSimboluri* banda = &g_benzi[i];
+        for (uint32_t j = 0; j < banda->capacitate; j++) {
+            IdSimbol id = banda->sloturi[j];
+            if (id != SIMBOL_GOL && simbol_recent(id, epoca)) {
+                atinge_simbol(simbol(id)->majuscule);
+            }
+        }
+    }
+
+    /*
+     * Pas 2: Ce a fost scos la recuperarea trecuta poate fi refolosit
+     * acum - de atunci au trecut cel putin PERIOADA_RECUPERARE_SIMBOLURI
+     * secunde, deci nicio citire de atunci nu mai e in curs
+     */
+    pthread_mutex_lock(&g_mutex_numere);
+    for (size_t i = 0; i < g_numar_in_asteptare; i++) {
+        Simbol* s = (Simbol*)simbol(g_in_asteptare[i].simbol);
+
+        elibereaza_text(&g_benzi[g_in_asteptare[i].banda], (char*)s->text, s->lungime);
+        s->text = "";
+        s->lungime = 0;
+        s->majuscule = g_in_asteptare[i].simbol;
+        pune_numar_liber(g_in_asteptare[i].simbol);
+    }
+    size_t refolosite = g_numar_in_asteptare;
+    g_numar_in_asteptare = 0;
+    if (refolosite > 0) {
+        g_avertizat_plina = 0;
+    }
+    pthread_mutex_unlock(&g_mutex_numere);
+
+    /*
+     * Pas 3: Scoatem din tabele ce nu a mai fost folosit sau marcat de
+     * doua epoci
+     */
+    size_t scoase = 0;
+    for (uint32_t i = 0; i < NUMAR_BENZI_SIMBOLURI; i++) {
+        if (g_benzi[i].capacitate > 0) {
+            scoase += curata_banda(i, epoca, &capacitate_asteptare);
+        }
+    }
+
+    /* Para din nou */
+    __atomic_fetch_add(&g_generatie, 1, __ATOMIC_SEQ_CST);
+
+    for (int i = NUMAR_BENZI_SIMBOLURI - 1; i >= 0; i--) {
+        pthread_mutex_unlock(&g_benzi[i].mutex);
+    }
+
+    return scoase;
+}
@@ -0,0 +1,246 @@
+#include "timp_loguri.h"
+
+#include <time.h>       /* Pentru clock_gettime(), mktime(), localtime_r(), strftime() */
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: timp_curent_ns
+ * -----------------------------------------------------------------------------
+ */
+int64_t timp_curent_ns(void) {
+    struct timespec acum;
+    clock_gettime(CLOCK_REALTIME, &acum);
+
+    return (int64_t)acum.tv_sec * NS_PE_SECUNDA + acum.tv_nsec;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: zile_de_la_1970
+ * -----------------------------------------------------------------------------
+ * Cate zile sunt de la 1970-01-01 pana la data data (calendarul gregorian,
+ * fara fus orar). Socotim anul ca incepand din martie: asa ziua in plus
+ * a anilor bisecti (29 februarie) cade la sfarsitul anului si formula
+ * ramane fara cazuri speciale.
+ */
+static int64_t zile_de_la_1970(int64_t an, int luna, int zi) {
+    if (luna <= 2) {
+        an--;
+    }
+
+    /* Calendarul se repeta la fiecare 400 de ani ("era") */
+    int64_t era = (an >= 0 ? an : an - 399) / 400;
+    int64_t an_din_era = an - era * 400;
+    int64_t zi_din_an = (153 * (luna > 2 ? luna - 3 : luna + 9) + 2) / 5 + zi - 1;
+    int64_t zi_din_era = an_din_era * 365 + an_din_era / 4 - an_din_era / 100 + zi_din_an;
+
+    /* 719468 = zilele de la 0000-03-01 pana la 1970-01-01 */
+    return era * 146097 + zi_din_era - 719468;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: decalaj_local
+ * -----------------------------------------------------------------------------
+ * Cu cate secunde e ora locala inaintea UTC, pentru un moment scris in ora
+ * locala (dat ca secunde "ca si cum ar fi UTC").
+ *
+ * Decalajul se schimba cel mult o data pe ora (ora de vara), asa ca fiecare
+ * thread il tine minte pentru ultima ora intalnita si apeleaza mktime()
+ * doar cand ora se schimba.
+ */
+static __thread int64_t t_ora_decalaj = INT64_MIN;
+static __thread int64_t t_decalaj;
+
+static int64_t decalaj_local(int64_t secunde_locale) {
+    int64_t ora = secunde_locale / 3600 - (secunde_locale % 3600 < 0);
+
+    if (ora != t_ora_decalaj) {
+        time_t ca_utc = (time_t)(ora * 3600);
+        struct tm calendar;
+        gmtime_r(&ca_utc, &calendar);
+
+        calendar.tm_isdst = -1;  /* mktime() afla singur daca e ora de vara */
+        t_decalaj = (int64_t)ca_utc - (int64_t)mktime(&calendar);
+        t_ora_decalaj = ora;
+    }
+
+    return t_decalaj;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * FUNCTIE HELPER: citeste_numar
+ * -----------------------------------------------------------------------------
+ * Citeste exact 'cifre' cifre zecimale.
+ *
+ * RETURNEAZA:
+ *     Numarul, sau -1 daca nu sunt destule cifre
+ */
+static int citeste_numar(const char** pozitie, const char* sfarsit, int cifre) {
+    int valoare = 0;
+
+    if (sfarsit - *pozitie < cifre) {
+        return -1;
+    }
+
+    for (int i = 0; i < cifre; i++) {
+        unsigned int cifra = (unsigned int)((*pozitie)[i] - '0');
+        if (cifra > 9) {
+            return -1;
+        }
+        valoare = valoare * 10 + (int)cifra;
+    }
+
+    *pozitie += cifre;
+    return valoare;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: parseaza_timp_iso
+ * -----------------------------------------------------------------------------
+ */
+int parseaza_timp_iso(const char* text, size_t lungime, int64_t* rezultat) {
+    const char* pozitie = text;
+    const char* sfarsit = text + lungime;
+    int ora = 0, minut = 0, secunda = 0;
+    int64_t fractiune_ns = 0;
+
+    /*
+     * Pas 1: Data - AAAA-LL-ZZ
+     */
+    int an = citeste_numar(&pozitie, sfarsit, 4);
+    if (an < 0 || pozitie == sfarsit || *pozitie++ != '-') {
+        return 0;
+    }
+    int luna = citeste_numar(&pozitie, sfarsit, 2);
+    if (luna < 1 || luna > 12 || pozitie == sfarsit || *pozitie++ != '-') {
+        return 0;
+    }
+    int zi = citeste_numar(&pozitie, sfarsit, 2);
+    if (zi < 1 || zi > 31) {
+        return 0;
+    }
+
+    /*
+     * Pas 2: Ora (optionala) - HH:MM[:SS[.fractiune]]
+     */
+    if (pozitie < sfarsit && (*pozitie == ' ' || *pozitie == 'T' || *pozitie == 't')) {
+        pozitie++;
+
+        ora = citeste_numar(&pozitie, sfarsit, 2);
+        if (ora < 0 || ora > 23 || pozitie == sfarsit || *pozitie++ != ':') {
+            return 0;
+        }
+        minut = citeste_numar(&pozitie, sfarsit, 2);
+        if (minut < 0 || minut > 59) {
+            return 0;
+        }
+
+        if (pozitie < sfarsit && *pozitie == ':') {
+            pozitie++;
+            secunda = citeste_numar(&pozitie, sfarsit, 2);
+            if (secunda < 0 || secunda > 60) {  /* 60 = secunda intercalata */
+                return 0;
+            }
+
+            if (pozitie < sfarsit && (*pozitie == '.' || *pozitie == ',')) {
+                /* Pastram cel mult 9 cifre (nanosecunde), restul le sarim */
+                int64_t scala = NS_PE_SECUNDA / 10;
+                pozitie++;
+
+                while (pozitie < sfarsit && (unsigned int)(*pozitie - '0') <= 9) {
+                    fractiune_ns += (*pozitie - '0') * scala;
+                    scala /= 10;
+                    pozitie++;
+                }
+            }
+        }
+    }
+
+    int64_t secunde = zile_de_la_1970(an, luna, zi) * 86400 +
+                      ora * 3600 + minut * 60 + secunda;
+
+    /*
+     * Pas 3: Fusul orar - 'Z' (UTC), +HH[:MM] / -HH[:MM], sau nimic (ora locala)
+     */
+    if (pozitie < sfarsit && (*pozitie == 'Z' || *pozitie == 'z')) {
+        pozitie++;
+    }
+    else if (pozitie < sfarsit && (*pozitie == '+' || *pozitie == '-')) {
+        int semn = (*pozitie == '-') ? -1 : 1;
+        pozitie++;
+
+        int ore_fus = citeste_numar(&pozitie, sfarsit, 2);
+        int minute_fus = 0;
+        if (ore_fus < 0) {
+            return 0;
+        }
+        if (pozitie < sfarsit && *pozitie == ':') {
+            pozitie++;
+        }
+        if (pozitie < sfarsit) {
+            minute_fus = citeste_numar(&pozitie, sfarsit, 2);
+            if (minute_fus < 0) {
+                return 0;
+            }
+        }
+
+        secunde -= semn * (ore_fus * 3600 + minute_fus * 60);
+    }
+    else {
+        secunde -= decalaj_local(secunde);
+    }
+
+    /* Nu acceptam nimic dupa timp */
+    if (pozitie != sfarsit) {
+        return 0;
+    }
+
+    *rezultat = secunde * NS_PE_SECUNDA + fractiune_ns;
+    return 1;
+}
+
+
+/*
+ * -----------------------------------------------------------------------------
+ * IMPLEMENTARE: formateaza_timp
+ * -----------------------------------------------------------------------------
+ * Cache-ul fiecarui thread: ultimele doua secunde formatate si textele lor.
+ * Doua, pentru ca exportul scrie pe fiecare linie si timpul logului, si pe
+ * cel al primirii - cu un singur loc s-ar da afara unul pe altul.
+ */
+static __thread int64_t t_secunde_formatate[2] = { INT64_MIN, INT64_MIN };
+static __thread char t_timpi_formatati[2][LUNGIME_TIMP_FORMATAT];
+static __thread int t_ultimul_folosit = 0;
+
+const char* formateaza_timp(int64_t timp_ns) {
+    int64_t secunda = timp_ns / NS_PE_SECUNDA - (timp_ns % NS_PE_SECUNDA < 0);
+
+    if (secunda == t_secunde_formatate[t_ultimul_folosit]) {
+        return t_timpi_formatati[t_ultimul_folosit];
+    }
+
+    /* Celalalt loc: fie are deja secunda cautata, fie il suprascriem */
+    int loc = 1 - t_ultimul_folosit;
+
+    if (secunda != t_secunde_formatate[loc]) {
+        time_t secunda_unix = (time_t)secunda;
+        struct tm calendar;
+
+        if (localtime_r(&secunda_unix, &calendar) == NULL ||
+            strftime(t_timpi_formatati[loc], LUNGIME_TIMP_FORMATAT, "%Y-%m-%d %H:%M:%S", &calendar) == 0) {
+            t_timpi_formatati[loc][0] = '\0';
+        }
+        t_secunde_formatate[loc] = secunda;
+    }
+
+    t_ultimul_folosit = loc;
+    return t_timpi_formatati[loc];
+}
@@ -5,7 +5,7 @@
 #include <stdio.h>      /* Pentru sprintf si alte functii de I/O */
 #include <stdlib.h>     /* Pentru malloc, free, etc. */
 #include <string.h>     /* Pentru strlen, strcpy, strstr, etc. */
-#include <time.h>       /* Pentru time(), localtime(), strftime() */
+#include <time.h>       /* Pentru time(), localtime_r(), strftime() */
 #include <ctype.h>      /* Pentru toupper(), tolower(), isspace() */
 
 
@@ -29,8 +29,13 @@ void obtine_timpul_curent(char* buffer, size_t dimensiune) {
      * - tm_mon = luna (0-11)
      * - tm_mday = ziua (1-31)
      * - tm_hour, tm_min, tm_sec = ora, minut, secunda
+     *
+     * Folosim localtime_r(), cu structura noastra: localtime() foloseste
+     * o structura comuna tuturor thread-urilor si reciteste fusul orar
+     * (cu un malloc) la fiecare apel - adica la fiecare log primit.
      */
-    struct tm* timp_local = localtime(&acum);
+    struct tm timp;
+    struct tm* timp_local = localtime_r(&acum, &timp);
     
     /*
      * Pas 3: Formatam frumos in string
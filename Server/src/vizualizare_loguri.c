@@ -13,6 +13,10 @@
 #include "structuri_date.h"
 #include "afisare.h"
 #include "utilitare.h"
+#include "stocare_loguri.h"
+#include "tabela_simboluri.h"
+#include "coduri_loguri.h"
+#include "timp_loguri.h"
 #include "culori_si_configurari.h"
 
 #include <stdio.h>
@@ -95,7 +99,9 @@ static char* extrage_camp_csv(char** pozitie_curenta, char* buffer, size_t dim_b
  * IMPLEMENTARE: parseaza_linie_csv
  * -----------------------------------------------------------------------------
  * Formatul CSV generat de export:
- * Timestamp,PID,Process,User,Status,Level,CPU%,MemoryKB,Message,Hostname,ClientIP
+ * Timestamp,PID,Process,User,Status,Level,CPU%,MemoryKB,Message,Hostname,ClientIP,ReceivedAt
+ *
+ * Exporturile mai vechi nu au ReceivedAt - atunci primirea = Timestamp.
  */
 int parseaza_linie_csv(const char* linie, LogEntry* intrare) {
     /* Initializam structura */
@@ -110,7 +116,9 @@ int parseaza_linie_csv(const char* linie, LogEntry* intrare) {
     
     /* Campul 1: Timestamp */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->timestamp, buffer, sizeof(intrare->timestamp) - 1);
+    if (!parseaza_timp_iso(buffer, strlen(buffer), &intrare->timestamp_ns)) {
+        intrare->timestamp_ns = timp_curent_ns();  /* Timp stricat - punem acum */
+    }
     
     /* Campul 2: PID */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
@@ -118,19 +126,22 @@ int parseaza_linie_csv(const char* linie, LogEntry* intrare) {
     
     /* Campul 3: Process (nume) */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->nume, buffer, sizeof(intrare->nume) - 1);
+    intrare->nume = interneaza(buffer);
     
     /* Campul 4: User */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->utilizator, buffer, sizeof(intrare->utilizator) - 1);
+    intrare->utilizator = interneaza(buffer);
     
     /* Campul 5: Status */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->status, buffer, sizeof(intrare->status) - 1);
+    intrare->status = interneaza(buffer);
+    intrare->cod_status = cod_status(buffer);
     
     /* Campul 6: Level */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->nivel, buffer, sizeof(intrare->nivel) - 1);
+    /* Nivelul il pastram cu litere mari, ca la logurile primite prin retea */
+    intrare->nivel = majuscule_simbol(interneaza(buffer));
+    intrare->cod_nivel = cod_nivel(buffer);
     
     /* Campul 7: CPU% */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
@@ -142,20 +153,26 @@ int parseaza_linie_csv(const char* linie, LogEntry* intrare) {
     
     /* Campul 9: Message */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->mesaj, buffer, sizeof(intrare->mesaj) - 1);
+    intrare->mesaj = interneaza(buffer);
     
     /* Campul 10: Hostname */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->hostname, buffer, sizeof(intrare->hostname) - 1);
+    intrare->hostname = interneaza(buffer);
     
     /* Campul 11: ClientIP */
     extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
-    strncpy(intrare->ip_client, buffer, sizeof(intrare->ip_client) - 1);
+    intrare->ip_client = interneaza_adresa(buffer, &intrare->port_client);
+    
+    /* Campul 12: ReceivedAt (optional) */
+    extrage_camp_csv(&pozitie, buffer, sizeof(buffer));
+    if (!parseaza_timp_iso(buffer, strlen(buffer), &intrare->primit_ns)) {
+        intrare->primit_ns = intrare->timestamp_ns;
+    }
     
     free(linie_copie);
     
     /* Verificam ca am citit cel putin numele procesului */
-    return (strlen(intrare->nume) > 0) ? 1 : 0;
+    return (intrare->nume != SIMBOL_GOL) ? 1 : 0;
 }
 
 
@@ -213,7 +230,7 @@ int incarca_fisier_csv(const char* nume_fisier) {
     pthread_mutex_lock(&g_mutex_loguri);
     
     /* Golim lista existenta */
-    g_numar_loguri = 0;
+    goleste_loguri();
     
     while (fgets(linie, sizeof(linie), fisier) != NULL) {
         linie_curenta++;
@@ -227,9 +244,8 @@ int incarca_fisier_csv(const char* nume_fisier) {
         /* Parsam linia */
         LogEntry intrare;
         if (parseaza_linie_csv(linie, &intrare)) {
-            if (g_numar_loguri < MAX_LOGURI) {
-                g_lista_loguri[g_numar_loguri] = intrare;
-                g_numar_loguri++;
+            if (numar_incarcate < MAX_LOGURI) {
+                adauga_log(&intrare);
                 numar_incarcate++;
             } else {
                 printf(GALBEN "  Avertisment: Lista plina, unele loguri nu au fost incarcate\n" RESET);
@@ -278,7 +294,7 @@ int meniu_vizualizare_loguri(void) {
             
             /* Status */
             printf(VERDE " [FISIER] " RESET "%s", fisier_curent);
-            printf(" | Loguri: " GALBEN "%d" RESET "\n", g_numar_loguri);
+            printf(" | Loguri: " GALBEN "%d" RESET "\n", numar_total_loguri());
             
             /* Filtre active */
             printf(MAGENTA " [FILTRE] " RESET);
@@ -297,43 +313,22 @@ int meniu_vizualizare_loguri(void) {
             printf(RESET);
             printf(DIM "───────────────────────────────────────────────────────────────────────────────────────────────────────\n" RESET);
             
-            /* Afisam logurile */
-            pthread_mutex_lock(&g_mutex_loguri);
-            
-            int afisate = 0;
-            int total_filtrate = 0;
-            
-            /* Mai intai numaram cate trec filtrul */
-            for (int i = 0; i < g_numar_loguri; i++) {
-                if (trece_filtrul(&g_lista_loguri[i])) {
-                    total_filtrate++;
-                }
-            }
-            
-            /* Afisam ultimele 20 care trec filtrul */
-            int de_sarit = (total_filtrate > 20) ? (total_filtrate - 20) : 0;
-            int sarite = 0;
+            /* Copiem ultimele 20 care trec filtrul, apoi le afisam fara lacate */
+            EcranLoguri ecran;
+            copiaza_ecranul(&ecran, 20);
             
-            for (int i = 0; i < g_numar_loguri; i++) {
-                if (trece_filtrul(&g_lista_loguri[i])) {
-                    if (sarite < de_sarit) {
-                        sarite++;
-                        continue;
-                    }
-                    afiseaza_linie_log(&g_lista_loguri[i], i + 1);
-                    afisate++;
-                }
+            int afisate = ecran.numar;
+            for (int i = 0; i < ecran.numar; i++) {
+                afiseaza_linie_log(&ecran.randuri[i], ecran.indici[i] + 1);
             }
             
-            pthread_mutex_unlock(&g_mutex_loguri);
-            
             if (afisate == 0) {
                 printf(GALBEN "\n  (Niciun log nu corespunde filtrelor active)\n" RESET);
             }
             
             /* Statistici */
             printf(DIM "\n  Afisate: %d din %d filtrate (total: %d)\n" RESET, 
-                   afisate, total_filtrate, g_numar_loguri);
+                   afisate, ecran.numar_filtrate, ecran.numar_total);
             
             /* Meniu comenzi */
             printf(DIM "───────────────────────────────────────────────────────────────────────────────────────────────────────\n" RESET);
@@ -427,7 +422,7 @@ int meniu_vizualizare_loguri(void) {
         /* Status fisier */
         if (fisier_incarcat) {
             printf(VERDE "\n  [INCARCAT] " RESET "Fisier: " CYAN "%s" RESET, fisier_curent);
-            printf(" | Loguri: " GALBEN "%d" RESET "\n", g_numar_loguri);
+            printf(" | Loguri: " GALBEN "%d" RESET "\n", numar_total_loguri());
         } else {
             printf(GALBEN "\n  [!] Niciun fisier incarcat\n" RESET);
         }
@@ -532,7 +527,7 @@ int meniu_vizualizare_loguri(void) {
             
             case '3': {
                 /* Afiseaza logurile */
-                if (!fisier_incarcat || g_numar_loguri == 0) {
+                if (!fisier_incarcat || numar_total_loguri() == 0) {
                     printf(GALBEN "\n  Nu sunt loguri incarcate! Incarca intai un fisier (optiunea 2).\n" RESET);
                     printf("\n  Apasa ENTER pentru a continua...");
                     getchar();
@@ -0,0 +1,243 @@
+﻿// benchmark pentru serializarea JSON a snapshot-urilor: serializatorul vechi (stringstream,
+// copii ale proceselor, escape caracter cu caracter) fata de cel nou (JsonBuffer, scriere
+// direct in buffer). Masoara octeti/secunda si alocari per snapshot si verifica faptul ca
+// ambele produc exact aceleasi mesaje.
+//
+//   g++ -std=c++17 -O2 -I../src/main.cpp json_serializer_benchmark.cpp -o json_benchmark
+//   cl /std:c++17 /O2 /EHsc /I..\src\main.cpp json_serializer_benchmark.cpp
+//
+//   json_benchmark [procese] [iteratii]
+
+#include "log_types.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// numaram toate alocarile din program
+static std::atomic<unsigned long long> g_allocations(0);
+
+void* operator new(size_t size) {
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+// serializatorul de dinainte de JsonBuffer, pastrat doar pentru comparatie
+namespace legacy {
+
+inline std::string escape_json(const std::string& str) {
+    std::string truncated = truncate_field(str);
+
+    std::string result;
+    result.reserve(truncated.length() * 2);
+
+    for (char c : truncated) {
+        switch (c) {
+        case '"':  result += "\\\""; break;
+        case '\\': result += "\\\\"; break;
+        case '\b': result += "\\b";  break;
+        case '\f': result += "\\f";  break;
+        case '\n': result += "\\n";  break;
+        case '\r': result += "\\r";  break;
+        case '\t': result += "\\t";  break;
+        default:
+            if (c < 0x20) {
+                char buf[7];
+                snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
+                result += buf;
+            }
+            else {
+                result += c;
+            }
+            break;
+        }
+    }
+
+    return result;
+}
+
+std::string process_json(const ProcessInfo& proc) {
+    ProcessInfo normalized = proc;
+    normalized.normalize_fields();
+
+    std::stringstream ss;
+    ss << "{"
+        << "\"pid\":" << normalized.pid << ","
+        << "\"name\":\"" << escape_json(normalized.name) << "\","
+        << "\"user\":\"" << escape_json(normalized.user) << "\","
+        << "\"cpu_percent\":" << normalized.cpu_percent << ","
+        << "\"memory_kb\":" << normalized.memory_kb << ","
+        << "\"status\":\"" << status_to_string(normalized.status) << "\","
+        << "\"log_level\":\"" << log_level_to_string(normalized.log_level) << "\""
+        << "}";
+    return ss.str();
+}
+
+std::string message_header(const ProcessSnapshot& snapshot, const std::string& message_type) {
+    std::stringstream ss;
+    ss << "{"
+        << "\"hostname\":\"" << escape_json(truncate_field(snapshot.hostname)) << "\","
+        << "\"timestamp\":" << snapshot.timestamp << ",";
+
+    if (!message_type.empty()) {
+        ss << "\"type\":\"" << message_type << "\",";
+    }
+
+    ss << "\"processes\":[";
+    return ss.str();
+}
+
+std::vector<std::string> to_json_messages(const ProcessSnapshot& snapshot) {
+    const size_t closing_length = 2;
+
+    std::vector<std::string> messages;
+    const std::string continuation_type = snapshot.type.empty() ? "" : "DELTA";
+
+    std::string current = message_header(snapshot, snapshot.type);
+    size_t items = 0;
+
+    for (const auto& proc : snapshot.processes) {
+        std::string item = process_json(proc);
+
+        if (items > 0 && current.length() + 1 + item.length() + closing_length > MAX_JSON_MESSAGE_SIZE) {
+            current += "]}";
+            messages.push_back(std::move(current));
+            current = message_header(snapshot, continuation_type);
+            items = 0;
+        }
+
+        if (items > 0) current += ",";
+        current += item;
+        items++;
+    }
+
+    current += "]}";
+    messages.push_back(std::move(current));
+    return messages;
+}
+
+}  // namespace legacy
+
+static ProcessSnapshot make_snapshot(size_t count) {
+    static const char* names[] = {
+        "chrome.exe", "explorer.exe", "Code.exe", "svchost.exe", "Microsoft.Photos.exe",
+        "C:\\Program Files\\app \"beta\".exe", "bash", "systemd-journald", "kworker/3:1-events",
+        "Spotify.exe", "java", "node", "postgres: checkpointer", "python3", "nginx: worker process"
+    };
+    static const char* users[] = { "root", "SYSTEM", "alice", "bob", "www-data", "NETWORK SERVICE" };
+
+    std::mt19937 random(42);
+    ProcessSnapshot snapshot;
+    snapshot.hostname = "bench-host-01";
+    snapshot.timestamp = 1700000000;
+    snapshot.type = "KEYFRAME";
+
+    for (size_t i = 0; i < count; ++i) {
+        ProcessInfo proc;
+        proc.pid = static_cast<int>(1000 + i * 4);
+        proc.name = names[random() % (sizeof(names) / sizeof(names[0]))];
+        proc.user = users[random() % (sizeof(users) / sizeof(users[0]))];
+        proc.cpu_percent = (random() % 10000) / 97.0;
+        proc.memory_kb = static_cast<long long>(random() % 4000000);
+        proc.status = static_cast<ProcessStatus>(random() % 4);
+        proc.timestamp = snapshot.timestamp;
+        proc.log_level = proc.get_log_level();
+        snapshot.processes.push_back(proc);
+    }
+
+    return snapshot;
+}
+
+struct Result {
+    double seconds;
+    unsigned long long bytes;
+    unsigned long long allocations;
+};
+
+template <typename Serialize>
+static Result measure(const ProcessSnapshot& snapshot, int iterations, Serialize serialize) {
+    Result result = { 0.0, 0, 0 };
+
+    serialize(snapshot);  // incalzire
+
+    unsigned long long allocations_before = g_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < iterations; ++i) {
+        result.bytes += serialize(snapshot);
+    }
+
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.allocations = g_allocations.load() - allocations_before;
+    return result;
+}
+
+static void report(const char* name, const Result& result, int iterations) {
+    std::printf("%-34s %10.1f MB/s %12.1f alocari/snapshot %10.3f ms/snapshot\n", name,
+        result.bytes / result.seconds / (1024.0 * 1024.0),
+        static_cast<double>(result.allocations) / iterations,
+        result.seconds * 1000.0 / iterations);
+}
+
+int main(int argc, char* argv[]) {
+    size_t count = argc >= 2 ? static_cast<size_t>(std::atoi(argv[1])) : 2000;
+    int iterations = argc >= 3 ? std::atoi(argv[2]) : 200;
+
+    ProcessSnapshot snapshot = make_snapshot(count);
+
+    // acelasi rezultat, octet cu octet
+    std::vector<std::string> before = legacy::to_json_messages(snapshot);
+    std::vector<std::string> after = snapshot.to_json_messages();
+    if (before != after) {
+        std::cerr << "EROARE: serializatoarele produc mesaje diferite" << std::endl;
+        return 1;
+    }
+
+    std::printf("%zu procese, %zu mesaje, %d iteratii\n\n", count, after.size(), iterations);
+
+    Result old_result = measure(snapshot, iterations, [](const ProcessSnapshot& s) {
+        size_t bytes = 0;
+        for (const auto& message : legacy::to_json_messages(s)) bytes += message.size();
+        return bytes;
+    });
+
+    Result strings_result = measure(snapshot, iterations, [](const ProcessSnapshot& s) {
+        size_t bytes = 0;
+        for (const auto& message : s.to_json_messages()) bytes += message.size();
+        return bytes;
+    });
+
+    // ca in client: direct in buffer-ul de mesaje, fara string-uri intermediare
+    static char buffer[MAX_JSON_MESSAGE_SIZE];
+    Result buffer_result = measure(snapshot, iterations, [](const ProcessSnapshot& s) {
+        size_t bytes = 0;
+        s.write_json_messages(buffer, sizeof(buffer), [&bytes](const char*, size_t size) {
+            bytes += size;
+            return true;
+        });
+        return bytes;
+    });
+
+    report("inainte (stringstream)", old_result, iterations);
+    report("dupa (to_json_messages)", strings_result, iterations);
+    report("dupa (write_json_messages)", buffer_result, iterations);
+    return 0;
+}
@@ -0,0 +1,268 @@
+﻿#pragma once
+#include "network_client.hpp"
+#include "send_queue.hpp"
+#include "binary_protocol.hpp"
+#include "stream_compression.hpp"
+#include "client_config.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// mesajele unui ciclu, gata serializate
+struct OutgoingBatch {
+    std::vector<std::string> frames;    // fiecare pleaca cu lungimea in fata
+    bool binary;                        // formatul in care au fost scrise
+    size_t processes;
+
+    OutgoingBatch() : binary(false), processes(0) {}
+};
+
+// ce s-a intamplat pe conexiune de la pornire
+struct SenderStats {
+    unsigned long long batches_sent;
+    unsigned long long frames_sent;
+    unsigned long long bytes_sent;
+    unsigned long long batches_dropped;     // coada plina, format schimbat sau trimitere esuata
+    unsigned long long reconnects;
+    size_t queued;
+    bool connected;
+    double compression_ratio;
+    double compression_cpu_ms;              // procesor consumat de deflate() pe conexiunea curenta
+};
+
+// thread-ul de trimitere: colectarea pune loturi in coada si merge mai departe, iar
+// thread-ul asta le trimite (mai multe loturi cu un singur send), se reconecteaza si
+// asteapta din ce in ce mai mult intre incercari - un server lent nu mai intarzie colectarea
+class AsyncSender {
+private:
+    NetworkClient& client;
+    std::string server_ip;
+    int server_port;
+    std::string hello_msg;
+
+    BoundedQueue<OutgoingBatch> queue;
+    std::thread worker;
+    std::atomic<bool> stopping;
+    std::mutex wake_mutex;
+    std::condition_variable wake;
+
+    std::atomic<bool> binary_format;        // formatul negociat pe conexiunea curenta
+    std::atomic<bool> keyframe_needed;      // serverul a pierdut ceva - urmeaza un cadru complet
+    std::atomic<bool> connected;
+    std::atomic<double> compression_ratio;
+    std::atomic<double> compression_cpu_ms;
+
+    std::atomic<unsigned long long> batches_sent;
+    std::atomic<unsigned long long> frames_sent;
+    std::atomic<unsigned long long> bytes_sent;
+    std::atomic<unsigned long long> batches_dropped;
+    std::atomic<unsigned long long> reconnects;
+
+    void drop_batch() {
+        batches_dropped.fetch_add(1, std::memory_order_relaxed);
+        keyframe_needed.store(true, std::memory_order_relaxed);
+    }
+
+    // asteapta cel mult 'delay', dar se trezeste imediat la oprire
+    void sleep_interruptible(std::chrono::milliseconds delay) {
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake.wait_for(lock, delay, [this]() { return stopping.load(); });
+    }
+
+    // conexiune noua: handshake, apoi formatul si compresia din raspunsul de bun venit
+    bool reconnect() {
+        auto delay = std::chrono::milliseconds(RECONNECT_DELAY_MS);
+
+        while (!stopping.load()) {
+            client.disconnect();
+            connected.store(false);
+
+            std::cout << "  [sender] Incercare de reconectare..." << std::endl;
+
+            if (client.connect_to_server(server_ip, server_port) && client.send_message(hello_msg)) {
+                std::string welcome;
+                bool welcomed = client.receive_message(welcome, 2000);
+
+                binary_format.store(welcomed && server_accepts_binary(welcome));
+                if (welcomed && server_accepts_compression(welcome)) {
+                    client.enable_compression();
+                }
+
+                reconnects.fetch_add(1, std::memory_order_relaxed);
+                keyframe_needed.store(true);
+                connected.store(true);
+                std::cout << "  [sender] Reconectat cu succes!" << std::endl;
+                return true;
+            }
+
+            // backoff exponential, ca sa nu batem la usa unui server cazut
+            std::cerr << "  [sender] Reconectare esuata - reincercam peste "
+                << delay.count() << " ms" << std::endl;
+            sleep_interruptible(delay);
+            delay = std::min(delay * 2, std::chrono::milliseconds(RECONNECT_MAX_DELAY_MS));
+        }
+
+        return false;
+    }
+
+    // scoate din coada tot ce se poate trimite deodata (pana la SEND_COALESCE_BYTES)
+    size_t collect(std::vector<std::string>& frames, size_t& bytes) {
+        OutgoingBatch batch;
+        size_t batches = 0;
+
+        while (bytes < SEND_COALESCE_BYTES && queue.try_pop(batch)) {
+            // scris in formatul altei conexiuni - serverul nu l-ar intelege
+            if (batch.binary != binary_format.load()) {
+                drop_batch();
+                continue;
+            }
+
+            for (auto& frame : batch.frames) {
+                bytes += frame.length();
+                frames.push_back(std::move(frame));
+            }
+            batches++;
+        }
+
+        return batches;
+    }
+
+    void run() {
+        std::vector<std::string> frames;
+
+        while (!stopping.load()) {
+            if (!connected.load() && !reconnect()) {
+                break;
+            }
+
+            frames.clear();
+            size_t bytes = 0;
+            size_t batches = collect(frames, bytes);
+
+            if (batches == 0) {
+                sleep_interruptible(std::chrono::milliseconds(100));
+                continue;
+            }
+
+            if (send_frames(frames, batches, bytes)) {
+                continue;
+            }
+
+            // loturile s-au pierdut - dupa reconectare colectarea trimite un cadru complet
+            batches_dropped.fetch_add(batches, std::memory_order_relaxed);
+            keyframe_needed.store(true);
+            connected.store(false);
+        }
+
+        // la oprire trimitem ce a mai ramas, daca inca suntem conectati
+        frames.clear();
+        size_t bytes = 0;
+        size_t batches = collect(frames, bytes);
+        if (batches > 0 && connected.load()) {
+            send_frames(frames, batches, bytes);
+        }
+    }
+
+    bool send_frames(const std::vector<std::string>& frames, size_t batches, size_t bytes) {
+        bool success = false;
+        try {
+            success = client.send_batch(frames);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "  [sender] EXCEPTIE la trimitere: " << e.what() << std::endl;
+        }
+
+        if (!success) {
+            return false;
+        }
+
+        batches_sent.fetch_add(batches, std::memory_order_relaxed);
+        frames_sent.fetch_add(frames.size(), std::memory_order_relaxed);
+        bytes_sent.fetch_add(bytes, std::memory_order_relaxed);
+        compression_ratio.store(client.compression_enabled() ? client.compression_ratio() : 0.0);
+        compression_cpu_ms.store(client.compression_enabled() ? client.compression_cpu_ms() : 0.0);
+        return true;
+    }
+
+public:
+    // client = conexiunea deja facuta (cu handshake) de main; de acum e doar a thread-ului
+    AsyncSender(NetworkClient& connected_client, const std::string& ip, int port,
+        const std::string& hello, bool use_binary)
+        : client(connected_client), server_ip(ip), server_port(port), hello_msg(hello),
+        queue(SEND_QUEUE_CAPACITY), stopping(false), binary_format(use_binary),
+        keyframe_needed(false), connected(connected_client.is_connected()), compression_ratio(0.0),
+        compression_cpu_ms(0.0),
+        batches_sent(0), frames_sent(0), bytes_sent(0), batches_dropped(0), reconnects(0) {
+    }
+
+    ~AsyncSender() {
+        stop();
+    }
+
+    AsyncSender(const AsyncSender&) = delete;
+    AsyncSender& operator=(const AsyncSender&) = delete;
+
+    void start() {
+        worker = std::thread(&AsyncSender::run, this);
+    }
+
+    // opreste thread-ul (dupa ce trimite ce mai e in coada)
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex);
+            stopping.store(true);
+        }
+        wake.notify_all();
+
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+
+    // pune un lot in coada; daca e plina renunta la cel mai vechi (datele noi sunt mai
+    // utile decat cele vechi). false = s-a pierdut un lot
+    bool enqueue(OutgoingBatch& batch) {
+        bool dropped = false;
+
+        while (!queue.try_push(batch)) {
+            OutgoingBatch oldest;
+            if (queue.try_pop(oldest)) {
+                drop_batch();
+                dropped = true;
+            }
+        }
+
+        wake.notify_one();
+        return !dropped;
+    }
+
+    // in ce format sa scrie colectarea loturile noi
+    bool use_binary() const {
+        return binary_format.load();
+    }
+
+    // true o singura data dupa o pierdere (reconectare, lot aruncat)
+    bool take_keyframe_request() {
+        return keyframe_needed.exchange(false);
+    }
+
+    SenderStats stats() const {
+        SenderStats s;
+        s.batches_sent = batches_sent.load(std::memory_order_relaxed);
+        s.frames_sent = frames_sent.load(std::memory_order_relaxed);
+        s.bytes_sent = bytes_sent.load(std::memory_order_relaxed);
+        s.batches_dropped = batches_dropped.load(std::memory_order_relaxed);
+        s.reconnects = reconnects.load(std::memory_order_relaxed);
+        s.queued = queue.size_approx();
+        s.connected = connected.load();
+        s.compression_ratio = compression_ratio.load();
+        s.compression_cpu_ms = compression_cpu_ms.load();
+        return s;
+    }
+};
@@ -0,0 +1,152 @@
+﻿#pragma once
+#include "log_types.hpp"
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// format binar negociat la HELLO - trebuie sa corespunda cu Server/include/protocol_binar.h
+// numerele sunt little-endian, ca in memoria procesorului (x86/x64), deci le copiem direct
+#define BINARY_MAGIC 0xB1
+#define BINARY_SCHEMA 2
+#define BINARY_HEADER_SIZE 16
+#define BINARY_RECORD_SIZE 36
+
+// steagurile din antet (schema 2)
+#define BINARY_FLAG_KEYFRAME 0x0001
+#define BINARY_FLAG_DELTA 0x0002
+
+// steagurile unei inregistrari (schema 2)
+#define BINARY_RECORD_REMOVED 0x0001
+
+// codurile de pe fir (StatusProces / NivelLog de pe server), indexate cu valoarea enum-ului
+static const uint8_t BINARY_STATUS_CODES[] = { 1, 2, 3, 4, 5 };  // RUNNING, SLEEPING, STOPPED, ZOMBIE, CRASHED
+static const uint8_t BINARY_LEVEL_CODES[] = { 1, 2, 3 };      // INFO, WARN, ERR
+
+// serverul accepta binar daca raspunsul de bun venit spune "protocol":"binary" cu schema
+// noastra (un server cu schema 1 nu stie de delte si ar face loguri din procesele eliminate)
+inline bool server_accepts_binary(const std::string& welcome) {
+    return welcome.find("\"protocol\":\"binary\"") != std::string::npos &&
+        welcome.find("\"binary_schema\":" + std::to_string(BINARY_SCHEMA)) != std::string::npos;
+}
+
+// scrie un mesaj binar (antet + inregistrari) direct intr-un buffer dat de apelant,
+// fara alocari; fiecare inregistrare e o singura verificare de loc + copieri
+class BinaryMessageWriter {
+private:
+    char* out;
+    size_t capacity;
+    size_t length;
+    uint16_t count;
+
+    template <typename T>
+    void put(size_t offset, T value) {
+        std::memcpy(out + offset, &value, sizeof(T));
+    }
+
+public:
+    BinaryMessageWriter(char* buffer, size_t buffer_capacity,
+        const std::string& hostname, int64_t timestamp_ns, uint16_t flags = 0)
+        : out(buffer), capacity(buffer_capacity), length(0), count(0) {
+        uint16_t host_length = static_cast<uint16_t>(
+            hostname.length() < MAX_FIELD_LENGTH ? hostname.length() : MAX_FIELD_LENGTH);
+
+        if (capacity < static_cast<size_t>(BINARY_HEADER_SIZE) + host_length) {
+            capacity = 0;  // nu incape nici antetul - add() va refuza tot
+            return;
+        }
+
+        put<uint8_t>(0, BINARY_MAGIC);
+        put<uint8_t>(1, BINARY_SCHEMA);
+        put<uint16_t>(2, 0);
+        put<uint16_t>(4, host_length);
+        put<uint16_t>(6, flags);
+        put<int64_t>(8, timestamp_ns);
+        std::memcpy(out + BINARY_HEADER_SIZE, hostname.data(), host_length);
+
+        length = BINARY_HEADER_SIZE + host_length;
+    }
+
+    // false daca procesul nu mai incape (mesajul ramane valid, fara el)
+    bool add(const ProcessInfo& proc) {
+        size_t name_length = proc.name.length() < MAX_FIELD_LENGTH ? proc.name.length() : MAX_FIELD_LENGTH;
+        size_t user_length = proc.user.length() < MAX_FIELD_LENGTH ? proc.user.length() : MAX_FIELD_LENGTH;
+        size_t needed = BINARY_RECORD_SIZE + name_length + user_length;
+
+        if (capacity == 0 || needed > capacity - length || count == UINT16_MAX) {
+            return false;
+        }
+
+        put<double>(length, proc.cpu_percent);
+        put<uint64_t>(length + 8, static_cast<uint64_t>(proc.memory_kb));
+        put<int64_t>(length + 16, static_cast<int64_t>(proc.timestamp) * 1000000000LL);
+        put<int32_t>(length + 24, proc.pid);
+        put<uint8_t>(length + 28, BINARY_STATUS_CODES[static_cast<int>(proc.status)]);
+        put<uint8_t>(length + 29, BINARY_LEVEL_CODES[static_cast<int>(proc.log_level)]);
+        put<uint16_t>(length + 30, static_cast<uint16_t>(name_length));
+        put<uint16_t>(length + 32, static_cast<uint16_t>(user_length));
+        put<uint16_t>(length + 34, 0);
+        std::memcpy(out + length + BINARY_RECORD_SIZE, proc.name.data(), name_length);
+        std::memcpy(out + length + BINARY_RECORD_SIZE + name_length, proc.user.data(), user_length);
+
+        length += needed;
+        put<uint16_t>(2, ++count);
+        return true;
+    }
+
+    // proces disparut (intr-o delta) - ajunge doar PID-ul
+    bool add_removed(int pid) {
+        if (capacity == 0 || BINARY_RECORD_SIZE > capacity - length || count == UINT16_MAX) {
+            return false;
+        }
+
+        std::memset(out + length, 0, BINARY_RECORD_SIZE);
+        put<int32_t>(length + 24, pid);
+        put<uint16_t>(length + 34, BINARY_RECORD_REMOVED);
+
+        length += BINARY_RECORD_SIZE;
+        put<uint16_t>(2, ++count);
+        return true;
+    }
+
+    const char* data() const { return out; }
+    size_t size() const { return length; }
+    uint16_t records() const { return count; }
+};
+
+// scrie tot snapshot-ul in unul sau mai multe mesaje binare (cate incap in buffer) si da
+// fiecare mesaj gata lui sink(data, size); un cadru complet continua cu mesaje delta
+template <typename Sink>
+bool write_binary_messages(const ProcessSnapshot& snapshot, char* buffer, size_t capacity, Sink sink) {
+    uint16_t flags = snapshot.type == "KEYFRAME" ? BINARY_FLAG_KEYFRAME
+        : snapshot.type == "DELTA" ? BINARY_FLAG_DELTA : 0;
+    uint16_t continuation_flags = flags != 0 ? BINARY_FLAG_DELTA : 0;
+    int64_t timestamp_ns = static_cast<int64_t>(snapshot.timestamp) * 1000000000LL;
+
+    BinaryMessageWriter writer(buffer, capacity, snapshot.hostname, timestamp_ns, flags);
+
+    // mesajul curent e plin: il trimitem si incepem altul
+    auto next_message = [&]() -> bool {
+        if (writer.records() == 0) {
+            return false;  // nu incape nici macar o inregistrare
+        }
+        if (!sink(writer.data(), writer.size())) {
+            return false;
+        }
+        writer = BinaryMessageWriter(buffer, capacity, snapshot.hostname, timestamp_ns, continuation_flags);
+        return true;
+    };
+
+    for (const auto& proc : snapshot.processes) {
+        if (!writer.add(proc) && (!next_message() || !writer.add(proc))) {
+            return false;
+        }
+    }
+
+    for (int pid : snapshot.removed_pids) {
+        if (!writer.add_removed(pid) && (!next_message() || !writer.add_removed(pid))) {
+            return false;
+        }
+    }
+
+    return sink(writer.data(), writer.size());
+}
@@ -15,9 +15,34 @@
 #define SEND_TIMEOUT_MS 3000
 #define RECEIVE_TIMEOUT_MS 5000
 
-// delay intre trimiteri consecutive
-#define DELAY_BETWEEN_SENDS_MS 50
+// nivel compresie zlib cand serverul o accepta (1 = rapid ... 9 = maxim)
+#define COMPRESSION_LEVEL 6
 
-// configurare retry logic
+// snapshot-uri delta: un cadru complet (toate procesele) la fiecare N cicluri,
+// in rest doar procesele noi, disparute sau schimbate peste praguri
+#define KEYFRAME_INTERVAL_CYCLES 12
+#define DELTA_CPU_THRESHOLD 5.0
+#define DELTA_MEMORY_THRESHOLD_PERCENT 10
+
+// configurare retry logic (intre incercari asteptam dublu, pana la RECONNECT_MAX_DELAY_MS)
 #define MAX_RECONNECT_ATTEMPTS 3
-#define RECONNECT_DELAY_MS 2000
\ No newline at end of file
+#define RECONNECT_DELAY_MS 2000
+#define RECONNECT_MAX_DELAY_MS 30000
+
+// coada spre thread-ul de trimitere: cate cicluri asteapta (putere a lui 2) si cati
+// octeti aduna cel mult intr-o singura trimitere
+#define SEND_QUEUE_CAPACITY 16
+#define SEND_COALESCE_BYTES (64 * 1024)
+
+// pe Linux "aplicatiile" sunt procesele utilizatorilor obisnuiti (UID de la valoarea asta)
+#define LINUX_MIN_APP_UID 1000
+
+// colectarea metricilor pe procese se face in paralel: cate thread-uri (inclusiv cel
+// principal; 1 = serial) si de la cate procese pe thread merita sa impartim lista
+#define COLLECTOR_WORKER_THREADS 4
+#define COLLECTOR_MIN_PROCESSES_PER_WORKER 64
+
+// proc connector (Linux): la cate cicluri rescanam tot /proc ca plasa de siguranta si cate
+// evenimente tinem cel mult necitite (peste = le aruncam si rescanam)
+#define PROC_EVENTS_RESYNC_CYCLES 60
+#define PROC_EVENTS_MAX_PENDING 65536
\ No newline at end of file
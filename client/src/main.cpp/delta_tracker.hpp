@@ -0,0 +1,135 @@
+﻿#pragma once
+#include "log_types.hpp"
+#include "client_config.hpp"
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ce trimitem intr-un ciclu - vezi Server/include/stare_gazde.h
+struct SnapshotDelta {
+    bool keyframe;                          // true = toate procesele, serverul uita restul
+    std::vector<ProcessInfo> processes;     // procese noi + procese schimbate vizibil
+    std::vector<int> removed_pids;          // procese disparute de la ultimul ciclu
+    size_t added;
+    size_t changed;
+
+    SnapshotDelta() : keyframe(false), added(0), changed(0) {}
+
+    bool empty() const {
+        return !keyframe && processes.empty() && removed_pids.empty();
+    }
+};
+
+// tine minte ce a aflat serverul despre fiecare PID si trimite doar diferentele;
+// din cand in cand (si dupa orice problema de retea) trimite un cadru complet
+class DeltaTracker {
+private:
+    struct SentProcess {
+        ProcessInfo info;       // valorile trimise ultima data (nu cele colectate)
+        unsigned int cycle;     // ultimul ciclu in care procesul mai exista
+    };
+
+    std::unordered_map<int, SentProcess> last_sent;
+    unsigned int cycle;
+    int cycles_since_keyframe;
+    bool keyframe_pending;
+
+    // o schimbare merita trimisa doar daca se vede (CPU, memorie, status, nivel)
+    static bool changed_materially(const ProcessInfo& last, const ProcessInfo& now) {
+        if (now.status != last.status || now.log_level != last.log_level || now.user != last.user) {
+            return true;
+        }
+        if (std::fabs(now.cpu_percent - last.cpu_percent) >= DELTA_CPU_THRESHOLD) {
+            return true;
+        }
+
+        long long memory_change = now.memory_kb > last.memory_kb
+            ? now.memory_kb - last.memory_kb : last.memory_kb - now.memory_kb;
+        return memory_change > 0 &&
+            memory_change * 100 >= last.memory_kb * DELTA_MEMORY_THRESHOLD_PERCENT;
+    }
+
+public:
+    DeltaTracker() : cycle(0), cycles_since_keyframe(0), keyframe_pending(true) {}
+
+    // urmatorul ciclu trimite tot (conexiune noua, trimitere esuata)
+    void request_keyframe() {
+        keyframe_pending = true;
+    }
+
+    // compara procesele colectate cu ce stie serverul si pregateste ce trebuie trimis
+    SnapshotDelta build(const std::vector<ProcessInfo>& current) {
+        SnapshotDelta delta;
+        cycle++;
+
+        delta.keyframe = keyframe_pending || ++cycles_since_keyframe >= KEYFRAME_INTERVAL_CYCLES;
+        if (delta.keyframe) {
+            keyframe_pending = false;
+            cycles_since_keyframe = 0;
+        }
+
+        for (const auto& proc : current) {
+            auto found = last_sent.find(proc.pid);
+
+            // PID nou, sau PID refolosit de alt program
+            if (found == last_sent.end() || found->second.info.name != proc.name) {
+                last_sent[proc.pid] = SentProcess{ proc, cycle };
+                delta.processes.push_back(proc);
+                delta.added++;
+                continue;
+            }
+
+            found->second.cycle = cycle;
+
+            if (delta.keyframe || changed_materially(found->second.info, proc)) {
+                if (!delta.keyframe) {
+                    delta.changed++;
+                }
+                found->second.info = proc;
+                delta.processes.push_back(proc);
+            }
+        }
+
+        // ce nu a mai aparut in ciclul asta a disparut (la cadru complet serverul afla singur)
+        for (auto it = last_sent.begin(); it != last_sent.end();) {
+            if (it->second.cycle != cycle) {
+                if (!delta.keyframe) {
+                    delta.removed_pids.push_back(it->first);
+                }
+                it = last_sent.erase(it);
+            }
+            else {
+                ++it;
+            }
+        }
+
+        return delta;
+    }
+
+    // procese terminate intre cicluri (Linux, proc connector): trimitem ultima lor stare, cu
+    // statusul de iesire, si le scoatem si de pe server - nu asteptam ciclul urmator
+    SnapshotDelta report_exits(const std::vector<ProcessInfo>& exited) {
+        SnapshotDelta delta;
+        for (const auto& proc : exited) {
+            last_sent.erase(proc.pid);
+            delta.processes.push_back(proc);
+            delta.removed_pids.push_back(proc.pid);
+        }
+        return delta;
+    }
+
+    // delta ca snapshot de trimis; impartirea in mesaje o face serializarea
+    // (ProcessSnapshot::to_json_messages / write_binary_messages)
+    static ProcessSnapshot to_snapshot(const SnapshotDelta& delta,
+        const std::string& hostname, std::time_t timestamp) {
+        ProcessSnapshot snapshot;
+        snapshot.hostname = hostname;
+        snapshot.timestamp = timestamp;
+        snapshot.type = delta.keyframe ? "KEYFRAME" : "DELTA";
+        snapshot.processes = delta.processes;
+        snapshot.removed_pids = delta.removed_pids;
+        return snapshot;
+    }
+};
@@ -0,0 +1,132 @@
+﻿#pragma once
+#include "client_config.hpp"
+#include <charconv>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// caracterul c trebuie scris altfel in JSON? (ghilimele, backslash, caractere de control)
+inline bool json_needs_escape(char c) {
+    return c == '"' || c == '\\' || c < 0x20;
+}
+
+// scrie c escapat in out (cel putin 7 octeti) si intoarce lungimea
+inline size_t json_escape_char(char c, char* out) {
+    switch (c) {
+    case '"':  std::memcpy(out, "\\\"", 2); return 2;
+    case '\\': std::memcpy(out, "\\\\", 2); return 2;
+    case '\b': std::memcpy(out, "\\b", 2);  return 2;
+    case '\f': std::memcpy(out, "\\f", 2);  return 2;
+    case '\n': std::memcpy(out, "\\n", 2);  return 2;
+    case '\r': std::memcpy(out, "\\r", 2);  return 2;
+    case '\t': std::memcpy(out, "\\t", 2);  return 2;
+    default:
+        if (c < 0x20) {
+            snprintf(out, 7, "\\u%04x", static_cast<unsigned char>(c));
+            return 6;
+        }
+        out[0] = c;
+        return 1;
+    }
+}
+
+// scrie JSON direct intr-un buffer dat de apelant - fara stringstream si fara alocari.
+// Ce nu mai incape nu se scrie, buffer-ul ramane marcat "plin", iar apelantul se poate
+// intoarce la o pozitie salvata cu size() (rewind) si muta restul in mesajul urmator
+class JsonBuffer {
+private:
+    char* buffer;
+    size_t capacity;
+    size_t length;
+    bool overflow;
+
+public:
+    JsonBuffer(char* data, size_t data_capacity)
+        : buffer(data), capacity(data_capacity), length(0), overflow(false) {}
+
+    const char* data() const { return buffer; }
+    size_t size() const { return length; }
+
+    // a incaput tot ce s-a scris si mai raman cel putin 'reserve' octeti liberi
+    bool fits(size_t reserve = 0) const {
+        return !overflow && capacity - length >= reserve;
+    }
+
+    void rewind(size_t mark) {
+        length = mark;
+        overflow = false;
+    }
+
+    void clear() {
+        rewind(0);
+    }
+
+    void put(char c) {
+        if (length < capacity) {
+            buffer[length++] = c;
+        }
+        else {
+            overflow = true;
+        }
+    }
+
+    void put(const char* text, size_t text_length) {
+        if (text_length <= capacity - length) {
+            std::memcpy(buffer + length, text, text_length);
+            length += text_length;
+        }
+        else {
+            overflow = true;
+        }
+    }
+
+    template <size_t N>
+    void put(const char (&text)[N]) {
+        put(text, N - 1);
+    }
+
+    void put(const std::string& text) {
+        put(text.data(), text.length());
+    }
+
+    void put_int(long long value) {
+        char digits[24];
+        put(digits, static_cast<size_t>(std::to_chars(digits, digits + sizeof(digits), value).ptr - digits));
+    }
+
+    // ca un stream cu setarile implicite (6 cifre semnificative)
+    void put_double(double value) {
+        char digits[32];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::general, 6);
+        put(digits, static_cast<size_t>(result.ptr - digits));
+    }
+
+    // text escapat, taiat ca truncate_field la max_length ("..." la sfarsit)
+    void put_escaped(const char* text, size_t text_length, size_t max_length = MAX_FIELD_LENGTH) {
+        bool truncated = text_length > max_length;
+        if (truncated) {
+            text_length = max_length - 3;
+        }
+
+        // de obicei nu e nimic de escapat - o singura copiere pentru tot textul
+        size_t clean = 0;
+        while (clean < text_length && !json_needs_escape(text[clean])) {
+            clean++;
+        }
+        put(text, clean);
+
+        for (size_t i = clean; i < text_length; ++i) {
+            char escaped[8];
+            put(escaped, json_escape_char(text[i], escaped));
+        }
+
+        if (truncated) {
+            put("...");
+        }
+    }
+
+    void put_escaped(const std::string& text, size_t max_length = MAX_FIELD_LENGTH) {
+        put_escaped(text.data(), text.length(), max_length);
+    }
+};
@@ -1,9 +1,9 @@
 ﻿#pragma once
 #include "client_config.hpp"
+#include "json_writer.hpp"
 #include <string>
 #include <vector>
 #include <ctime>
-#include <sstream>
 #include <algorithm>
 
 enum class LogLevel {
@@ -16,7 +16,8 @@ enum class ProcessStatus {
     RUNNING,
     SLEEPING,
     STOPPED,
-    ZOMBIE
+    ZOMBIE,
+    CRASHED     // terminat de un semnal de eroare (vazut doar pe Linux, din proc connector)
 };
 
 inline std::string log_level_to_string(LogLevel level) {
@@ -34,6 +35,7 @@ inline std::string status_to_string(ProcessStatus status) {
     case ProcessStatus::SLEEPING: return "SLEEPING";
     case ProcessStatus::STOPPED:  return "STOPPED";
     case ProcessStatus::ZOMBIE:   return "ZOMBIE";
+    case ProcessStatus::CRASHED:  return "CRASHED";
     default:                      return "UNKNOWN";
     }
 }
@@ -49,29 +51,22 @@ inline std::string truncate_field(const std::string& str, size_t max_length = MA
 inline std::string escape_json(const std::string& str) {
     std::string truncated = truncate_field(str);
 
+    // cazul obisnuit: nimic de escapat, deci nici de copiat caracter cu caracter
+    size_t clean = 0;
+    while (clean < truncated.length() && !json_needs_escape(truncated[clean])) {
+        clean++;
+    }
+    if (clean == truncated.length()) {
+        return truncated;
+    }
+
     std::string result;
-    result.reserve(truncated.length() * 2); 
-
-    for (char c : truncated) {
-        switch (c) {
-        case '"':  result += "\\\""; break;
-        case '\\': result += "\\\\"; break;
-        case '\b': result += "\\b";  break;
-        case '\f': result += "\\f";  break;
-        case '\n': result += "\\n";  break;
-        case '\r': result += "\\r";  break;
-        case '\t': result += "\\t";  break;
-        default:
-            if (c < 0x20) {
-                char buf[7];
-                snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(c));
-                result += buf;
-            }
-            else {
-                result += c;
-            }
-            break;
-        }
+    result.reserve(truncated.length() * 2);
+    result.append(truncated, 0, clean);
+
+    for (size_t i = clean; i < truncated.length(); ++i) {
+        char escaped[8];
+        result.append(escaped, json_escape_char(truncated[i], escaped));
     }
 
     return result;
@@ -115,104 +110,175 @@ struct ProcessInfo {
         user = truncate_field(user);
     }
 
+    // procesul ca mesaj de sine statator (cu hostname); name/user taiate la field_limit
+    void write_json(JsonBuffer& out, const std::string& hostname, size_t field_limit = MAX_FIELD_LENGTH) const {
+        out.put("{\"hostname\":\"");
+        out.put_escaped(hostname);
+        out.put("\",\"timestamp\":");
+        out.put_int(timestamp);
+        out.put(",\"pid\":");
+        out.put_int(pid);
+        out.put(",\"name\":\"");
+        out.put_escaped(name, field_limit);
+        out.put("\",\"user\":\"");
+        out.put_escaped(user, field_limit);
+        out.put("\",\"cpu_percent\":");
+        out.put_double(cpu_percent);
+        out.put(",\"memory_kb\":");
+        out.put_int(memory_kb);
+        out.put(",\"status\":\"");
+        out.put(status_to_string(status));
+        out.put("\",\"log_level\":\"");
+        out.put(log_level_to_string(log_level));
+        out.put("\"}");
+    }
+
     std::string to_json(const std::string& hostname) const {
-        ProcessInfo normalized = *this;
-        normalized.normalize_fields();
-
-        std::string safe_hostname = truncate_field(hostname);
-
-        std::stringstream ss;
-        ss << "{"
-            << "\"hostname\":\"" << escape_json(safe_hostname) << "\","
-            << "\"timestamp\":" << normalized.timestamp << ","
-            << "\"pid\":" << normalized.pid << ","
-            << "\"name\":\"" << escape_json(normalized.name) << "\","
-            << "\"user\":\"" << escape_json(normalized.user) << "\","
-            << "\"cpu_percent\":" << normalized.cpu_percent << ","
-            << "\"memory_kb\":" << normalized.memory_kb << ","
-            << "\"status\":\"" << status_to_string(normalized.status) << "\","
-            << "\"log_level\":\"" << log_level_to_string(normalized.log_level) << "\""
-            << "}";
-
-        std::string json = ss.str();
-
-        if (json.length() > MAX_JSON_MESSAGE_SIZE) {
-          
-            normalized.name = truncate_field(normalized.name, 50);
-            normalized.user = truncate_field(normalized.user, 50);
-
-            ss.str("");
-            ss.clear();
-            ss << "{"
-                << "\"hostname\":\"" << escape_json(safe_hostname) << "\","
-                << "\"timestamp\":" << normalized.timestamp << ","
-                << "\"pid\":" << normalized.pid << ","
-                << "\"name\":\"" << escape_json(normalized.name) << "\","
-                << "\"user\":\"" << escape_json(normalized.user) << "\","
-                << "\"cpu_percent\":" << normalized.cpu_percent << ","
-                << "\"memory_kb\":" << normalized.memory_kb << ","
-                << "\"status\":\"" << status_to_string(normalized.status) << "\","
-                << "\"log_level\":\"" << log_level_to_string(normalized.log_level) << "\""
-                << "}";
-
-            json = ss.str();
-        }
+        char buffer[MAX_JSON_MESSAGE_SIZE];
+        JsonBuffer out(buffer, sizeof(buffer));
+        write_json(out, hostname);
 
-        return json;
-    }
+        if (!out.fits()) {
+            out.clear();
+            write_json(out, hostname, 50);
+        }
 
-    size_t estimate_json_size(const std::string& hostname) const {
-        return hostname.length() + name.length() + user.length() + 200; // +200 pentru overhead
+        return std::string(out.data(), out.size());
     }
 };
 
 struct ProcessSnapshot {
     std::string hostname;
     std::time_t timestamp;
+    std::string type;                   // "KEYFRAME" / "DELTA" (gol = snapshot simplu)
     std::vector<ProcessInfo> processes;
+    std::vector<int> removed_pids;      // doar la "DELTA"
 
     ProcessSnapshot() : hostname(""), timestamp(0) {}
 
-    std::string to_json() const {
-        std::string safe_hostname = truncate_field(hostname);
-
-        std::stringstream ss;
-        ss << "{"
-            << "\"hostname\":\"" << escape_json(safe_hostname) << "\","
-            << "\"timestamp\":" << timestamp << ","
-            << "\"processes\":[";
-
-        for (size_t i = 0; i < processes.size(); ++i) {
-            if (i > 0) ss << ",";
-
-            ProcessInfo normalized = processes[i];
-            normalized.normalize_fields();
-
-            ss << "{"
-                << "\"pid\":" << normalized.pid << ","
-                << "\"name\":\"" << escape_json(normalized.name) << "\","
-                << "\"user\":\"" << escape_json(normalized.user) << "\","
-                << "\"cpu_percent\":" << normalized.cpu_percent << ","
-                << "\"memory_kb\":" << normalized.memory_kb << ","
-                << "\"status\":\"" << status_to_string(normalized.status) << "\","
-                << "\"log_level\":\"" << log_level_to_string(normalized.log_level) << "\""
-                << "}";
-
-            if (ss.str().length() > MAX_JSON_MESSAGE_SIZE - 100) {
-                ss << ",{\"warning\":\"snapshot_truncated\"}";
-                break;
-            }
+    // un proces din lista "processes"
+    static void write_process_json(JsonBuffer& out, const ProcessInfo& proc) {
+        out.put("{\"pid\":");
+        out.put_int(proc.pid);
+        out.put(",\"name\":\"");
+        out.put_escaped(proc.name);
+        out.put("\",\"user\":\"");
+        out.put_escaped(proc.user);
+        out.put("\",\"cpu_percent\":");
+        out.put_double(proc.cpu_percent);
+        out.put(",\"memory_kb\":");
+        out.put_int(proc.memory_kb);
+        out.put(",\"status\":\"");
+        out.put(status_to_string(proc.status));
+        out.put("\",\"log_level\":\"");
+        out.put(log_level_to_string(proc.log_level));
+        out.put("\"}");
+    }
+
+    // inceputul unui mesaj, pana la lista de procese inclusiv
+    void write_message_header(JsonBuffer& out, const std::string& message_type) const {
+        out.put("{\"hostname\":\"");
+        out.put_escaped(hostname);
+        out.put("\",\"timestamp\":");
+        out.put_int(timestamp);
+        out.put(',');
+
+        // serverul trebuie sa afle tipul inainte de procese
+        if (!message_type.empty()) {
+            out.put("\"type\":\"");
+            out.put(message_type);
+            out.put("\",");
         }
 
-        ss << "]}";
-        return ss.str();
+        out.put("\"processes\":[");
     }
 
-    bool fits_in_single_message() const {
-        size_t estimated_size = hostname.length() + 100; // overhead
+    // tot snapshot-ul, in unul sau mai multe mesaje de cel mult MAX_JSON_MESSAGE_SIZE, scrise
+    // direct in buffer (ca write_binary_messages) si date pe rand lui sink(date, lungime).
+    // Nu se pierde niciun proces - ce nu mai incape merge in mesajul urmator. Un cadru
+    // complet continua cu mesaje "DELTA" (serverul il incheie dupa primul mesaj)
+    template <typename Sink>
+    bool write_json_messages(char* buffer, size_t capacity, Sink sink) const {
+        static const char REMOVED_KEY[] = ",\"removed_pids\":[";
+        const size_t closing_length = 2;  // "]}"
+
+        JsonBuffer out(buffer, capacity < MAX_JSON_MESSAGE_SIZE ? capacity : MAX_JSON_MESSAGE_SIZE);
+        const std::string continuation_type = type.empty() ? "" : "DELTA";
+
+        auto next_message = [&](const char* closing, size_t closing_size) {
+            out.put(closing, closing_size);
+            if (!out.fits() || !sink(out.data(), out.size())) {
+                return false;
+            }
+            out.clear();
+            write_message_header(out, continuation_type);
+            return true;
+        };
+
+        write_message_header(out, type);
+        size_t items = 0;
+
         for (const auto& proc : processes) {
-            estimated_size += proc.estimate_json_size(hostname);
+            size_t mark = out.size();
+            if (items > 0) out.put(',');
+            write_process_json(out, proc);
+
+            if (!out.fits(closing_length)) {
+                out.rewind(mark);
+                if (items == 0 || !next_message("]}", 2)) {
+                    return false;
+                }
+                items = 0;
+
+                write_process_json(out, proc);
+                if (!out.fits(closing_length)) {
+                    return false;
+                }
+            }
+            items++;
         }
-        return estimated_size <= MAX_JSON_MESSAGE_SIZE;
+        out.put(']');
+
+        // PID-urile disparute - la sfarsitul ultimului mesaj, cate incap
+        size_t pids = 0;
+        for (int pid : removed_pids) {
+            size_t mark = out.size();
+            if (pids > 0) out.put(',');
+            else out.put(REMOVED_KEY);
+            out.put_int(pid);
+
+            if (!out.fits(closing_length)) {
+                out.rewind(mark);
+                if ((items == 0 && pids == 0) || !next_message(pids > 0 ? "]}" : "}", pids > 0 ? 2 : 1)) {
+                    return false;
+                }
+                items = 0;
+
+                out.put(']');
+                out.put(REMOVED_KEY);
+                out.put_int(pid);
+                if (!out.fits(closing_length)) {
+                    return false;
+                }
+                pids = 0;
+            }
+            pids++;
+        }
+
+        if (pids > 0) out.put(']');
+        out.put('}');
+        return out.fits() && sink(out.data(), out.size());
+    }
+
+    // aceleasi mesaje, ca string-uri
+    std::vector<std::string> to_json_messages() const {
+        thread_local char buffer[MAX_JSON_MESSAGE_SIZE];
+
+        std::vector<std::string> messages;
+        write_json_messages(buffer, sizeof(buffer), [&messages](const char* data, size_t size) {
+            messages.emplace_back(data, size);
+            return true;
+        });
+        return messages;
     }
 };
\ No newline at end of file
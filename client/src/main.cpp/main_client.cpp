@@ -1,9 +1,16 @@
-﻿#define WIN32_LEAN_AND_MEAN
+﻿#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
 #include <windows.h>
+#else
+#include <csignal>
+#endif
 
 #include "process_collector.hpp"
 #include "network_client.hpp"
 #include "log_types.hpp"
+#include "binary_protocol.hpp"
+#include "delta_tracker.hpp"
+#include "async_sender.hpp"
 #include "client_config.hpp"
 #include <iostream>
 #include <thread>
@@ -14,6 +21,7 @@
 std::atomic<bool> running(true);
 std::atomic<bool> shutdown_in_progress(false);
 
+#ifdef _WIN32
 // handler pentru Ctrl+C 
 BOOL WINAPI ConsoleHandler(DWORD signal) {
     if (signal == CTRL_C_EVENT || signal == CTRL_CLOSE_EVENT) {
@@ -27,10 +35,40 @@ BOOL WINAPI ConsoleHandler(DWORD signal) {
     return FALSE;
 }
 
+static bool install_stop_handler() {
+    return SetConsoleCtrlHandler(ConsoleHandler, TRUE) != FALSE;
+}
+
+static void remove_stop_handler() {
+    SetConsoleCtrlHandler(ConsoleHandler, FALSE);
+}
+#else
+// handler pentru Ctrl+C (SIGINT) si kill (SIGTERM) - intr-un handler de semnal nu avem voie
+// sa scriem cu std::cout, asa ca doar oprim bucla (mesajul de inchidere il scrie main)
+extern "C" void stop_signal_handler(int) {
+    shutdown_in_progress.store(true);
+    running.store(false);
+}
+
+static bool install_stop_handler() {
+    struct sigaction action = {};
+    action.sa_handler = stop_signal_handler;
+    sigemptyset(&action.sa_mask);
+    return sigaction(SIGINT, &action, nullptr) == 0 && sigaction(SIGTERM, &action, nullptr) == 0;
+}
+
+static void remove_stop_handler() {
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+}
+#endif
+
 int main(int argc, char* argv[]) {
+#ifdef _WIN32
     // configurare pentru a preveni crash-uri
     SetErrorMode(SEM_NOGPFAULTERRORBOX | SEM_FAILCRITICALERRORS);
     SetConsoleOutputCP(CP_UTF8);
+#endif
 
     std::string server_ip = "192.168.0.213";  // MODIFICA IP !!!!!
     int server_port = 8080;
@@ -47,7 +85,7 @@ int main(int argc, char* argv[]) {
     std::cout << "Foloseste Ctrl+C pentru a opri" << std::endl << std::endl;
 
     // inregistreaza handler-ul pentru Ctrl+C
-    if (!SetConsoleCtrlHandler(ConsoleHandler, TRUE)) {
+    if (!install_stop_handler()) {
         std::cerr << "EROARE: Nu se poate inregistra handler-ul pentru Ctrl+C" << std::endl;
         return 1;
     }
@@ -68,44 +106,85 @@ int main(int argc, char* argv[]) {
             std::cerr << "  3. IP-ul este accesibil? (ping " << server_ip << ")" << std::endl;
 
             // cleanup inainte de iesire
-            SetConsoleCtrlHandler(ConsoleHandler, FALSE);
+            remove_stop_handler();
             return 1;
         }
     }
     catch (const std::exception& e) {
         std::cerr << "EROARE la initializare: " << e.what() << std::endl;
-        SetConsoleCtrlHandler(ConsoleHandler, FALSE);
+        remove_stop_handler();
         return 1;
     }
 
     std::cout << "Socket conectat cu succes!" << std::endl;
     std::cout << "Trimitere mesaj de handshake..." << std::endl;
 
-    // Handshake initial
+    // Handshake initial - anuntam schema binara si compresia pe care le stim
     std::string hostname = ProcessCollector::get_hostname();
     std::string hello_msg = "{\"type\":\"HELLO\",\"client_name\":\"" +
-        hostname + "\",\"version\":\"1.0\"}";
+        hostname + "\",\"version\":\"1.0\",\"binary_schema\":" +
+        std::to_string(BINARY_SCHEMA) + ",\"compression\":\"" COMPRESSION_NAME "\"}";
 
     if (!client.send_message(hello_msg)) {
         std::cerr << "EROARE: Nu se poate trimite mesaj de handshake!" << std::endl;
         client.disconnect();
-        SetConsoleCtrlHandler(ConsoleHandler, FALSE);
+        remove_stop_handler();
         return 1;
     }
 
-    // primeste welcome DOAR o data la inceput
+    // primeste welcome DOAR o data la inceput - din el aflam formatul (binar sau JSON)
+    bool use_binary = false;
     std::string welcome_msg;
     if (client.receive_message(welcome_msg, 5000)) {
+        use_binary = server_accepts_binary(welcome_msg);
+        if (server_accepts_compression(welcome_msg) && !client.enable_compression()) {
+            std::cerr << "AVERTISMENT: Nu se poate porni compresia" << std::endl;
+        }
         std::cout << "Raspuns de la server: " << welcome_msg << std::endl;
-        std::cout << "Conectat si autentificat cu succes!" << std::endl << std::endl;
+        std::cout << "Conectat si autentificat cu succes!" << std::endl;
+        std::cout << "Format mesaje: " << (use_binary ? "binar" : "JSON")
+            << (client.compression_enabled() ? ", comprimat (" COMPRESSION_NAME ")" : "") << std::endl << std::endl;
     }
     else {
-        std::cout << "AVERTISMENT: Nu s-a primit raspuns de la server (continuam oricum...)" << std::endl << std::endl;
+        std::cout << "AVERTISMENT: Nu s-a primit raspuns de la server (continuam oricum cu JSON...)" << std::endl << std::endl;
     }
 
+    // buffer pentru mesaje (binare sau JSON) - scriem direct in el, fara alocari
+    static char message_buffer[MAX_JSON_MESSAGE_SIZE];
+
+    // ce stie serverul despre procesele noastre - primul ciclu e un cadru complet
+    DeltaTracker tracker;
+
     int total_processes_sent = 0;
     int cycle_count = 0;
 
+    // de aici incolo conexiunea e a thread-ului de trimitere (si reconectarile)
+    AsyncSender sender(client, server_ip, server_port, hello_msg, use_binary);
+    sender.start();
+
+    // serializeaza delta ciclului in formatul negociat (binar sau JSON), gata de pus in coada
+    auto make_batch = [&](const SnapshotDelta& delta, OutgoingBatch& batch) -> bool {
+        ProcessSnapshot snapshot = DeltaTracker::to_snapshot(delta, hostname, std::time(nullptr));
+
+        batch.binary = sender.use_binary();
+        batch.processes = snapshot.processes.size();
+
+        auto add_frame = [&batch](const char* data, size_t size) {
+            batch.frames.emplace_back(data, size);
+            return true;
+        };
+
+        if (batch.binary) {
+            return write_binary_messages(snapshot, message_buffer, sizeof(message_buffer), add_frame);
+        }
+
+        if (!snapshot.write_json_messages(message_buffer, sizeof(message_buffer), add_frame)) {
+            std::cerr << "EROARE la serializarea snapshot-ului" << std::endl;
+            return false;
+        }
+        return true;
+    };
+
     // bucla principala cu PROTECTIE COMPLETA
     while (running.load()) {
         try {
@@ -170,115 +249,52 @@ int main(int argc, char* argv[]) {
                         break;
                     }
                 }
+            }
 
-                if (!running.load()) break;
-
-                std::cout << "\nTrimiteri individuale:" << std::endl;
-
-                // trimitem fiecare proces individual
-                int sent_in_cycle = 0;
-                for (const auto& proc : app_processes) {
-                    // verificare la fiecare iteratie
-                    if (!running.load()) {
-                        std::cout << "Oprire detectata - abandonam trimiterea" << std::endl;
-                        break;
-                    }
-
-                    std::string json_data;
-                    try {
-                        json_data = proc.to_json(hostname);
-                    }
-                    catch (const std::exception& e) {
-                        std::cerr << "EROARE la serializarea procesului " << proc.name
-                            << ": " << e.what() << std::endl;
-                        continue;
-                    }
-
-                    // VALIDARE CRITICA: verifica dimensiunea mesajului
-                    if (json_data.length() > MAX_JSON_MESSAGE_SIZE) {
-                        std::cerr << "  -> AVERTISMENT: Mesaj prea mare pentru " << proc.name
-                            << " (" << json_data.length() << " bytes > "
-                            << MAX_JSON_MESSAGE_SIZE << " bytes) - OMIS" << std::endl;
-                        continue;
-                    }
-
-                    if (json_data.length() > CLIENT_BUFFER_SIZE) {
-                        std::cerr << "  -> EROARE: Mesaj depaseste buffer-ul pentru " << proc.name
-                            << " - OMIS" << std::endl;
-                        continue;
-                    }
+            if (!running.load()) break;
 
-                    // verificare inainte de trimitere
-                    if (!running.load()) break;
+            // dupa o pierdere (reconectare, lot aruncat) serverul primeste din nou tot
+            if (sender.take_keyframe_request()) {
+                tracker.request_keyframe();
+            }
 
-                    bool send_success = false;
-                    try {
-                        send_success = client.send_message(json_data);
-                    }
-                    catch (const std::exception& e) {
-                        std::cerr << "EXCEPTIE la trimitere: " << e.what() << std::endl;
-                        send_success = false;
-                    }
+            // trimitem doar ce s-a schimbat de la ciclul trecut (sau tot, la cadru complet)
+            SnapshotDelta delta = tracker.build(app_processes);
+            std::cout << "\nDelta: +" << delta.added << " ~" << delta.changed
+                << " -" << delta.removed_pids.size()
+                << (delta.keyframe ? " (cadru complet)" : "") << std::endl;
 
-                    if (send_success) {
-                        sent_in_cycle++;
-                        total_processes_sent++;
-                        std::cout << "  -> Trimis: " << proc.name << " [" << sent_in_cycle
-                            << "/" << app_processes.size() << "] ("
-                            << json_data.length() << " bytes)" << std::endl;
-
-                        // pauză intre trimiteri - cu verificare
-                        for (int i = 0; i < DELAY_BETWEEN_SENDS_MS / 10 && running.load(); ++i) {
-                            std::this_thread::sleep_for(std::chrono::milliseconds(10));
-                        }
-                    }
-                    else {
-                        std::cerr << "  -> EROARE la trimiterea procesului PID="
-                            << proc.pid << " (" << proc.name << ")" << std::endl;
-
-                        // verificare inainte de reconectare
-                        if (!running.load()) break;
-
-                        std::cout << "  -> Incercare de reconectare..." << std::endl;
-
-                        try {
-                            client.disconnect();
-                            std::this_thread::sleep_for(std::chrono::seconds(1));
-
-                            if (!running.load()) break;
-
-                            if (client.connect_to_server(server_ip, server_port)) {
-                                std::cout << "  -> Reconectat cu succes!" << std::endl;
-
-                                // trimite doar handshake, NU asteapta raspuns
-                                if (client.send_message(hello_msg)) {
-                                    std::cout << "  -> Handshake trimis" << std::endl;
-                                    std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                                }
-
-                                if (!running.load()) break;
-
-                                // reincercam sa trimitem procesul curent
-                                if (client.send_message(json_data)) {
-                                    sent_in_cycle++;
-                                    total_processes_sent++;
-                                    std::cout << "  -> Proces retrimis cu succes dupa reconectare" << std::endl;
-                                }
-                            }
-                            else {
-                                std::cerr << "  -> Reconectare esuata!" << std::endl;
-                            }
-                        }
-                        catch (const std::exception& e) {
-                            std::cerr << "  -> EXCEPTIE la reconectare: " << e.what() << std::endl;
-                        }
+            if (delta.empty()) {
+                std::cout << "  -> Nicio schimbare - nu trimitem nimic" << std::endl;
+            }
+            else {
+                OutgoingBatch batch;
+                if (make_batch(delta, batch)) {
+                    size_t frames = batch.frames.size();
+                    total_processes_sent += static_cast<int>(batch.processes);
+
+                    // coada plina: cel mai vechi lot se pierde, iar ciclul urmator e un cadru complet
+                    if (!sender.enqueue(batch)) {
+                        std::cerr << "  -> AVERTISMENT: Coada de trimitere plina - am renuntat la cel mai vechi lot"
+                            << std::endl;
                     }
-
-                    // verificare finala
-                    if (!running.load()) break;
+                    std::cout << "  -> In coada: " << delta.processes.size() << " procese, "
+                        << delta.removed_pids.size() << " disparute in " << frames << " mesaj(e)" << std::endl;
                 }
+                else {
+                    tracker.request_keyframe();
+                }
+            }
 
-                std::cout << "\nTotal trimis in acest ciclu: " << sent_in_cycle << " aplicatii" << std::endl;
+            SenderStats stats = sender.stats();
+            std::cout << "\nTrimitere: " << (stats.connected ? "conectat" : "DECONECTAT")
+                << ", in coada " << stats.queued << "/" << SEND_QUEUE_CAPACITY
+                << ", trimise " << stats.batches_sent << " loturi (" << stats.frames_sent << " mesaje, "
+                << stats.bytes_sent << " bytes), pierdute " << stats.batches_dropped
+                << ", reconectari " << stats.reconnects << std::endl;
+            if (stats.compression_ratio > 0.0) {
+                std::cout << "Compresie pe conexiune: x" << stats.compression_ratio
+                    << ", deflate " << stats.compression_cpu_ms << " ms procesor" << std::endl;
             }
 
             // verificare inainte de cleanup
@@ -305,9 +321,25 @@ int main(int argc, char* argv[]) {
             if (sleep_time > 0) {
                 std::cout << "\nAsteptare " << sleep_time << " secunde pana la urmatorul ciclu..." << std::endl;
 
-                // sleep cu verificari la fiecare secunda
-                for (int i = 0; i < sleep_time && running.load(); ++i) {
-                    std::this_thread::sleep_for(std::chrono::seconds(1));
+                // sleep cu verificari la fiecare secunda; procesele terminate intre timp (unde
+                // colectorul are evenimente de la kernel) sunt anuntate pe loc
+                auto wake_time = end_time + std::chrono::seconds(sleep_time);
+                while (running.load() && std::chrono::steady_clock::now() < wake_time) {
+                    auto slice = std::min<std::chrono::milliseconds>(std::chrono::seconds(1),
+                        std::chrono::duration_cast<std::chrono::milliseconds>(wake_time - std::chrono::steady_clock::now()));
+                    std::vector<ProcessInfo> exited = ProcessCollector::wait_for_exits(slice, true);
+                    if (exited.empty()) {
+                        continue;
+                    }
+
+                    OutgoingBatch batch;
+                    if (make_batch(tracker.report_exits(exited), batch)) {
+                        sender.enqueue(batch);
+                        std::cout << "  -> Procese terminate: " << exited.size() << " (anuntate imediat)" << std::endl;
+                    }
+                    else {
+                        tracker.request_keyframe();
+                    }
                 }
             }
 
@@ -341,6 +373,9 @@ int main(int argc, char* argv[]) {
    
     std::cout << "\n\n=== Inchidere aplicatie ===" << std::endl;
 
+    // thread-ul de trimitere goleste coada si ne da conexiunea inapoi
+    sender.stop();
+
     // trimite goodbye DOAR daca suntem conectati
     try {
         if (client.is_connected()) {
@@ -368,11 +403,12 @@ int main(int argc, char* argv[]) {
     }
 
     // dezinregistreaza handler-ul
-    SetConsoleCtrlHandler(ConsoleHandler, FALSE);
+    remove_stop_handler();
 
     std::cout << "\n=== Client oprit cu succes! ===" << std::endl;
     std::cout << "Total cicluri: " << cycle_count << std::endl;
-    std::cout << "Total aplicatii trimise: " << total_processes_sent << std::endl;
+    std::cout << "Total aplicatii puse in coada: " << total_processes_sent << std::endl;
+    std::cout << "Loturi pierdute: " << sender.stats().batches_dropped << std::endl;
 
     return 0;
 }
\ No newline at end of file
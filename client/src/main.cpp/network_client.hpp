@@ -1,16 +1,49 @@
 ﻿#pragma once
 #include <string>
+#include <vector>
+#include <cstring>
 #include <stdexcept>
 
+#ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
 #include <windows.h>
 #include <winsock2.h>
 #include <ws2tcpip.h>
-#include <iostream>
-#include "client_config.hpp"
 
 #pragma comment(lib, "ws2_32.lib")
 
+// send() spre o conexiune inchisa intoarce doar o eroare
+#define SEND_FLAGS 0
+#else
+// pe Linux: socket-uri POSIX, cu aceleasi nume ca Winsock
+#include <arpa/inet.h>
+#include <cerrno>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+typedef int SOCKET;
+#define INVALID_SOCKET (-1)
+#define SOCKET_ERROR (-1)
+#define SD_BOTH SHUT_RDWR
+#define closesocket close
+#define WSAGetLastError() (errno)
+#define WSAECONNREFUSED ECONNREFUSED
+#define WSAETIMEDOUT ETIMEDOUT
+#define WSAEHOSTUNREACH EHOSTUNREACH
+#define WSAENETUNREACH ENETUNREACH
+#define WSAEWOULDBLOCK EWOULDBLOCK
+
+// fara MSG_NOSIGNAL, send() spre o conexiune inchisa opreste procesul (SIGPIPE)
+#define SEND_FLAGS MSG_NOSIGNAL
+#endif
+
+#include <iostream>
+#include "client_config.hpp"
+#include "stream_compression.hpp"
+
 class NetworkClient {
 private:
     SOCKET sock_fd;
@@ -18,25 +51,73 @@ private:
     bool wsa_initialized;
     char send_buffer[CLIENT_BUFFER_SIZE];
     char recv_buffer[CLIENT_BUFFER_SIZE];
+    StreamCompressor compressor;
+
+    // trimite toti octetii (send poate trimite doar o parte)
+    bool send_all(const char* data, size_t length) {
+        size_t total_sent = 0;
+        while (total_sent < length) {
+            int chunk = send(sock_fd, data + total_sent,
+                static_cast<int>(length - total_sent), SEND_FLAGS);
+
+            if (chunk == SOCKET_ERROR) {
+                int error = WSAGetLastError();
+                std::cerr << "EROARE la trimiterea mesajului: " << error << std::endl;
+                connected = false;
+                return false;
+            }
+
+            total_sent += chunk;
+        }
+        return true;
+    }
+
+    // timeout pentru recv/send (SO_RCVTIMEO / SO_SNDTIMEO): Winsock il vrea in ms, POSIX ca timeval
+    void set_timeout(int option, int timeout_ms) {
+#ifdef _WIN32
+        DWORD timeout = timeout_ms;
+#else
+        timeval timeout;
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_usec = (timeout_ms % 1000) * 1000;
+#endif
+        setsockopt(sock_fd, SOL_SOCKET, option, (const char*)&timeout, sizeof(timeout));
+    }
+
+    // recv() a expirat (SO_RCVTIMEO) - pe Linux vine ca EAGAIN
+    static bool is_timeout_error(int error) {
+#ifdef _WIN32
+        return error == WSAETIMEDOUT;
+#else
+        return error == EAGAIN || error == EWOULDBLOCK;
+#endif
+    }
 
 public:
     NetworkClient() : sock_fd(INVALID_SOCKET), connected(false), wsa_initialized(false) {
+#ifdef _WIN32
         WSADATA wsaData;
         int result = WSAStartup(MAKEWORD(2, 2), &wsaData);
         if (result != 0) {
             throw std::runtime_error("WSAStartup failed");
         }
         wsa_initialized = true;
+#endif
     }
 
     ~NetworkClient() {
         disconnect();
+#ifdef _WIN32
         if (wsa_initialized) {
             WSACleanup();
         }
+#endif
     }
 
     bool connect_to_server(const std::string& server_ip, int port) {
+        // conexiune noua = flux de compresie nou (se negociaza din nou la HELLO)
+        compressor.reset();
+
         if (sock_fd != INVALID_SOCKET) {
             closesocket(sock_fd);
             sock_fd = INVALID_SOCKET;
@@ -51,17 +132,16 @@ public:
         }
 
        
-        DWORD timeout = CONNECTION_TIMEOUT_MS;
-        setsockopt(sock_fd, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
-        setsockopt(sock_fd, SOL_SOCKET, SO_SNDTIMEO, (const char*)&timeout, sizeof(timeout));
+        set_timeout(SO_RCVTIMEO, CONNECTION_TIMEOUT_MS);
+        set_timeout(SO_SNDTIMEO, CONNECTION_TIMEOUT_MS);
 
-        char flag = 1;
-        setsockopt(sock_fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+        int flag = 1;
+        setsockopt(sock_fd, IPPROTO_TCP, TCP_NODELAY, (const char*)&flag, sizeof(flag));
 
         sockaddr_in server_addr;
-        ZeroMemory(&server_addr, sizeof(server_addr));
+        std::memset(&server_addr, 0, sizeof(server_addr));
         server_addr.sin_family = AF_INET;
-        server_addr.sin_port = htons(static_cast<u_short>(port));
+        server_addr.sin_port = htons(static_cast<uint16_t>(port));
 
         int result = inet_pton(AF_INET, server_ip.c_str(), &server_addr.sin_addr);
         if (result <= 0) {
@@ -105,27 +185,46 @@ public:
     }
 
     bool send_message(const std::string& message) {
+        return send_bytes(message.data(), message.length());
+    }
+
+    // trimite un mesaj oarecare (JSON sau binar) cu lungimea in fata
+    bool send_bytes(const char* message, size_t length) {
         if (!connected || sock_fd == INVALID_SOCKET) {
             std::cerr << "EROARE: Nu exista conexiune activa" << std::endl;
             return false;
         }
 
-        if (message.length() >= CLIENT_BUFFER_SIZE) {
-            std::cerr << "EROARE: Mesaj prea mare (" << message.length()
+        if (length >= CLIENT_BUFFER_SIZE) {
+            std::cerr << "EROARE: Mesaj prea mare (" << length
                 << " >= " << CLIENT_BUFFER_SIZE << ")" << std::endl;
             return false;
         }
 
-        if (message.empty()) {
+        if (length == 0) {
             std::cerr << "EROARE: Mesaj gol" << std::endl;
             return false;
         }
 
-        uint32_t msg_len = static_cast<uint32_t>(message.length());
+        uint32_t msg_len = static_cast<uint32_t>(length);
         uint32_t msg_len_network = htonl(msg_len);
 
+        // comprimat: antetul si mesajul trec prin acelasi flux, golit la sfarsitul mesajului
+        if (compressor.active()) {
+            auto sink = [this](const char* data, size_t size) { return send_all(data, size); };
+
+            if (!compressor.compress(reinterpret_cast<const char*>(&msg_len_network), sizeof(msg_len_network),
+                    false, send_buffer, sizeof(send_buffer), sink) ||
+                !compressor.compress(message, length, true, send_buffer, sizeof(send_buffer), sink)) {
+                std::cerr << "EROARE la trimiterea mesajului comprimat" << std::endl;
+                connected = false;
+                return false;
+            }
+            return true;
+        }
+
         int sent = send(sock_fd, reinterpret_cast<const char*>(&msg_len_network),
-            sizeof(msg_len_network), 0);
+            sizeof(msg_len_network), SEND_FLAGS);
 
         if (sent != sizeof(msg_len_network)) {
             int error = WSAGetLastError();
@@ -134,22 +233,80 @@ public:
             return false;
         }
 
-        size_t total_sent = 0;
-        while (total_sent < message.length()) {
-            int chunk = send(sock_fd, message.c_str() + total_sent,
-                static_cast<int>(message.length() - total_sent), 0);
+        return send_all(message, length);
+    }
 
-            if (chunk == SOCKET_ERROR) {
-                int error = WSAGetLastError();
-                std::cerr << "EROARE la trimiterea mesajului: " << error << std::endl;
+    // trimite mai multe mesaje deodata: se aduna in buffer si pleaca cu cat mai putine
+    // send() (comprimat - o singura golire a compresorului, la sfarsit)
+    bool send_batch(const std::vector<std::string>& messages) {
+        if (!connected || sock_fd == INVALID_SOCKET) {
+            std::cerr << "EROARE: Nu exista conexiune activa" << std::endl;
+            return false;
+        }
+
+        auto sink = [this](const char* data, size_t size) { return send_all(data, size); };
+        size_t buffered = 0;
+
+        for (const auto& message : messages) {
+            if (message.empty() || message.length() > CLIENT_BUFFER_SIZE - sizeof(uint32_t)) {
+                std::cerr << "EROARE: Mesaj de " << message.length() << " bytes - OMIS" << std::endl;
+                continue;
+            }
+
+            uint32_t msg_len_network = htonl(static_cast<uint32_t>(message.length()));
+
+            if (compressor.active()) {
+                if (!compressor.compress(reinterpret_cast<const char*>(&msg_len_network), sizeof(msg_len_network),
+                        false, send_buffer, sizeof(send_buffer), sink) ||
+                    !compressor.compress(message.data(), message.length(), false,
+                        send_buffer, sizeof(send_buffer), sink)) {
+                    std::cerr << "EROARE la trimiterea mesajelor comprimate" << std::endl;
+                    connected = false;
+                    return false;
+                }
+                continue;
+            }
+
+            // nu mai incape in buffer - trimitem ce am adunat pana acum
+            if (buffered + sizeof(msg_len_network) + message.length() > sizeof(send_buffer)) {
+                if (!send_all(send_buffer, buffered)) {
+                    return false;
+                }
+                buffered = 0;
+            }
+
+            std::memcpy(send_buffer + buffered, &msg_len_network, sizeof(msg_len_network));
+            std::memcpy(send_buffer + buffered + sizeof(msg_len_network), message.data(), message.length());
+            buffered += sizeof(msg_len_network) + message.length();
+        }
+
+        if (compressor.active()) {
+            if (!compressor.compress(nullptr, 0, true, send_buffer, sizeof(send_buffer), sink)) {
+                std::cerr << "EROARE la trimiterea mesajelor comprimate" << std::endl;
                 connected = false;
                 return false;
             }
-
-            total_sent += chunk;
+            return true;
         }
 
-        return true;
+        return buffered == 0 || send_all(send_buffer, buffered);
+    }
+
+    // dupa ce serverul a acceptat compresia in raspunsul de bun venit
+    bool enable_compression() {
+        return compressor.start();
+    }
+
+    bool compression_enabled() const {
+        return compressor.active();
+    }
+
+    double compression_ratio() const {
+        return compressor.ratio();
+    }
+
+    double compression_cpu_ms() const {
+        return compressor.cpu_ms();
     }
 
     bool receive_message(std::string& message, int timeout_ms = RECEIVE_TIMEOUT_MS) {
@@ -159,8 +316,7 @@ public:
         }
 
        
-        DWORD timeout = timeout_ms;
-        setsockopt(sock_fd, SOL_SOCKET, SO_RCVTIMEO, (const char*)&timeout, sizeof(timeout));
+        set_timeout(SO_RCVTIMEO, timeout_ms);
 
         uint32_t msg_len_network;
         int received = recv(sock_fd, reinterpret_cast<char*>(&msg_len_network),
@@ -169,7 +325,7 @@ public:
         if (received != sizeof(msg_len_network)) {
             if (received == SOCKET_ERROR) {
                 int error = WSAGetLastError();
-                if (error == WSAETIMEDOUT) {
+                if (is_timeout_error(error)) {
                     return false;
                 }
                 else {
@@ -243,6 +399,8 @@ public:
     }
 
     void disconnect() {
+        compressor.reset();
+
         if (sock_fd != INVALID_SOCKET) {
             shutdown(sock_fd, SD_BOTH);
             closesocket(sock_fd);
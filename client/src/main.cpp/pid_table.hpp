@@ -0,0 +1,156 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// tabela plata PID -> date despre proces (adresare deschisa, sondare liniara, capacitate
+// putere a lui 2). Cheia e PID + momentul pornirii: un PID refolosit de alt proces are alt
+// moment de pornire si primeste o intrare curata. Fiecare intrare tine minte ciclul in care
+// a fost vazuta ultima oara, asa ca sweep() scoate intr-o trecere tot ce nu a mai aparut -
+// fara liste de PID-uri construite la fiecare ciclu
+template <typename Value>
+class PidTable {
+private:
+    struct Slot {
+        bool used;
+        int pid;
+        unsigned long long start_time;
+        unsigned int generation;
+        Value value;
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    size_t capacity;
+    size_t count;
+    unsigned int generation;
+
+    static size_t hash(int pid) {
+        uint32_t x = static_cast<uint32_t>(pid);
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+
+    size_t home(int pid) const {
+        return hash(pid) & (capacity - 1);
+    }
+
+    void allocate(size_t new_capacity) {
+        slots.reset(new Slot[new_capacity]);
+        capacity = new_capacity;
+        for (size_t i = 0; i < capacity; ++i) {
+            slots[i].used = false;
+        }
+    }
+
+    void grow() {
+        std::unique_ptr<Slot[]> old_slots = std::move(slots);
+        size_t old_capacity = capacity;
+        allocate(old_capacity * 2);
+
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (!old_slots[i].used) {
+                continue;
+            }
+
+            size_t index = home(old_slots[i].pid);
+            while (slots[index].used) {
+                index = (index + 1) & (capacity - 1);
+            }
+            slots[index] = std::move(old_slots[i]);
+        }
+    }
+
+    // stergere cu deplasare inapoi: urmatoarele intrari din acelasi lant urca in golul lasat,
+    // deci cautarile nu au nevoie de marcaje de "sters"
+    void erase_at(size_t index) {
+        size_t mask = capacity - 1;
+        size_t hole = index;
+        size_t next = (hole + 1) & mask;
+
+        while (slots[next].used) {
+            size_t next_home = home(slots[next].pid);
+            // intrarea poate urca in gol doar daca golul e intre locul ei ideal si ea
+            if (((next - next_home) & mask) >= ((next - hole) & mask)) {
+                slots[hole] = std::move(slots[next]);
+                hole = next;
+            }
+            next = (next + 1) & mask;
+        }
+
+        slots[hole].used = false;
+        slots[hole].value = Value();
+        count--;
+    }
+
+public:
+    explicit PidTable(size_t initial_capacity = 256) : capacity(0), count(0), generation(1) {
+        size_t power = 16;
+        while (power < initial_capacity) power *= 2;
+        allocate(power);
+    }
+
+    PidTable(const PidTable&) = delete;
+    PidTable& operator=(const PidTable&) = delete;
+
+    // ciclu nou: ce se atinge de acum inainte e "vazut", restul pleaca la sweep()
+    void begin_cycle() {
+        generation++;
+    }
+
+    // intrarea procesului, marcata ca vazuta in ciclul curent; created = true daca e noua
+    // (proces nou sau PID refolosit - atunci valoarea veche se sterge). Referinta e valabila
+    // pana la urmatorul touch/sweep
+    Value& touch(int pid, unsigned long long start_time, bool& created) {
+        // incarcare maxima 70%
+        if ((count + 1) * 10 > capacity * 7) {
+            grow();
+        }
+
+        size_t index = home(pid);
+        while (slots[index].used && slots[index].pid != pid) {
+            index = (index + 1) & (capacity - 1);
+        }
+
+        Slot& slot = slots[index];
+        created = !slot.used || slot.start_time != start_time;
+
+        if (!slot.used) {
+            slot.used = true;
+            slot.pid = pid;
+            count++;
+        }
+        if (created) {
+            slot.start_time = start_time;
+            slot.value = Value();
+        }
+
+        slot.generation = generation;
+        return slot.value;
+    }
+
+    // scoate intrarile care nu au fost atinse in ciclul curent; intoarce cate au iesit
+    size_t sweep() {
+        size_t removed = 0;
+        size_t index = 0;
+
+        while (index < capacity) {
+            if (slots[index].used && slots[index].generation != generation) {
+                erase_at(index);
+                removed++;
+                continue;  // in locul ei poate sa fi urcat alta intrare - o verificam si pe ea
+            }
+            index++;
+        }
+
+        return removed;
+    }
+
+    size_t size() const {
+        return count;
+    }
+};
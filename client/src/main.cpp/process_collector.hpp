@@ -1,5 +1,14 @@
 ﻿#pragma once
+
+#ifndef _WIN32
+// pe Linux colectorul citeste /proc, cu aceeasi interfata
+#include "process_collector_linux.hpp"
+#else
+
 #include "log_types.hpp"
+#include "client_config.hpp"
+#include "pid_table.hpp"
+#include "worker_pool.hpp"
 #include <windows.h>
 #include <psapi.h>
 #include <tlhelp32.h>
@@ -8,9 +17,10 @@
 #include <string>
 #include <vector>
 #include <sstream>
-#include <map>
-#include <set>
 #include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <thread>
 
 #pragma comment(lib, "pdh.lib")
 #pragma comment(lib, "psapi.lib")
@@ -90,38 +100,39 @@ private:
         return strTo;
     }
 
-    struct CPUTimes {
+    // ce tinem minte despre un proces intre cicluri (vezi pid_table.hpp): utilizatorul se
+    // rezolva o singura data pe proces, iar timpii CPU sunt cei de la masuratoarea anterioara
+    struct ProcessMetadata {
+        std::string user;
         ULONGLONG kernelTime;
         ULONGLONG userTime;
         ULONGLONG timestamp;
     };
 
-    static std::map<DWORD, CPUTimes> previousCPUTimes;
-
-    static double calculate_cpu_percent(DWORD pid, HANDLE hProcess) {
-        FILETIME creationTime, exitTime, kernelTime, userTime;
-
-        if (!GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime)) {
-            return 0.0;
-        }
+    // procesele se citesc pe mai multe thread-uri (vezi worker_pool.hpp)
+    static PidTable<ProcessMetadata> metadata;
+    static std::mutex metadata_mutex;
 
-        ULONGLONG kernel = (static_cast<ULONGLONG>(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
-        ULONGLONG user = (static_cast<ULONGLONG>(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
-        ULONGLONG currentTime = GetTickCount64();
+    static WorkerPool& worker_pool() {
+        static WorkerPool pool(COLLECTOR_WORKER_THREADS, COLLECTOR_MIN_PROCESSES_PER_WORKER);
+        return pool;
+    }
 
-        auto it = previousCPUTimes.find(pid);
-        if (it == previousCPUTimes.end()) {
-            previousCPUTimes[pid] = { kernel, user, currentTime };
-            return 0.0;
-        }
+    static ULONGLONG filetime_to_ull(const FILETIME& time) {
+        return (static_cast<ULONGLONG>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    }
 
-        ULONGLONG kernelDiff = kernel - it->second.kernelTime;
-        ULONGLONG userDiff = user - it->second.userTime;
-        ULONGLONG timeDiff = currentTime - it->second.timestamp;
+    static double calculate_cpu_percent(ProcessMetadata& previous, bool first_sample,
+        ULONGLONG kernel, ULONGLONG user, ULONGLONG currentTime) {
+        ULONGLONG kernelDiff = kernel - previous.kernelTime;
+        ULONGLONG userDiff = user - previous.userTime;
+        ULONGLONG timeDiff = currentTime - previous.timestamp;
 
-        it->second = { kernel, user, currentTime };
+        previous.kernelTime = kernel;
+        previous.userTime = user;
+        previous.timestamp = currentTime;
 
-        if (timeDiff == 0) return 0.0;
+        if (first_sample || timeDiff == 0) return 0.0;
 
         double cpuPercent = ((kernelDiff + userDiff) / 10000.0) / timeDiff * 100.0;
 
@@ -130,6 +141,38 @@ private:
         return cpuPercent;
     }
 
+    // CPU% si utilizatorul unui proces deschis; utilizatorul (OpenProcessToken +
+    // LookupAccountSidA) il cautam doar prima data cand vedem procesul
+    static void read_process_metrics(DWORD pid, HANDLE hProcess, ProcessInfo& proc_info) {
+        FILETIME creationTime, exitTime, kernelTime, userTime;
+
+        if (!GetProcessTimes(hProcess, &creationTime, &exitTime, &kernelTime, &userTime)) {
+            proc_info.cpu_percent = 0.0;
+            proc_info.user = get_username_from_process(hProcess);
+            return;
+        }
+
+        ULONGLONG started = filetime_to_ull(creationTime);
+        bool created;
+        {
+            std::lock_guard<std::mutex> lock(metadata_mutex);
+            ProcessMetadata& known = metadata.touch(static_cast<int>(pid), started, created);
+            proc_info.cpu_percent = calculate_cpu_percent(known, created,
+                filetime_to_ull(kernelTime), filetime_to_ull(userTime), GetTickCount64());
+
+            if (!created) {
+                proc_info.user = known.user;
+                return;
+            }
+        }
+
+        // partea scumpa, in afara lacatului - o singura data pe proces
+        proc_info.user = get_username_from_process(hProcess);
+
+        std::lock_guard<std::mutex> lock(metadata_mutex);
+        metadata.touch(static_cast<int>(pid), started, created).user = proc_info.user;
+    }
+
     static bool has_visible_window(DWORD pid) {
         struct EnumData {
             DWORD pid;
@@ -192,74 +235,51 @@ private:
         return false;
     }
 
-public:
-    static std::vector<ProcessInfo> collect_app_processes() {
-        std::vector<ProcessInfo> app_processes;
-        std::time_t current_timestamp = std::time(nullptr);
-
-        HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
-        if (hSnapshot == INVALID_HANDLE_VALUE) {
-            throw std::runtime_error("Nu se poate crea snapshot procese");
-        }
+    // metricile unui proces (deschidere, memorie, timpi CPU, utilizator); false = nu-l pastram
+    static bool collect_process(const PROCESSENTRY32W& entry, bool apps_only,
+        std::time_t current_timestamp, ProcessInfo& proc_info) {
+        DWORD pid = entry.th32ProcessID;
 
-        PROCESSENTRY32W pe32;
-        pe32.dwSize = sizeof(PROCESSENTRY32W);
-
-        if (!Process32FirstW(hSnapshot, &pe32)) {
-            CloseHandle(hSnapshot);
-            throw std::runtime_error("Nu se poate obtine primul proces");
+        if (apps_only && (pid == 0 || pid == 4 || !has_visible_window(pid))) {
+            return false;
         }
 
-        do {
-            DWORD pid = pe32.th32ProcessID;
-
-            if (pid == 0 || pid == 4) {
-                continue;
-            }
-
-            if (!has_visible_window(pid)) {
-                continue;
-            }
-
-            ProcessInfo proc_info;
-            proc_info.pid = static_cast<int>(pid);
-            proc_info.name = wstring_to_string(pe32.szExeFile);
-            proc_info.timestamp = current_timestamp;
-
-            HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
-                FALSE, pid);
+        proc_info.pid = static_cast<int>(pid);
+        proc_info.name = wstring_to_string(entry.szExeFile);
+        proc_info.timestamp = current_timestamp;
 
-            if (hProcess != NULL) {
-                PROCESS_MEMORY_COUNTERS_EX pmc;
-                if (GetProcessMemoryInfo(hProcess,
-                    reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc))) {
-                    proc_info.memory_kb = pmc.WorkingSetSize / 1024;
-                }
+        HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
+            FALSE, pid);
 
-                proc_info.cpu_percent = calculate_cpu_percent(pid, hProcess);
-                proc_info.user = get_username_from_process(hProcess);
-                proc_info.status = ProcessStatus::RUNNING;
-
-                CloseHandle(hProcess);
-            }
-            else {
-                proc_info.memory_kb = 0;
-                proc_info.cpu_percent = 0.0;
-                proc_info.user = "SYSTEM";
-                proc_info.status = ProcessStatus::RUNNING;
+        if (hProcess != NULL) {
+            PROCESS_MEMORY_COUNTERS_EX pmc;
+            if (GetProcessMemoryInfo(hProcess,
+                reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc))) {
+                proc_info.memory_kb = pmc.WorkingSetSize / 1024;
             }
 
-            proc_info.log_level = proc_info.get_log_level();
-            app_processes.push_back(proc_info);
+            read_process_metrics(pid, hProcess, proc_info);
+            proc_info.status = ProcessStatus::RUNNING;
 
-        } while (Process32NextW(hSnapshot, &pe32));
+            CloseHandle(hProcess);
+        }
+        else {
+            proc_info.memory_kb = 0;
+            proc_info.cpu_percent = 0.0;
+            proc_info.user = "SYSTEM";
+            proc_info.status = ProcessStatus::RUNNING;
+        }
 
-        CloseHandle(hSnapshot);
-        return app_processes;
+        proc_info.log_level = proc_info.get_log_level();
+        return true;
     }
 
-    // functie de colectat procese
-    static std::vector<ProcessInfo> collect_processes() {
+    // lista de procese vine serial din snapshot-ul Toolhelp, metricile se citesc in paralel
+    // pe bucati (fiecare worker in vectorul lui), iar rezultatul pastreaza ordinea din snapshot
+    static std::vector<ProcessInfo> collect(bool apps_only) {
+        static std::vector<PROCESSENTRY32W> entries;
+        static std::vector<std::vector<ProcessInfo>> worker_processes;
+
         std::vector<ProcessInfo> processes;
         std::time_t current_timestamp = std::time(nullptr);
 
@@ -276,44 +296,43 @@ public:
             throw std::runtime_error("Nu se poate obtine primul proces");
         }
 
-        do {
-            ProcessInfo proc_info;
-            proc_info.pid = static_cast<int>(pe32.th32ProcessID);
-            proc_info.name = wstring_to_string(pe32.szExeFile);
-            proc_info.timestamp = current_timestamp;
-
-            HANDLE hProcess = OpenProcess(PROCESS_QUERY_INFORMATION | PROCESS_VM_READ,
-                FALSE, pe32.th32ProcessID);
-
-            if (hProcess != NULL) {
-                PROCESS_MEMORY_COUNTERS_EX pmc;
-                if (GetProcessMemoryInfo(hProcess,
-                    reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&pmc), sizeof(pmc))) {
-                    proc_info.memory_kb = pmc.WorkingSetSize / 1024;
-                }
-
-                proc_info.cpu_percent = calculate_cpu_percent(pe32.th32ProcessID, hProcess);
-                proc_info.user = get_username_from_process(hProcess);
-                proc_info.status = ProcessStatus::RUNNING;
-
-                CloseHandle(hProcess);
-            }
-            else {
-                proc_info.memory_kb = 0;
-                proc_info.cpu_percent = 0.0;
-                proc_info.user = "SYSTEM";
-                proc_info.status = ProcessStatus::RUNNING;
-            }
-
-            proc_info.log_level = proc_info.get_log_level();
-            processes.push_back(proc_info);
+        {
+            std::lock_guard<std::mutex> lock(metadata_mutex);
+            metadata.begin_cycle();
+        }
 
+        entries.clear();
+        do {
+            entries.push_back(pe32);
         } while (Process32NextW(hSnapshot, &pe32));
 
         CloseHandle(hSnapshot);
+
+        collect_parallel(worker_pool(), entries.size(), worker_processes, processes,
+            [&](size_t index, ProcessInfo& proc_info) {
+                return collect_process(entries[index], apps_only, current_timestamp, proc_info);
+            });
+
         return processes;
     }
 
+public:
+    static std::vector<ProcessInfo> collect_app_processes() {
+        return collect(true);
+    }
+
+    // functie de colectat procese
+    static std::vector<ProcessInfo> collect_processes() {
+        return collect(false);
+    }
+
+    // pe Windows nu avem evenimente de iesire - procesele terminate se vad la urmatorul ciclu
+    static std::vector<ProcessInfo> wait_for_exits(std::chrono::milliseconds timeout, bool apps_only) {
+        (void)apps_only;
+        std::this_thread::sleep_for(timeout);
+        return std::vector<ProcessInfo>();
+    }
+
     static ProcessSnapshot collect_snapshot() {
         ProcessSnapshot snapshot;
         snapshot.hostname = get_hostname();
@@ -322,22 +341,16 @@ public:
         return snapshot;
     }
 
+    // procesele care nu au aparut in ultimul ciclu ies din cache (fara sa refacem liste de
+    // PID-uri - fiecare intrare stie in ce ciclu a fost vazuta ultima oara)
     static void cleanup_cpu_cache(const std::vector<ProcessInfo>& current_processes) {
-        std::set<DWORD> current_pids;
-        for (const auto& proc : current_processes) {
-            current_pids.insert(static_cast<DWORD>(proc.pid));
-        }
-
-        auto it = previousCPUTimes.begin();
-        while (it != previousCPUTimes.end()) {
-            if (current_pids.find(it->first) == current_pids.end()) {
-                it = previousCPUTimes.erase(it);
-            }
-            else {
-                ++it;
-            }
-        }
+        (void)current_processes;
+        std::lock_guard<std::mutex> lock(metadata_mutex);
+        metadata.sweep();
     }
 };
 
-std::map<DWORD, ProcessCollector::CPUTimes> ProcessCollector::previousCPUTimes;
\ No newline at end of file
+PidTable<ProcessCollector::ProcessMetadata> ProcessCollector::metadata;
+std::mutex ProcessCollector::metadata_mutex;
+
+#endif
@@ -0,0 +1,563 @@
+﻿#pragma once
+#include "log_types.hpp"
+#include "client_config.hpp"
+#include "pid_table.hpp"
+#include "process_events_linux.hpp"
+#include "worker_pool.hpp"
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <charconv>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <chrono>
+#include <ctime>
+#include <cstring>
+#include <cstdlib>
+#include <stdexcept>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pwd.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// colectorul pentru Linux: aceeasi interfata ca cel de Windows, dar citeste /proc
+// - /proc e deschis o singura data; fisierele fiecarui proces se deschid relativ la el (openat)
+// - per proces citim doar stat (cu pread, intr-un buffer refolosit, fara iostream): are
+//   starea, timpii si RSS-ul (ca statm), iar proprietarul (UID-ul din status) il da fstat
+// - CPU% vine din diferenta de jiffies (utime + stime) intre doua cicluri
+// - cu proc connector (process_events_linux.hpp) tinem o tabela vie de PID-uri: fork/exec aduc
+//   procese noi, exit le scoate (si e anuntat imediat), iar ciclul reciteste doar stat-ul celor
+//   urmarite, fara readdir; din cand in cand (si dupa evenimente pierdute) rescanam tot /proc
+
+class ProcessCollector {
+public:
+    static std::string get_hostname() {
+        char hostname[256];
+        if (gethostname(hostname, sizeof(hostname)) == 0) {
+            hostname[sizeof(hostname) - 1] = '\0';
+            return std::string(hostname);
+        }
+        return "unknown";
+    }
+
+private:
+    // ce citim dintr-un /proc/[pid]/stat
+    struct StatFields {
+        char state;
+        unsigned long flags;
+        unsigned long long utime;
+        unsigned long long stime;
+        unsigned long long starttime;
+        long long rss_pages;
+    };
+
+    static const unsigned long PF_KTHREAD_FLAG = 0x00200000;  // thread al kernelului
+
+    // masuratoarea CPU anterioara, pe PID + starttime (vezi pid_table.hpp)
+    struct CPUTimes {
+        unsigned long long jiffies;     // utime + stime
+        std::chrono::steady_clock::time_point timestamp;
+    };
+
+    // procesele se citesc pe mai multe thread-uri - tabelele comune au lacatul lor
+    static PidTable<CPUTimes> previousCPUTimes;
+    static std::mutex cpu_mutex;
+    static std::unordered_map<uid_t, std::string> userNames;
+    static std::mutex users_mutex;
+
+    static WorkerPool& worker_pool() {
+        static WorkerPool pool(COLLECTOR_WORKER_THREADS, COLLECTOR_MIN_PROCESSES_PER_WORKER);
+        return pool;
+    }
+
+    // /proc, deschis o data pentru tot programul
+    static DIR* proc_dir() {
+        static DIR* dir = opendir("/proc");
+        if (dir == nullptr) {
+            throw std::runtime_error("Nu se poate deschide /proc");
+        }
+        return dir;
+    }
+
+    // citeste /proc/<pid>/stat in buffer (terminat cu '\0'); din fd-ul deschis aflam si
+    // proprietarul procesului (fisierele din /proc/<pid> sunt ale UID-ului lui)
+    static ssize_t read_stat(int proc_fd, const char* pid_text, char* buffer, size_t capacity,
+        uid_t& owner_uid, bool& has_owner) {
+        char path[32];
+        size_t pid_length = std::strlen(pid_text);
+        if (pid_length + sizeof("/stat") > sizeof(path)) {
+            return -1;
+        }
+
+        std::memcpy(path, pid_text, pid_length);
+        std::memcpy(path + pid_length, "/stat", sizeof("/stat"));
+
+        int fd = openat(proc_fd, path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return -1;
+        }
+
+        ssize_t length = pread(fd, buffer, capacity - 1, 0);
+        if (length >= 0) {
+            buffer[length] = '\0';
+        }
+
+        struct stat owner;
+        has_owner = fstat(fd, &owner) == 0;
+        owner_uid = has_owner ? owner.st_uid : 0;
+
+        close(fd);
+        return length;
+    }
+
+    // "pid (nume) S ppid ..." - numele poate contine spatii si paranteze, deci cautam ultima ')'
+    static bool parse_stat(char* buffer, std::string& name, StatFields& fields) {
+        char* open_paren = std::strchr(buffer, '(');
+        char* close_paren = std::strrchr(buffer, ')');
+        if (open_paren == nullptr || close_paren == nullptr || close_paren < open_paren) {
+            return false;
+        }
+
+        name.assign(open_paren + 1, close_paren - open_paren - 1);
+
+        // campurile de dupa nume, numarate de la 3 (state) ca in man proc
+        char* cursor = close_paren + 1;
+        int field = 2;
+        while (*cursor != '\0' && field < 24) {
+            while (*cursor == ' ') cursor++;
+            field++;
+
+            switch (field) {
+            case 3:  fields.state = *cursor; break;
+            case 9:  fields.flags = std::strtoul(cursor, nullptr, 10); break;
+            case 14: fields.utime = std::strtoull(cursor, nullptr, 10); break;
+            case 15: fields.stime = std::strtoull(cursor, nullptr, 10); break;
+            case 22: fields.starttime = std::strtoull(cursor, nullptr, 10); break;
+            case 24: fields.rss_pages = std::strtoll(cursor, nullptr, 10); break;
+            default: break;
+            }
+
+            while (*cursor != ' ' && *cursor != '\0') cursor++;
+        }
+
+        return field >= 24;
+    }
+
+    static ProcessStatus status_from_state(char state) {
+        switch (state) {
+        case 'R':
+            return ProcessStatus::RUNNING;
+        case 'T':
+        case 't':
+            return ProcessStatus::STOPPED;
+        case 'Z':
+        case 'X':
+            return ProcessStatus::ZOMBIE;
+        default:
+            return ProcessStatus::SLEEPING;  // S, D, I, W...
+        }
+    }
+
+    static std::string get_username(uid_t uid) {
+        {
+            std::lock_guard<std::mutex> lock(users_mutex);
+            auto it = userNames.find(uid);
+            if (it != userNames.end()) {
+                return it->second;
+            }
+        }
+
+        char buffer[1024];
+        struct passwd pwd;
+        struct passwd* result = nullptr;
+        std::string name = (getpwuid_r(uid, &pwd, buffer, sizeof(buffer), &result) == 0 && result != nullptr)
+            ? std::string(result->pw_name) : std::to_string(uid);
+
+        std::lock_guard<std::mutex> lock(users_mutex);
+        userNames.emplace(uid, name);
+        return name;
+    }
+
+    static double calculate_cpu_percent(int pid, const StatFields& fields,
+        std::chrono::steady_clock::time_point now) {
+        static const double ticks_per_second = static_cast<double>(sysconf(_SC_CLK_TCK));
+        unsigned long long jiffies = fields.utime + fields.stime;
+
+        std::lock_guard<std::mutex> lock(cpu_mutex);
+        bool created;
+        CPUTimes& previous = previousCPUTimes.touch(pid, fields.starttime, created);
+        if (created) {
+            previous = { jiffies, now };
+            return 0.0;
+        }
+
+        unsigned long long jiffies_diff = jiffies - previous.jiffies;
+        double seconds = std::chrono::duration<double>(now - previous.timestamp).count();
+
+        previous = { jiffies, now };
+
+        if (seconds <= 0.0) return 0.0;
+
+        double cpuPercent = (jiffies_diff / ticks_per_second) / seconds * 100.0;
+
+        if (cpuPercent > 100.0) cpuPercent = 100.0;
+
+        return cpuPercent;
+    }
+
+    // un proces urmarit intre cicluri (doar cand vin evenimente de la kernel)
+    struct TrackedProcess {
+        ProcessInfo info;
+        unsigned long long starttime;
+        bool app;
+    };
+
+    struct ExitedProcess {
+        ProcessInfo info;
+        bool app;
+    };
+
+    static std::unordered_map<int, TrackedProcess> tracked;     // PID -> ultima citire
+    static std::unordered_map<int, ProcessEvent> fresh;         // PID-uri noi, necitite inca
+    static std::vector<ExitedProcess> exited;                   // iesiri neanuntate inca
+    static int cycles_since_resync;
+
+    static bool is_app(const StatFields& fields, bool has_owner, uid_t uid) {
+        return (fields.flags & PF_KTHREAD_FLAG) == 0 && has_owner &&
+            uid >= LINUX_MIN_APP_UID && uid != 65534;
+    }
+
+    // monitorul de evenimente, pornit la prima folosire; nullptr = scanam tot /proc
+    static ProcessEventMonitor* event_monitor() {
+        static ProcessEventMonitor monitor;
+        static bool started = false;
+
+        if (!started) {
+            started = true;
+            if (!monitor.start()) {
+                std::cerr << "  [collector] Proc connector indisponibil (lipsesc drepturile?) - "
+                    << "scanam tot /proc la fiecare ciclu" << std::endl;
+            }
+        }
+        return monitor.active() ? &monitor : nullptr;
+    }
+
+    // citeste stat-ul unui proces in entry; full = si numele, proprietarul si tipul (la cele
+    // deja urmarite se schimba doar la exec/comm, care vin ca evenimente)
+    static bool read_process(int proc_fd, const char* pid_text, bool full, TrackedProcess& entry,
+        std::chrono::steady_clock::time_point now, std::time_t timestamp) {
+        static const long page_kb = sysconf(_SC_PAGESIZE) / 1024;
+        thread_local char buffer[4096];
+        thread_local std::string name;
+
+        uid_t owner_uid;
+        bool has_owner;
+        StatFields fields = {};
+        if (read_stat(proc_fd, pid_text, buffer, sizeof(buffer), owner_uid, has_owner) <= 0) {
+            return false;  // procesul a disparut intre timp
+        }
+
+        if (!parse_stat(buffer, name, fields)) {
+            return false;
+        }
+
+        // alt starttime = PID refolosit fara sa fi vazut evenimentele - il luam de la capat
+        if (full || fields.starttime != entry.starttime) {
+            entry.info.pid = std::atoi(pid_text);
+            entry.info.name = name;
+            entry.info.user = has_owner ? get_username(owner_uid) : "root";
+            entry.starttime = fields.starttime;
+            entry.app = is_app(fields, has_owner, owner_uid);
+        }
+
+        entry.info.timestamp = timestamp;
+        entry.info.status = status_from_state(fields.state);
+        entry.info.cpu_percent = calculate_cpu_percent(entry.info.pid, fields, now);
+        entry.info.memory_kb = fields.rss_pages * page_kb;
+        entry.info.log_level = entry.info.get_log_level();
+        return true;
+    }
+
+    static void format_pid(char (&pid_text)[16], int pid) {
+        *std::to_chars(pid_text, pid_text + sizeof(pid_text) - 1, pid).ptr = '\0';
+    }
+
+    // o trecere prin /proc; apps_only = doar procesele utilizatorilor (fara kernel/servicii);
+    // track = refacem si tabela de procese urmarite. Lista de PID-uri vine serial din readdir,
+    // citirile se fac in paralel pe bucati (vezi worker_pool.hpp), in ordinea din /proc
+    static std::vector<ProcessInfo> scan(bool apps_only, bool track) {
+        static std::vector<int> pids;
+        static std::vector<TrackedProcess> entries;
+        static std::vector<std::vector<TrackedProcess>> worker_entries;
+
+        std::vector<ProcessInfo> processes;
+        std::time_t current_timestamp = std::time(nullptr);
+        auto now = std::chrono::steady_clock::now();
+
+        DIR* dir = proc_dir();
+        int proc_fd = dirfd(dir);
+        rewinddir(dir);
+
+        pids.clear();
+        struct dirent* entry_name;
+        while ((entry_name = readdir(dir)) != nullptr) {
+            if (entry_name->d_name[0] >= '1' && entry_name->d_name[0] <= '9') {
+                pids.push_back(std::atoi(entry_name->d_name));  // fara ".", "self", "sys"...
+            }
+        }
+
+        entries.clear();
+        collect_parallel(worker_pool(), pids.size(), worker_entries, entries,
+            [&](size_t index, TrackedProcess& entry) {
+                char pid_text[16];
+                format_pid(pid_text, pids[index]);
+                return read_process(proc_fd, pid_text, true, entry, now, current_timestamp);
+            });
+
+        if (track) {
+            tracked.clear();
+            fresh.clear();
+        }
+
+        processes.reserve(entries.size());
+        for (auto& entry : entries) {
+            if (!apps_only || entry.app) {
+                processes.push_back(entry.info);
+            }
+            if (track) {
+                int pid = entry.info.pid;
+                tracked[pid] = std::move(entry);
+            }
+        }
+
+        return processes;
+    }
+
+    // ciclu cu evenimente: recitim doar procesele urmarite (si doar pe cele cerute) plus cele
+    // aparute intre timp - fara readdir si fara sa rezolvam din nou nume si utilizatori
+    static std::vector<ProcessInfo> refresh(bool apps_only) {
+        static std::vector<TrackedProcess*> targets;
+        static std::vector<char> alive;
+
+        std::vector<ProcessInfo> processes;
+        std::time_t current_timestamp = std::time(nullptr);
+        auto now = std::chrono::steady_clock::now();
+        int proc_fd = dirfd(proc_dir());
+        char pid_text[16];
+
+        targets.clear();
+        for (auto& item : tracked) {
+            if (!apps_only || item.second.app) {
+                targets.push_back(&item.second);
+            }
+        }
+
+        // fiecare worker actualizeaza pe loc intrarile din bucata lui
+        alive.assign(targets.size(), 0);
+        worker_pool().run(targets.size(), [&](size_t, size_t begin, size_t end) {
+            char worker_pid_text[16];
+            for (size_t index = begin; index < end; ++index) {
+                format_pid(worker_pid_text, targets[index]->info.pid);
+                alive[index] = read_process(proc_fd, worker_pid_text, false, *targets[index],
+                    now, current_timestamp) ? 1 : 0;
+            }
+        });
+
+        for (size_t index = 0; index < targets.size(); ++index) {
+            if (!alive[index]) {
+                tracked.erase(targets[index]->info.pid);  // a disparut, iar EXIT-ul s-a pierdut
+            }
+        }
+
+        // procesele noi; cele deja disparute raman in 'fresh' pana vine EXIT-ul lor
+        for (auto it = fresh.begin(); it != fresh.end();) {
+            TrackedProcess entry;
+            format_pid(pid_text, it->first);
+            if (!read_process(proc_fd, pid_text, true, entry, now, current_timestamp)) {
+                ++it;
+                continue;
+            }
+            tracked[it->first] = std::move(entry);
+            it = fresh.erase(it);
+        }
+
+        processes.reserve(tracked.size());
+        for (const auto& item : tracked) {
+            if (!apps_only || item.second.app) {
+                processes.push_back(item.second.info);
+            }
+        }
+
+        std::sort(processes.begin(), processes.end(),
+            [](const ProcessInfo& a, const ProcessInfo& b) { return a.pid < b.pid; });
+        return processes;
+    }
+
+    static void process_exited(ProcessInfo info, bool app, bool crashed) {
+        info.status = crashed ? ProcessStatus::CRASHED : ProcessStatus::STOPPED;
+        info.log_level = crashed ? LogLevel::ERR : info.get_log_level();
+        info.timestamp = std::time(nullptr);
+        exited.push_back(ExitedProcess{ std::move(info), app });
+    }
+
+    // aplica evenimentele pe tabela de procese urmarite
+    static void apply_events(std::vector<ProcessEvent>& events) {
+        for (auto& event : events) {
+            auto found = tracked.find(event.pid);
+
+            switch (event.type) {
+            case ProcessEvent::Type::FORK:
+                if (found != tracked.end()) {
+                    tracked.erase(found);  // EXIT-ul vechiului proces s-a pierdut
+                }
+                fresh.insert_or_assign(event.pid, std::move(event));
+                break;
+
+            case ProcessEvent::Type::EXEC:
+            case ProcessEvent::Type::COMM:
+                if (found != tracked.end()) {
+                    if (!event.name.empty()) {
+                        found->second.info.name = event.name;
+                    }
+                    if (event.has_owner) {
+                        found->second.info.user = get_username(event.uid);
+                        found->second.app = event.uid >= LINUX_MIN_APP_UID && event.uid != 65534;
+                    }
+                }
+                else {
+                    auto pending = fresh.find(event.pid);
+                    if (pending == fresh.end() || event.type == ProcessEvent::Type::EXEC) {
+                        fresh.insert_or_assign(event.pid, std::move(event));
+                    }
+                    else if (!event.name.empty()) {
+                        pending->second.name = event.name;
+                    }
+                }
+                break;
+
+            case ProcessEvent::Type::EXIT:
+                if (found != tracked.end()) {
+                    process_exited(std::move(found->second.info), found->second.app, event.crashed);
+                    tracked.erase(found);
+                }
+                else {
+                    // proces scurt: a pornit si s-a terminat intre doua cicluri (daca a murit
+                    // inainte sa-i citim numele la exec nu avem ce anunta)
+                    auto pending = fresh.find(event.pid);
+                    if (pending != fresh.end()) {
+                        if (!pending->second.name.empty()) {
+                            ProcessInfo info;
+                            info.pid = event.pid;
+                            info.name = pending->second.name;
+                            info.user = pending->second.has_owner ? get_username(pending->second.uid) : "root";
+                            bool app = pending->second.has_owner &&
+                                pending->second.uid >= LINUX_MIN_APP_UID && pending->second.uid != 65534;
+                            process_exited(std::move(info), app, event.crashed);
+                        }
+                        fresh.erase(pending);
+                    }
+                }
+                break;
+            }
+        }
+        events.clear();
+    }
+
+    static std::vector<ProcessInfo> collect(bool apps_only) {
+        {
+            std::lock_guard<std::mutex> lock(cpu_mutex);
+            previousCPUTimes.begin_cycle();
+        }
+
+        ProcessEventMonitor* monitor = event_monitor();
+        if (monitor == nullptr) {
+            return scan(apps_only, false);
+        }
+
+        std::vector<ProcessEvent> events;
+        monitor->wait(events, std::chrono::milliseconds(0));
+        apply_events(events);
+
+        // pana la primul eveniment nu stim daca abonamentul chiar merge (ex. container fara
+        // drepturi pe namespace-ul initial) - pana atunci scanam ca inainte
+        if (monitor->take_lost_events() || monitor->events_received() == 0 ||
+            ++cycles_since_resync >= PROC_EVENTS_RESYNC_CYCLES) {
+            cycles_since_resync = 0;
+            return scan(apps_only, true);
+        }
+
+        return refresh(apps_only);
+    }
+
+public:
+    static std::vector<ProcessInfo> collect_app_processes() {
+        return collect(true);
+    }
+
+    // functie de colectat procese
+    static std::vector<ProcessInfo> collect_processes() {
+        return collect(false);
+    }
+
+    // asteapta cel mult 'timeout' procese terminate si le intoarce imediat (status STOPPED,
+    // sau CRASHED daca le-a omorat un semnal de eroare); fara evenimente doar doarme
+    static std::vector<ProcessInfo> wait_for_exits(std::chrono::milliseconds timeout, bool apps_only) {
+        std::vector<ProcessInfo> result;
+        ProcessEventMonitor* monitor = event_monitor();
+        if (monitor == nullptr) {
+            std::this_thread::sleep_for(timeout);
+            return result;
+        }
+
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        std::vector<ProcessEvent> events;
+
+        while (true) {
+            for (auto& gone : exited) {
+                if (!apps_only || gone.app) {
+                    result.push_back(std::move(gone.info));
+                }
+            }
+            exited.clear();
+
+            auto now = std::chrono::steady_clock::now();
+            if (!result.empty() || now >= deadline) {
+                break;
+            }
+
+            monitor->wait(events, std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now) +
+                std::chrono::milliseconds(1));
+            apply_events(events);
+        }
+
+        return result;
+    }
+
+    static ProcessSnapshot collect_snapshot() {
+        ProcessSnapshot snapshot;
+        snapshot.hostname = get_hostname();
+        snapshot.timestamp = std::time(nullptr);
+        snapshot.processes = collect_processes();
+        return snapshot;
+    }
+
+    // procesele care nu au aparut in ultimul ciclu ies din cache (fara sa refacem liste de
+    // PID-uri - fiecare intrare stie in ce ciclu a fost vazuta ultima oara)
+    static void cleanup_cpu_cache(const std::vector<ProcessInfo>& current_processes) {
+        (void)current_processes;
+        std::lock_guard<std::mutex> lock(cpu_mutex);
+        previousCPUTimes.sweep();
+    }
+};
+
+PidTable<ProcessCollector::CPUTimes> ProcessCollector::previousCPUTimes;
+std::mutex ProcessCollector::cpu_mutex;
+std::unordered_map<uid_t, std::string> ProcessCollector::userNames;
+std::mutex ProcessCollector::users_mutex;
+std::unordered_map<int, ProcessCollector::TrackedProcess> ProcessCollector::tracked;
+std::unordered_map<int, ProcessEvent> ProcessCollector::fresh;
+std::vector<ProcessCollector::ExitedProcess> ProcessCollector::exited;
+int ProcessCollector::cycles_since_resync = 0;
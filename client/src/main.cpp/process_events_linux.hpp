@@ -0,0 +1,289 @@
+﻿#pragma once
+#include "client_config.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <linux/cn_proc.h>
+#include <linux/connector.h>
+#include <linux/netlink.h>
+
+// un eveniment de la kernel despre un proces (thread-urile sunt ignorate)
+struct ProcessEvent {
+    enum class Type { FORK, EXEC, COMM, EXIT };
+
+    Type type;
+    int pid;
+    bool crashed;           // EXIT: omorat de un semnal de eroare (SIGSEGV, SIGABRT...)
+    bool has_owner;         // EXEC: uid e valid
+    uid_t uid;
+    std::string name;       // EXEC/COMM: citit imediat - procesele scurte dispar pana la ciclu
+
+    ProcessEvent(Type event_type, int event_pid)
+        : type(event_type), pid(event_pid), crashed(false), has_owner(false), uid(0) {}
+};
+
+// abonament la proc connector (netlink): kernelul ne anunta fork/exec/exit pe loc, in loc
+// sa le descoperim la urmatoarea scanare. Cere CAP_NET_ADMIN in namespace-ul initial -
+// fara el start() intoarce false si colectorul ramane pe scanarea completa
+class ProcessEventMonitor {
+private:
+    int sock;
+    std::thread reader;
+    std::atomic<bool> stopping;
+
+    std::mutex mutex;
+    std::condition_variable exit_ready;     // trezeste doar la EXIT (fork-urile pot astepta ciclul)
+    std::vector<ProcessEvent> pending;
+
+    std::atomic<bool> lost_events;          // kernelul sau noi am aruncat evenimente
+    std::atomic<unsigned long long> received;
+
+    bool send_control(proc_cn_mcast_op op) {
+        alignas(nlmsghdr) char buffer[NLMSG_SPACE(sizeof(cn_msg) + sizeof(proc_cn_mcast_op))];
+        std::memset(buffer, 0, sizeof(buffer));
+
+        nlmsghdr* header = reinterpret_cast<nlmsghdr*>(buffer);
+        header->nlmsg_len = NLMSG_LENGTH(sizeof(cn_msg) + sizeof(proc_cn_mcast_op));
+        header->nlmsg_type = NLMSG_DONE;
+        header->nlmsg_pid = static_cast<__u32>(getpid());
+
+        cn_msg* message = reinterpret_cast<cn_msg*>(NLMSG_DATA(header));
+        message->id.idx = CN_IDX_PROC;
+        message->id.val = CN_VAL_PROC;
+        message->len = sizeof(proc_cn_mcast_op);
+        std::memcpy(message->data, &op, sizeof(op));
+
+        return send(sock, buffer, header->nlmsg_len, 0) == static_cast<ssize_t>(header->nlmsg_len);
+    }
+
+    static bool crash_signal(int signal_number) {
+        switch (signal_number) {
+        case SIGSEGV: case SIGBUS: case SIGILL: case SIGFPE: case SIGABRT: case SIGSYS: case SIGTRAP:
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    // numele (comm) si proprietarul, cat timp procesul inca exista
+    static void read_identity(ProcessEvent& event) {
+        char path[32];
+        std::snprintf(path, sizeof(path), "/proc/%d/comm", event.pid);
+
+        int fd = open(path, O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            return;
+        }
+
+        char name[64];
+        ssize_t length = pread(fd, name, sizeof(name) - 1, 0);
+        if (length > 0) {
+            if (name[length - 1] == '\n') length--;
+            event.name.assign(name, static_cast<size_t>(length));
+        }
+
+        struct stat owner;
+        if (fstat(fd, &owner) == 0) {
+            event.has_owner = true;
+            event.uid = owner.st_uid;
+        }
+        close(fd);
+    }
+
+    void handle(const proc_event& kernel_event, std::vector<ProcessEvent>& batch, bool& has_exit) {
+        switch (kernel_event.what) {
+        case proc_event::PROC_EVENT_FORK:
+            if (kernel_event.event_data.fork.child_pid == kernel_event.event_data.fork.child_tgid) {
+                batch.emplace_back(ProcessEvent::Type::FORK, kernel_event.event_data.fork.child_pid);
+            }
+            break;
+
+        case proc_event::PROC_EVENT_EXEC:
+            batch.emplace_back(ProcessEvent::Type::EXEC, kernel_event.event_data.exec.process_tgid);
+            read_identity(batch.back());
+            break;
+
+        case proc_event::PROC_EVENT_COMM:
+            if (kernel_event.event_data.comm.process_pid == kernel_event.event_data.comm.process_tgid) {
+                batch.emplace_back(ProcessEvent::Type::COMM, kernel_event.event_data.comm.process_pid);
+                batch.back().name.assign(kernel_event.event_data.comm.comm,
+                    strnlen(kernel_event.event_data.comm.comm, sizeof(kernel_event.event_data.comm.comm)));
+            }
+            break;
+
+        case proc_event::PROC_EVENT_EXIT:
+            if (kernel_event.event_data.exit.process_pid == kernel_event.event_data.exit.process_tgid) {
+                batch.emplace_back(ProcessEvent::Type::EXIT, kernel_event.event_data.exit.process_pid);
+                batch.back().crashed = crash_signal(kernel_event.event_data.exit.exit_code & 0x7f);
+                has_exit = true;
+            }
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    void run() {
+        alignas(nlmsghdr) char buffer[16384];
+        std::vector<ProcessEvent> batch;
+
+        while (!stopping.load()) {
+            pollfd descriptor = { sock, POLLIN, 0 };
+            if (poll(&descriptor, 1, 200) <= 0) {
+                continue;
+            }
+
+            ssize_t length = recv(sock, buffer, sizeof(buffer), 0);
+            if (length < 0) {
+                // ENOBUFS = n-am citit destul de repede si kernelul a aruncat evenimente
+                if (errno == ENOBUFS) {
+                    lost_events.store(true);
+                }
+                continue;
+            }
+
+            batch.clear();
+            bool has_exit = false;
+            int remaining = static_cast<int>(length);
+
+            for (nlmsghdr* header = reinterpret_cast<nlmsghdr*>(buffer); NLMSG_OK(header, remaining);
+                header = NLMSG_NEXT(header, remaining)) {
+                if (header->nlmsg_type == NLMSG_ERROR || header->nlmsg_type == NLMSG_NOOP) {
+                    continue;
+                }
+
+                if (header->nlmsg_len < NLMSG_LENGTH(sizeof(cn_msg))) {
+                    continue;
+                }
+
+                const cn_msg* message = reinterpret_cast<const cn_msg*>(NLMSG_DATA(header));
+                if (message->id.idx != CN_IDX_PROC || message->id.val != CN_VAL_PROC) {
+                    continue;
+                }
+
+                // evenimentul trebuie sa fie intreg in mesaj; il copiem pentru ca in buffer vine
+                // imediat dupa cn_msg, nealiniat pentru campurile lui de 64 de biti
+                size_t available = header->nlmsg_len - NLMSG_LENGTH(sizeof(cn_msg));
+                if (message->len < sizeof(proc_event) || message->len > available) {
+                    continue;
+                }
+
+                proc_event kernel_event;
+                std::memcpy(&kernel_event, message->data, sizeof(kernel_event));
+                handle(kernel_event, batch, has_exit);
+            }
+
+            if (batch.empty()) {
+                continue;
+            }
+            received.fetch_add(batch.size(), std::memory_order_relaxed);
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                // nimeni nu mai goleste coada - mai bine o rescanare decat memorie fara limita
+                if (pending.size() + batch.size() > PROC_EVENTS_MAX_PENDING) {
+                    pending.clear();
+                    lost_events.store(true);
+                }
+                for (auto& event : batch) {
+                    pending.push_back(std::move(event));
+                }
+            }
+
+            if (has_exit) {
+                exit_ready.notify_one();
+            }
+        }
+    }
+
+public:
+    ProcessEventMonitor() : sock(-1), stopping(false), lost_events(false), received(0) {}
+
+    ~ProcessEventMonitor() {
+        stop();
+    }
+
+    ProcessEventMonitor(const ProcessEventMonitor&) = delete;
+    ProcessEventMonitor& operator=(const ProcessEventMonitor&) = delete;
+
+    // false = fara drepturi sau kernel fara proc connector
+    bool start() {
+        sock = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_CONNECTOR);
+        if (sock < 0) {
+            return false;
+        }
+
+        sockaddr_nl address;
+        std::memset(&address, 0, sizeof(address));
+        address.nl_family = AF_NETLINK;
+        address.nl_groups = CN_IDX_PROC;
+
+        if (bind(sock, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+            !send_control(PROC_CN_MCAST_LISTEN)) {
+            close(sock);
+            sock = -1;
+            return false;
+        }
+
+        reader = std::thread(&ProcessEventMonitor::run, this);
+        return true;
+    }
+
+    void stop() {
+        stopping.store(true);
+        if (reader.joinable()) {
+            reader.join();
+        }
+        if (sock >= 0) {
+            send_control(PROC_CN_MCAST_IGNORE);
+            close(sock);
+            sock = -1;
+        }
+    }
+
+    bool active() const {
+        return sock >= 0;
+    }
+
+    // ia evenimentele adunate; daca nu e niciun EXIT asteapta unul cel mult 'timeout'
+    void wait(std::vector<ProcessEvent>& events, std::chrono::milliseconds timeout) {
+        std::unique_lock<std::mutex> lock(mutex);
+
+        auto has_exit = [this]() {
+            for (const auto& event : pending) {
+                if (event.type == ProcessEvent::Type::EXIT) return true;
+            }
+            return stopping.load();
+        };
+
+        if (timeout.count() > 0) {
+            exit_ready.wait_for(lock, timeout, has_exit);
+        }
+
+        events.swap(pending);
+        pending.clear();
+    }
+
+    // true o singura data dupa ce s-au pierdut evenimente - tabela trebuie refacuta din /proc
+    bool take_lost_events() {
+        return lost_events.exchange(false);
+    }
+
+    unsigned long long events_received() const {
+        return received.load(std::memory_order_relaxed);
+    }
+};
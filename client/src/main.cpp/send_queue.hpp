@@ -0,0 +1,95 @@
+﻿#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// coada fara lacate, cu loc fix (putere a lui 2), pentru mai multi producatori si
+// consumatori (algoritmul lui D. Vyukov): fiecare loc are un numar de secventa care spune
+// daca e liber pentru scriere sau plin pentru citire, deci un push/pop e un singur CAS
+template <typename T>
+class BoundedQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+
+    // pe linii de cache separate - producatorul si consumatorul nu se incurca
+    alignas(64) std::atomic<size_t> enqueue_pos;
+    alignas(64) std::atomic<size_t> dequeue_pos;
+
+public:
+    explicit BoundedQueue(size_t capacity)
+        : cells(new Cell[capacity]), mask(capacity - 1), enqueue_pos(0), dequeue_pos(0) {
+        for (size_t i = 0; i < capacity; ++i) {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    BoundedQueue(const BoundedQueue&) = delete;
+    BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+    // false daca e plina (item ramane neatins)
+    bool try_push(T& item) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(item);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // false daca e goala
+    bool try_pop(T& item) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t sequence = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    item = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) {
+                return false;
+            }
+            else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // cate elemente asteapta (aproximativ - se poate schimba chiar atunci)
+    size_t size_approx() const {
+        size_t pushed = enqueue_pos.load(std::memory_order_relaxed);
+        size_t popped = dequeue_pos.load(std::memory_order_relaxed);
+        return pushed > popped ? pushed - popped : 0;
+    }
+
+    size_t capacity() const { return mask + 1; }
+};
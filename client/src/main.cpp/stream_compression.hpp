@@ -0,0 +1,155 @@
+﻿#pragma once
+#include "client_config.hpp"
+#include <cstring>
+#include <string>
+#include <zlib.h>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <ctime>
+#endif
+
+#ifdef _MSC_VER
+#pragma comment(lib, "zlib.lib")
+#endif
+
+// compresia fluxului spre server (negociata la HELLO) - vezi Server/include/compresie_flux.h
+#define COMPRESSION_NAME "deflate"
+
+// dictionarul comun - EXACT aceiasi octeti ca g_dictionar_compresie de pe server
+static const char COMPRESSION_DICTIONARY[] =
+    "{\"type\":\"GOODBYE\",\"client_name\":\"\"}"
+    "\"connection_status\":\"connected\""
+    "{\"pid\":,\"name\":\".exe\",\"user\":\"\",\"cpu_percent\":0,\"memory_kb\":,"
+    "\"status\":\"STOPPED\",\"log_level\":\"ERROR\"},"
+    "{\"pid\":,\"name\":\"\",\"user\":\"\",\"cpu_percent\":0,\"memory_kb\":,"
+    "\"status\":\"SLEEPING\",\"log_level\":\"WARN\"},"
+    "{\"hostname\":\"\",\"timestamp\":,\"processes\":["
+    "{\"hostname\":\"\",\"timestamp\":,\"pid\":,\"name\":\"\",\"user\":\"\","
+    "\"cpu_percent\":0,\"memory_kb\":,\"status\":\"RUNNING\",\"log_level\":\"INFO\"}";
+
+// timpul de procesor al thread-ului curent (nu cel de pe ceas), in nanosecunde
+inline unsigned long long thread_cpu_ns() {
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &created, &exited, &kernel, &user)) {
+        return 0;
+    }
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) * 100ULL;  // unitati de 100 ns
+#else
+    timespec now;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now) != 0) {
+        return 0;
+    }
+    return static_cast<unsigned long long>(now.tv_sec) * 1000000000ULL +
+        static_cast<unsigned long long>(now.tv_nsec);
+#endif
+}
+
+// serverul accepta compresia daca raspunsul de bun venit spune "compression":"deflate"
+inline bool server_accepts_compression(const std::string& welcome) {
+    return welcome.find("\"compression\":\"" COMPRESSION_NAME "\"") != std::string::npos;
+}
+
+// un singur flux deflate pe toata conexiunea: mesajele care seamana cu cele
+// trimise inainte (aceleasi procese la fiecare ciclu) costa doar cativa octeti
+class StreamCompressor {
+private:
+    z_stream stream;
+    bool initialized;
+    unsigned long long raw_bytes;
+    unsigned long long wire_bytes;
+    unsigned long long cpu_ns;      // cat procesor a consumat deflate() pe conexiunea curenta
+
+public:
+    StreamCompressor() : initialized(false), raw_bytes(0), wire_bytes(0), cpu_ns(0) {
+        std::memset(&stream, 0, sizeof(stream));
+    }
+
+    ~StreamCompressor() {
+        reset();
+    }
+
+    StreamCompressor(const StreamCompressor&) = delete;
+    StreamCompressor& operator=(const StreamCompressor&) = delete;
+
+    // porneste un flux nou (la fiecare conexiune)
+    bool start() {
+        reset();
+
+        if (deflateInit(&stream, COMPRESSION_LEVEL) != Z_OK) {
+            return false;
+        }
+        if (deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(COMPRESSION_DICTIONARY),
+            sizeof(COMPRESSION_DICTIONARY) - 1) != Z_OK) {
+            deflateEnd(&stream);
+            return false;
+        }
+
+        initialized = true;
+        raw_bytes = 0;
+        wire_bytes = 0;
+        cpu_ns = 0;
+        return true;
+    }
+
+    void reset() {
+        if (initialized) {
+            deflateEnd(&stream);
+            std::memset(&stream, 0, sizeof(stream));
+            initialized = false;
+        }
+    }
+
+    bool active() const { return initialized; }
+
+    // comprima datele in buffer-ul 'out' (fara alocari) si da fiecare bucata lui sink;
+    // cu flush = true serverul poate decomprima tot ce s-a trimis pana aici
+    template <typename Sink>
+    bool compress(const char* data, size_t length, bool flush,
+        char* out, size_t out_capacity, Sink sink) {
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+        stream.avail_in = static_cast<uInt>(length);
+        raw_bytes += length;
+
+        do {
+            stream.next_out = reinterpret_cast<Bytef*>(out);
+            stream.avail_out = static_cast<uInt>(out_capacity);
+
+            // masuram doar deflate(), nu si trimiterea facuta de sink
+            unsigned long long start_ns = thread_cpu_ns();
+            int result = deflate(&stream, flush ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+            cpu_ns += thread_cpu_ns() - start_ns;
+            if (result == Z_STREAM_ERROR) {
+                return false;
+            }
+
+            size_t produced = out_capacity - stream.avail_out;
+            if (produced > 0 && !sink(out, produced)) {
+                return false;
+            }
+            wire_bytes += produced;
+        } while (stream.avail_out == 0);
+
+        return true;
+    }
+
+    // de cate ori s-au micsorat datele pe conexiunea curenta
+    double ratio() const {
+        return wire_bytes > 0 ? static_cast<double>(raw_bytes) / static_cast<double>(wire_bytes) : 0.0;
+    }
+
+    // milisecunde de procesor petrecute in deflate() pe conexiunea curenta
+    double cpu_ms() const {
+        return static_cast<double>(cpu_ns) / 1000000.0;
+    }
+};
@@ -0,0 +1,154 @@
+﻿#pragma once
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// thread-uri fixe pentru colectare: run() imparte [0, count) in bucati consecutive, cate una
+// pe worker (apelantul lucreaza si el, ca worker 0), si asteapta sa termine toate. Job-ul nu
+// are voie sa arunce exceptii (pe un thread din pool ar opri programul), iar run() se apeleaza
+// dintr-un singur thread (colectarea)
+class WorkerPool {
+private:
+    std::vector<std::thread> threads;
+    size_t min_items_per_worker;
+
+    std::mutex mutex;
+    std::condition_variable start_work;
+    std::condition_variable work_done;
+
+    std::function<void(size_t, size_t, size_t)> job;   // (worker, inceput, sfarsit)
+    size_t item_count;
+    size_t active_workers;      // cati worker-i primesc o bucata in runda curenta
+    size_t remaining;           // cati din thread-urile pool-ului mai lucreaza
+    unsigned long long round;
+    bool stopping;
+
+    std::pair<size_t, size_t> chunk(size_t worker) const {
+        return { item_count * worker / active_workers, item_count * (worker + 1) / active_workers };
+    }
+
+    void worker_loop(size_t worker) {
+        unsigned long long seen_round = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (true) {
+            start_work.wait(lock, [&]() { return stopping || round != seen_round; });
+            if (stopping) {
+                return;
+            }
+            seen_round = round;
+
+            // runda cu putine elemente - lucreaza doar primii worker-i
+            if (worker >= active_workers) {
+                continue;
+            }
+
+            std::pair<size_t, size_t> range = chunk(worker);
+            lock.unlock();
+            job(worker, range.first, range.second);
+            lock.lock();
+
+            if (--remaining == 0) {
+                work_done.notify_one();
+            }
+        }
+    }
+
+public:
+    // workers = cate bucati lucram deodata (inclusiv apelantul); 0 sau 1 = totul pe apelant
+    WorkerPool(size_t workers, size_t min_items)
+        : min_items_per_worker(std::max<size_t>(min_items, 1)), item_count(0), active_workers(0),
+        remaining(0), round(0), stopping(false) {
+        for (size_t worker = 1; worker < workers; ++worker) {
+            threads.emplace_back(&WorkerPool::worker_loop, this, worker);
+        }
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        start_work.notify_all();
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    size_t size() const {
+        return threads.size() + 1;
+    }
+
+    // job(worker, inceput, sfarsit) pentru fiecare bucata; intoarce dupa ce s-au terminat toate
+    void run(size_t count, const std::function<void(size_t, size_t, size_t)>& work) {
+        size_t workers = std::min(size(), std::max<size_t>(count / min_items_per_worker, 1));
+        if (workers <= 1) {
+            work(0, 0, count);
+            return;
+        }
+
+        std::pair<size_t, size_t> own_range;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = work;
+            item_count = count;
+            active_workers = workers;
+            remaining = workers - 1;
+            round++;
+            own_range = chunk(0);
+        }
+        start_work.notify_all();
+
+        work(0, own_range.first, own_range.second);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        work_done.wait(lock, [this]() { return remaining == 0; });
+        job = nullptr;
+    }
+};
+
+// aduna in paralel cate un rezultat pentru fiecare index: collect(index, rezultat) intoarce
+// true daca rezultatul se pastreaza. Fiecare worker scrie in vectorul lui (refolosit intre
+// apeluri, fara lacate), apoi vectorii se lipesc in ordinea worker-ilor - adica in ordinea
+// indicilor, la fel ca o colectare seriala
+template <typename Result, typename Collect>
+void collect_parallel(WorkerPool& pool, size_t count, std::vector<std::vector<Result>>& per_worker,
+    std::vector<Result>& results, Collect collect) {
+    per_worker.resize(pool.size());
+    for (auto& worker_results : per_worker) {
+        worker_results.clear();
+        worker_results.reserve(count / pool.size() + 1);
+    }
+
+    pool.run(count, [&](size_t worker, size_t begin, size_t end) {
+        std::vector<Result>& out = per_worker[worker];
+        Result result;
+        for (size_t index = begin; index < end; ++index) {
+            if (collect(index, result)) {
+                out.push_back(std::move(result));
+                result = Result();
+            }
+        }
+    });
+
+    size_t total = 0;
+    for (const auto& worker_results : per_worker) {
+        total += worker_results.size();
+    }
+
+    results.reserve(results.size() + total);
+    for (auto& worker_results : per_worker) {
+        std::move(worker_results.begin(), worker_results.end(), std::back_inserter(results));
+        worker_results.clear();
+    }
+}